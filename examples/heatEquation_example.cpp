@@ -80,9 +80,6 @@ int main(int argc, char *argv[])
     assembler.setTheta(theta);
     gsInfo<<assembler.options()<<"\n";
 
-    // A Conjugate Gradient linear solver with a diagonal (Jacobi) preconditionner
-    gsSparseSolver<>::CGDiagonal solver;
-
     // Generate system matrix and load vector
     gsInfo<<"Assembling mass and stiffness...\n";
     assembler.assemble();
@@ -110,14 +107,22 @@ int main(int argc, char *argv[])
         collection.saveTimeStep();
     }
 
+    // Time integrator, the system M + theta*Dt*K is factorized once
+    // (rhs is assumed constant wrt time)
+    gsTimeIntegrator<real_t> integrator(assembler.mass(),
+                                        assembler.stationaryMatrix(),
+                                        assembler.stationaryRhs());
+    integrator.options().setReal("Theta", theta);
+    integrator.setInitialValue(Sol);
+    integrator.setTimeStep(Dt);
+
     for ( int i = 1; i<=numSteps; ++i) // for all timesteps
     {
-        // Compute the system for the timestep i (rhs is assumed constant wrt time)
-        assembler.nextTimeStep(Sol, Dt);
         gsInfo<<"Solving timestep "<< i*Dt<<".\n";
 
-        // Solve for current timestep, overwrite previous solution
-        Sol = solver.compute( assembler.matrix() ).solve( assembler.rhs() );
+        // Solve for current timestep
+        integrator.step();
+        Sol = integrator.solution();
 
         // Obtain current solution as an isogeometric field
         //sol = assembler.constructSolution(Sol); // same as next line
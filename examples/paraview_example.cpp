@@ -129,6 +129,9 @@ int main(int argc, char* argv[])
     PVCollection.options().setString("subfolder", "");
     // Export in base64 binary format
     PVCollection.options().setSwitch("base64", false);
+    // Export in VTK appended raw binary format, optionally zlib-compressed
+    PVCollection.options().setSwitch("appended", false);
+    PVCollection.options().setSwitch("compress", false);
 
     // Create a new timestep (e.g for the initial state of the problem)
     // This initialises the appropriate files on disk
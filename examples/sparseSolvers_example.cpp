@@ -78,6 +78,12 @@ int main(int argc, char** argv)
     gsInfo << "Solve Ax = b with Eigen's CG diagonal preconditioner.\n";
     report( x, x0, succeeded );
 
+    gsSparseSolver<>::CGIncompleteCholesky solverCGIC;
+    solverCGIC.compute(Q);
+    x = solverCGIC.solve(b);
+    gsInfo << "Solve Ax = b with Eigen's CG incomplete Cholesky preconditioner.\n";
+    report( x, x0, succeeded );
+
     gsSparseSolver<>::BiCGSTABILUT solverBCGILU;
     solverBCGILU.compute(Q);
     x = solverBCGILU.solve(b);
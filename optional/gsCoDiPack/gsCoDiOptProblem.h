@@ -0,0 +1,115 @@
+/** @file gsCoDiOptProblem.h
+
+    @brief Optimization problem with exact gradients by algorithmic
+    differentiation (reverse mode) with CoDiPack
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCoDiPack/gsCoDiPack.h>
+#include <gsOptimizer/gsOptProblem.h>
+
+namespace gismo
+{
+
+/**
+   \brief Unconstrained optimization problem whose objective gradient
+   is computed exactly by reverse mode algorithmic differentiation.
+
+   The objective is a function object which is templated on the
+   scalar type,
+   \code
+   struct Objective
+   {
+       template<class S> S operator()(const gsVector<S> & u) const;
+   };
+   \endcode
+   It is evaluated with \a T by evalObj() and with the reverse AD type
+   of CoDiPack by gradObj_into(). The cost of the gradient is a small
+   multiple of the cost of the objective, independently of the number
+   of design variables, as opposed to the 4n evaluations of the finite
+   differences of gsOptProblem.
+
+   \ingroup Optimizer
+*/
+template <typename T, class Objective>
+class gsCoDiOptProblem : public gsOptProblem<T>
+{
+public:
+    typedef codi::RealReverseGen<T> Real;
+    typedef typename Real::Tape Tape;
+
+public:
+
+    /// Constructor, taking the objective and the initial design
+    gsCoDiOptProblem(const Objective & obj, const gsVector<T> & init)
+    : m_obj(obj)
+    {
+        m_numDesignVars  = init.size();
+        m_numConstraints = 0;
+        m_numConJacNonZero = 0;
+
+        m_desLowerBounds.setConstant(m_numDesignVars, -1.0e19);
+        m_desUpperBounds.setConstant(m_numDesignVars,  1.0e19);
+
+        m_curDesign = init;
+    }
+
+public:
+
+    T evalObj( const gsAsConstVector<T> & u ) const
+    {
+        return m_obj( gsVector<T>(u) );
+    }
+
+    void gradObj_into( const gsAsConstVector<T> & u, gsAsVector<T> & result) const
+    {
+        const index_t n = u.size();
+        Tape & tape = Real::getTape();
+        tape.setActive();
+
+        gsVector<Real> x(n);
+        for (index_t i = 0; i != n; ++i)
+        {
+            x[i] = u[i];
+            tape.registerInput(x[i]);
+        }
+
+        Real y = m_obj(x);
+        tape.registerOutput(y);
+        tape.setPassive();
+
+        y.setGradient(1.0);
+        tape.evaluate();
+        for (index_t i = 0; i != n; ++i)
+            result[i] = x[i].getGradient();
+        tape.reset();
+    }
+
+    /// The problem holds a copy of the objective only
+    typename gsOptProblem<T>::uPtr clone() const
+    { return typename gsOptProblem<T>::uPtr(new gsCoDiOptProblem(*this)); }
+
+private:
+
+    Objective m_obj;
+
+    using gsOptProblem<T>::m_numDesignVars;
+    using gsOptProblem<T>::m_numConstraints;
+    using gsOptProblem<T>::m_numConJacNonZero;
+
+    using gsOptProblem<T>::m_desLowerBounds;
+    using gsOptProblem<T>::m_desUpperBounds;
+
+    using gsOptProblem<T>::m_curDesign;
+};
+
+} // end namespace gismo
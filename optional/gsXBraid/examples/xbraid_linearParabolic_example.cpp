@@ -0,0 +1,110 @@
+/** @file xbraid_linearParabolic_example.cpp
+
+    @brief Parallel-in-time solution of the heat equation by gsXBraidLinearParabolic
+
+    Run e.g. by
+    mpirun -np 4 ./bin/xbraid_linearParabolic_example -n 256
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gismo.h>
+#include <gsXBraid/gsXBraidLinearParabolic.h>
+
+using namespace gismo;
+
+int main(int argc, char**argv)
+{
+#ifdef gsXBraid_ENABLED
+  index_t numRefine = 3;
+  index_t numSteps  = 64;
+  index_t cfactor   = 2;
+  real_t  tfinal    = 0.1;
+  real_t  theta     = 0.5;
+  bool    fmg       = false;
+
+  gsCmdLine cmd("Solves the heat equation by multigrid-reduction-in-time.");
+  cmd.addInt ("r", "uniformRefine", "Number of uniform h-refinement steps", numRefine);
+  cmd.addInt ("n", "numSteps", "Number of time steps", numSteps);
+  cmd.addInt ("c", "cfactor", "Coarsening factor in time", cfactor);
+  cmd.addReal("t", "tfinal", "Final time", tfinal);
+  cmd.addReal("", "theta", "Theta-scheme on the fine time grid", theta);
+  cmd.addSwitch("fmg", "Use F-cycles", fmg);
+  try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+  // Initialize the MPI environment and obtain the world communicator
+  gsMpiComm comm = gsMpi::init(argc, argv).worldComm();
+
+  // Spatial discretization
+  gsMultiPatch<> mp(*gsNurbsCreator<>::BSplineSquare(1.0));
+  gsMultiBasis<> mb(mp);
+  mb.degreeElevate();
+  for (index_t i = 0; i < numRefine; ++i)
+    mb.uniformRefine();
+
+  gsFunctionExpr<> f("1", 2);
+  gsConstantFunction<> zero(0.0, 2);
+  gsBoundaryConditions<> bc;
+  for (gsMultiPatch<>::const_biterator it = mp.bBegin(); it != mp.bEnd(); ++it)
+    bc.addCondition(*it, condition_type::dirichlet, &zero);
+  bc.setGeoMap(mp);
+
+  gsExprAssembler<> K(1,1), M(1,1);
+  K.setIntegrationElements(mb);
+  M.setIntegrationElements(mb);
+  gsExprAssembler<>::geometryMap G_K = K.getMap(mp), G_M = M.getMap(mp);
+  gsExprAssembler<>::space u_K = K.getSpace(mb), u_M = M.getSpace(mb);
+  u_K.setup(bc, dirichlet::l2Projection, 0);
+  u_M.setup(bc, dirichlet::l2Projection, 0);
+  auto ff = K.getCoeff(f, G_K);
+
+  K.initSystem();
+  K.assemble( igrad(u_K, G_K) * igrad(u_K, G_K).tr() * meas(G_K), u_K * ff * meas(G_K) );
+  M.initSystem();
+  M.assemble( u_M * u_M.tr() * meas(G_M) );
+
+  const gsMatrix<> u0 = gsMatrix<>::Zero(M.numDofs(), 1);
+
+  // Parallel-in-time solution
+  gsXBraidLinearParabolic<real_t> app(comm, 0.0, tfinal, numSteps,
+                                      M.matrix(), K.matrix(), K.rhs(), u0);
+  app.options().setReal("Theta", theta);
+  app.options().setInt ("CFactor", cfactor);
+  app.options().setSwitch("FMG", fmg);
+  app.options().setInt ("PrintLevel", 1);
+
+  gsStopwatch clock;
+  app.solve();
+  const real_t tpar = clock.stop();
+
+  if (app.hasSolution())
+  {
+    // Sequential time stepping for comparison
+    gsTimeIntegrator<real_t> ti(M.matrix(), K.matrix(), K.rhs());
+    ti.options().setReal("Theta", theta);
+    ti.setInitialValue(u0);
+    ti.setTimeStep(tfinal / numSteps);
+    clock.restart();
+    ti.integrate(tfinal);
+    const real_t tseq = clock.stop();
+
+    gsInfo << "Number of MPI processes        : " << comm.size() << "\n"
+           << "MGRIT iterations               : " << app.iterations() << "\n"
+           << "Factorizations on this rank    : " << app.numFactorizations() << "\n"
+           << "Wall time (parallel-in-time)   : " << tpar << "\n"
+           << "Wall time (sequential, 1 rank) : " << tseq << "\n"
+           << "Difference to time stepping    : "
+           << (app.solution() - ti.solution()).norm() / ti.solution().norm() << "\n";
+  }
+#else
+  GISMO_UNUSED(argc); GISMO_UNUSED(argv);
+  gsInfo << "XBraid is not enabled.\n";
+#endif
+  return 0;
+}
@@ -0,0 +1,269 @@
+/** @file gsXBraidLinearParabolic.h
+
+    @brief Provides a parallel-in-time solver for linear parabolic problems
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsXBraid/gsXBraid.h>
+
+namespace gismo {
+
+  /**
+     \brief Parallel-in-time solver for M u' + K u = f
+
+     The mass matrix M, the stiffness matrix K and the right-hand side
+     f are given once, e.g. as the matrices and the right-hand side of
+     two assembled gsExprAssembler objects. The time steps are
+     performed by the theta-scheme
+     \f[ (M + \theta\Delta t K) u_{i} = (M - (1-\theta)\Delta t K) u_{i-1} + \Delta t f \f]
+     with parameter "Theta" on the fine time grid and "CoarseTheta"
+     on the coarser grids of the multigrid-reduction-in-time (MGRIT)
+     hierarchy, which is built by XBraid with coarsening factor
+     "CFactor".
+
+     The spatial systems are solved by the gsSparseSolver "Solver".
+     Every step size of every level is factorized once, so that every
+     time step is a back-substitution. The problem is small enough
+     to be stored on every rank, the time slices are distributed
+     among the ranks of the communicator (e.g. mpirun -np 4). Without
+     MPI, XBraid runs sequentially.
+
+     \code{.cpp}
+     gsXBraidLinearParabolic<real_t> app(comm, 0, 1, 256,
+                                         M.matrix(), K.matrix(), K.rhs(), u0);
+     app.solve();
+     if (app.hasSolution()) gsInfo << app.solution().norm() << "\n";
+     \endcode
+
+     \ingroup XBraid
+  */
+  template<typename T>
+  class gsXBraidLinearParabolic : public gsXBraid< gsMatrix<T> >
+  {
+  public:
+    typedef gsXBraid< gsMatrix<T> > Base;
+
+    /// Constructor by the mass matrix \a M, the stiffness matrix \a
+    /// K, the right-hand side \a f and the initial value \a u0 at \a
+    /// tstart. The options are applied by solve().
+    gsXBraidLinearParabolic(const gsMpiComm&          comm,
+                            const T                   tstart,
+                            const T                   tstop,
+                            index_t                   ntime,
+                            const gsSparseMatrix<T> & M,
+                            const gsSparseMatrix<T> & K,
+                            const gsMatrix<T>       & f,
+                            const gsMatrix<T>       & u0)
+      : Base(comm, tstart, tstop, (braid_Int)ntime),
+        m_mass(M), m_stiff(K), m_rhs(f), m_u0(u0),
+        m_tstop(tstop), m_options(defaultOptions())
+    {
+      GISMO_ASSERT(M.rows() == K.rows() && M.rows() == f.rows() &&
+                   M.rows() == u0.rows(), "Dimensions do not match.");
+    }
+
+    /// Default options
+    static gsOptionList defaultOptions()
+    {
+      gsOptionList opt;
+      opt.addReal  ("Theta",       "Theta-scheme on the fine time grid", 0.5);
+      opt.addReal  ("CoarseTheta", "Theta-scheme on the coarse time grids", 1.0);
+      opt.addString("Solver",      "Sparse solver for the spatial systems", "SimplicialLDLT");
+      opt.addInt   ("CFactor",     "Coarsening factor of the time grids", 2);
+      opt.addInt   ("MaxLevels",   "Maximum number of MGRIT levels", 10);
+      opt.addInt   ("MinCoarse",   "Minimum number of time intervals of the coarsest grid", 2);
+      opt.addInt   ("MaxIter",     "Maximum number of MGRIT iterations", 100);
+      opt.addInt   ("NRelax",      "Number of CF-relaxation sweeps", 1);
+      opt.addReal  ("AbsTol",      "Absolute tolerance of the MGRIT iterations", 1e-10);
+      opt.addInt   ("PrintLevel",  "Print level of XBraid", 0);
+      opt.addSwitch("FMG",         "Use F-cycles", false);
+      opt.addSwitch("Residual",    "Use the residual of the implicit systems", false);
+      return opt;
+    }
+
+    /// Returns the options
+    gsOptionList & options() { return m_options; }
+
+    /// Runs the parallel-in-time multigrid solver
+    void solve()
+    {
+      this->SetCFactor   (m_options.getInt("CFactor"));
+      this->SetMaxLevels (m_options.getInt("MaxLevels"));
+      this->SetMinCoarse (m_options.getInt("MinCoarse"));
+      this->SetMaxIter   (m_options.getInt("MaxIter"));
+      this->SetNRelax    (m_options.getInt("NRelax"));
+      this->SetAbsTol    (m_options.getReal("AbsTol"));
+      this->SetPrintLevel(m_options.getInt("PrintLevel"));
+      if (m_options.getSwitch("FMG"))      this->SetFMG();
+      if (m_options.getSwitch("Residual")) this->SetResidual();
+      m_solution.resize(0, 0);
+      Base::solve();
+    }
+
+    /// Returns true if the solution at the final time is stored on
+    /// this rank
+    bool hasSolution() const { return 0 != m_solution.size(); }
+
+    /// Returns the solution at the final time (empty on the ranks
+    /// which do not own the final time slice)
+    const gsMatrix<T> & solution() const { return m_solution; }
+
+    /// Returns the number of factorizations performed
+    index_t numFactorizations() const { return m_cache.size(); }
+
+  public:
+
+    /// Initializes a vector by the initial value
+    braid_Int Init(braid_Real    ,
+                   braid_Vector *u_ptr)
+    {
+      gsMatrix<T>* u = new gsMatrix<T>(m_u0);
+      *u_ptr = (braid_Vector) u;
+      return braid_Int(0);
+    }
+
+    /// Performs a single step of the theta-scheme
+    braid_Int Step(braid_Vector    u,
+                   braid_Vector    ,
+                   braid_Vector    fstop,
+                   BraidStepStatus &status)
+    {
+      gsMatrix<T>* u_ptr = (gsMatrix<T>*) u;
+      gsXBraidStepStatus & st = static_cast<gsXBraidStepStatus&>(status);
+      const std::pair<braid_Real, braid_Real> time = st.timeInterval();
+      const T dt = time.second - time.first;
+      const T th = theta(st.level());
+
+      explicitPart(th, dt, *u_ptr, m_tmp);
+      // XBraid forcing of the implicit system (if "Residual" is set)
+      if (fstop != NULL)
+        m_tmp += *(gsMatrix<T>*) fstop;
+      *u_ptr = factorization(th, dt).solve(m_tmp);
+      return braid_Int(0);
+    }
+
+    /// Computes the residual of the implicit system of a step, \a r
+    /// contains the vector at the start of the interval on input
+    braid_Int Residual(braid_Vector     ustop,
+                       braid_Vector     r,
+                       BraidStepStatus &status)
+    {
+      gsMatrix<T>* ustop_ptr = (gsMatrix<T>*) ustop;
+      gsMatrix<T>* r_ptr     = (gsMatrix<T>*) r;
+      gsXBraidStepStatus & st = static_cast<gsXBraidStepStatus&>(status);
+      const std::pair<braid_Real, braid_Real> time = st.timeInterval();
+      const T dt = time.second - time.first;
+      const T th = theta(st.level());
+
+      explicitPart(th, dt, *r_ptr, m_tmp);
+      r_ptr->noalias() = m_mass * (*ustop_ptr);
+      if (0 != th)
+        r_ptr->noalias() += (th * dt) * (m_stiff * (*ustop_ptr));
+      *r_ptr -= m_tmp;
+      return braid_Int(0);
+    }
+
+    /// Sets the size of the MPI communication buffer
+    braid_Int BufSize(braid_Int         *size_ptr,
+                      BraidBufferStatus &)
+    {
+      *size_ptr = sizeof(T)*(m_u0.size()+2);
+      return braid_Int(0);
+    }
+
+    /// Stores the solution at the final time
+    braid_Int Access(braid_Vector       u,
+                     BraidAccessStatus &status)
+    {
+      gsXBraidAccessStatus & st = static_cast<gsXBraidAccessStatus&>(status);
+      if (st.done() && st.time() >= m_tstop - 1e-10 * math::max(T(1), math::abs(m_tstop)))
+        m_solution = *(gsMatrix<T>*) u;
+      return braid_Int(0);
+    }
+
+    /// Performs spatial coarsening (identity)
+    braid_Int Coarsen(braid_Vector           fu,
+                      braid_Vector          *cu_ptr,
+                      BraidCoarsenRefStatus &)
+    {
+      return this->Clone(fu, cu_ptr);
+    }
+
+    /// Performs spatial refinement (identity)
+    braid_Int Refine(braid_Vector           cu,
+                     braid_Vector          *fu_ptr,
+                     BraidCoarsenRefStatus &)
+    {
+      return this->Clone(cu, fu_ptr);
+    }
+
+  private:
+
+    /// Theta parameter on the given level
+    T theta(braid_Int level) const
+    {
+      return m_options.getReal(0 == level ? "Theta" : "CoarseTheta");
+    }
+
+    /// Computes (M - (1-theta) dt K) u + dt f
+    void explicitPart(const T th, const T dt, const gsMatrix<T> & u,
+                      gsMatrix<T> & result) const
+    {
+      result.noalias() = m_mass * u;
+      if (1 != th)
+        result.noalias() -= ((1-th) * dt) * (m_stiff * u);
+      result += dt * m_rhs;
+    }
+
+    /// Returns the factorization of M + theta dt K, computed at the
+    /// first request. The step sizes of a level differ by round-off.
+    gsSparseSolver<T> & factorization(const T th, const T dt)
+    {
+      for (typename std::vector<Entry>::iterator it = m_cache.begin();
+           it != m_cache.end(); ++it)
+        if (it->theta == th && math::abs(it->dt - dt) <= 1e-10 * it->dt)
+          return *it->solver;
+
+      Entry e;
+      e.theta  = th;
+      e.dt     = dt;
+      e.solver = memory::shared_ptr<gsSparseSolver<T> >(
+        gsSparseSolver<T>::get( m_options.getString("Solver") ).release() );
+      const gsSparseMatrix<T> A = m_mass + (th * dt) * m_stiff;
+      e.solver->compute(A);
+      GISMO_ENSURE(e.solver->succeed(), "Factorization failed.");
+      m_cache.push_back(e);
+      return *e.solver;
+    }
+
+  private:
+
+    /// Factorization of M + theta dt K
+    struct Entry
+    {
+      T theta, dt;
+      memory::shared_ptr<gsSparseSolver<T> > solver;
+    };
+
+    const gsSparseMatrix<T> & m_mass;
+    const gsSparseMatrix<T> & m_stiff;
+    gsMatrix<T> m_rhs, m_u0;
+    T m_tstop;
+
+    gsOptionList m_options;
+
+    std::vector<Entry> m_cache;
+
+    gsMatrix<T> m_solution, m_tmp;
+  };
+
+}// namespace gismo
@@ -69,6 +69,7 @@ namespace internal
 
 #include <gsCore/gsBoxTopology.h>
 #include <gsCore/gsMultiPatch.h>
+#include <gsCore/gsPointLocator.h>
 #include <gsCore/gsField.h>
 
 #include <gsCore/gsBasis.h>
@@ -153,6 +154,7 @@ namespace internal
 /* ----------- MultiGrid ----------- */
 #include <gsMultiGrid/gsMultiGrid.h>
 #include <gsMultiGrid/gsGridHierarchy.h>
+#include <gsMultiGrid/gsAlgebraicMultiGrid.h>
 
 /* ----------- Quadrature ----------- */
 #include <gsAssembler/gsQuadRule.h>
@@ -165,6 +167,7 @@ namespace internal
 #include <gsAssembler/gsBiharmonicExprAssembler.h>
 #include <gsAssembler/gsCDRAssembler.h>
 #include <gsAssembler/gsHeatEquation.h>
+#include <gsPde/gsTimeIntegrator.h>
 
 #include <gsAssembler/gsExprHelper.h>
 #include <gsAssembler/gsExprAssembler.h>
@@ -179,6 +182,8 @@ namespace internal
 #include <gsSolver/gsGMRes.h>
 #include <gsSolver/gsGradientMethod.h>
 #include <gsSolver/gsConjugateGradient.h>
+#include <gsSolver/gsPipelinedCG.h>
+#include <gsSolver/gsSStepGMRes.h>
 #include <gsSolver/gsBiCgStab.h>
 #include <gsSolver/gsPreconditioner.h>
 #include <gsSolver/gsAdditiveOp.h>
@@ -189,6 +194,7 @@ namespace internal
 #include <gsSolver/gsSumOp.h>
 #include <gsSolver/gsKroneckerOp.h>
 #include <gsSolver/gsPatchPreconditionersCreator.h>
+#include <gsSolver/gsMultiPatchPreconditionersCreator.h>
 #include <gsSolver/gsLanczosMatrix.h>
 #include <gsSolver/gsMinResQLP.h>
 
@@ -206,6 +212,7 @@ namespace internal
 #include <gsIO/gsWriteParaview.h>
 #include <gsIO/gsParaviewCollection.h>
 #include <gsIO/gsParaviewDataSet.h>
+#include <gsIO/gsSnapshotFile.h>
 #include <gsIO/gsReadFile.h>
 #include <gsUtils/gsPointGrid.h>
 #include <gsIO/gsXmlUtils.h>
@@ -33,6 +33,7 @@ gsOptionList gsAssembler<T>::defaultOptions()
     opt.addInt("DirichletStrategy", "Method for enforcement of Dirichlet BCs [11..14]", 11 );
     opt.addInt("DirichletValues"  , "Method for computation of Dirichlet DoF values [100..103]", 101);
     opt.addInt("InterfaceStrategy", "Method of treatment of patch interfaces [0..3]", 1  );
+    opt.addInt("DofOrdering", "Ordering of the free DoFs: natural, RCM, nested dissection, element [0..3]", 0 );
     opt.addReal("quA", "Number of quadrature points: quA*deg + quB", 1.0  );
     opt.addInt ("quB", "Number of quadrature points: quA*deg + quB", 1    );
     opt.addReal("bdA", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 2.0  );
@@ -113,6 +114,8 @@ void gsAssembler<T>::scalarProblemGalerkinRefresh()
         static_cast<dirichlet::strategy>(m_options.getInt("DirichletStrategy")),
         static_cast<iFace::strategy>(m_options.getInt("InterfaceStrategy")),
         this->pde().bc(), mapper, 0);
+    mapper.reorder(m_bases.front(), static_cast<dofOrdering::type>(
+                       m_options.askInt("DofOrdering", dofOrdering::natural)));
 
     if ( 0 == mapper.freeSize() ) // Are there any interior dofs ?
         gsWarn << " No internal DOFs, zero sized system.\n";
@@ -101,7 +101,7 @@ public:
 
     const gsSparseMatrix<T> & mass() const { return m_mass; }
     const gsSparseMatrix<T> & stationaryMatrix() const { return m_stationary->matrix(); }
-    const gsSparseMatrix<T> & stationaryRhs() const { return m_stationary->rhs(); }
+    const gsMatrix<T> & stationaryRhs() const { return m_stationary->rhs(); }
 
     /// Mass assembly routine
     void assembleMass();
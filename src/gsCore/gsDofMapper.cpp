@@ -411,10 +411,10 @@ std::ostream& gsDofMapper::print( std::ostream& os ) const
     m_tagged.resize( std::distance(m_tagged.begin(),it) );
 
     //coupled dofs cannot be tracked anymore on this component
-    m_numCpldDofs[comp+1]=m_numCpldDofs[comp];
-    for(std::vector<index_t>::iterator s=m_numCpldDofs.begin()+comp+2;
+    const index_t numCpld = m_numCpldDofs[comp+1] - m_numCpldDofs[comp];
+    for(std::vector<index_t>::iterator s=m_numCpldDofs.begin()+comp+1;
 	s<m_numCpldDofs.end(); ++s)
-      *s += (*s-1);
+      *s -= numCpld;
 }
 
 
@@ -746,4 +746,197 @@ void gsDofMapper::setBoundaryShift (index_t shift)
     m_bshift=shift;
 }
 
+namespace
+{
+
+// Adjacency graph of the dofs in compressed storage
+struct dofGraph
+{
+    std::vector<index_t> ptr, adj;
+    index_t degree(const index_t v) const { return ptr[v+1]-ptr[v]; }
+};
+
+// Breadth-first search from root within the nodes v with
+// mask[v]==id, visiting the neighbours by increasing degree. The
+// nodes are appended to order and their levels are set (the levels
+// of unvisited nodes must be -1). Returns the eccentricity of root.
+index_t bfs(const dofGraph & g, const index_t root,
+            const std::vector<index_t> & mask, const index_t id,
+            std::vector<index_t> & level, std::vector<index_t> & order)
+{
+    const size_t first = order.size();
+    std::vector<index_t> nb;
+    level[root] = 0;
+    order.push_back(root);
+    for (size_t i = first; i != order.size(); ++i)
+    {
+        const index_t v = order[i];
+        nb.clear();
+        for (index_t j = g.ptr[v]; j != g.ptr[v+1]; ++j)
+        {
+            const index_t w = g.adj[j];
+            if (mask[w]==id && level[w] < 0)
+            {
+                level[w] = level[v] + 1;
+                nb.push_back(w);
+            }
+        }
+        std::stable_sort(nb.begin(), nb.end(), [&g](index_t a, index_t b)
+                         { return g.degree(a) < g.degree(b); });
+        order.insert(order.end(), nb.begin(), nb.end());
+    }
+    return level[order.back()];
+}
+
+// Breadth-first search of the connected component of start from a
+// pseudo-peripheral node (George and Liu)
+void peripheralBfs(const dofGraph & g, const index_t start,
+                   const std::vector<index_t> & mask, const index_t id,
+                   std::vector<index_t> & level, std::vector<index_t> & order)
+{
+    const size_t first = order.size();
+    index_t ecc = bfs(g, start, mask, id, level, order);
+    for (;;)
+    {
+        // the node of minimal degree in the last level
+        index_t root = order.back();
+        for (size_t i = order.size(); i-- > first && level[order[i]] == ecc; )
+            if (g.degree(order[i]) < g.degree(root))
+                root = order[i];
+
+        for (size_t i = first; i != order.size(); ++i)
+            level[order[i]] = -1;
+        order.resize(first);
+        const index_t e = bfs(g, root, mask, id, level, order);
+        if (e <= ecc)
+            return;
+        ecc = e;
+    }
+}
+
+// Appends the nodes with mask==id in nested dissection order: the
+// connected components are separated recursively by the middle
+// level of their level structure, and the separators are numbered
+// after the two parts. Small parts are ordered by reverse
+// Cuthill-McKee.
+void dissect(const dofGraph & g, const std::vector<index_t> & nodes,
+             std::vector<index_t> & mask, const index_t id, index_t & nextId,
+             std::vector<index_t> & level, std::vector<index_t> & order)
+{
+    static const size_t leafSize = 64;
+    std::vector<index_t> comp;
+    std::vector<std::vector<index_t> > parts;
+    for (std::vector<index_t>::const_iterator v = nodes.begin(); v != nodes.end(); ++v)
+    {
+        if (level[*v] >= 0) continue; // in a previous component
+        comp.clear();
+        peripheralBfs(g, *v, mask, id, level, comp);
+        const index_t numLevels = level[comp.back()] + 1;
+        if (comp.size() <= leafSize || numLevels < 3)
+        {
+            order.insert(order.end(), comp.rbegin(), comp.rend());
+            continue;
+        }
+
+        const index_t mid = numLevels / 2;
+        parts.resize(parts.size() + 3);
+        std::vector<index_t> * p = &parts[parts.size() - 3];
+        for (std::vector<index_t>::const_iterator w = comp.begin(); w != comp.end(); ++w)
+            p[ level[*w] < mid ? 0 : (level[*w] > mid ? 1 : 2) ].push_back(*w);
+    }
+
+    for (std::vector<index_t>::const_iterator v = nodes.begin(); v != nodes.end(); ++v)
+        level[*v] = -1;
+
+    for (size_t i = 0; i != parts.size(); i += 3)
+    {
+        for (index_t k = 0; k != 2; ++k)
+        {
+            const index_t pid = ++nextId;
+            for (std::vector<index_t>::const_iterator w = parts[i+k].begin(); w != parts[i+k].end(); ++w)
+                mask[*w] = pid;
+            dissect(g, parts[i+k], mask, pid, nextId, level, order);
+        }
+        order.insert(order.end(), parts[i+2].begin(), parts[i+2].end());
+    }
+}
+
+} // namespace
+
+gsVector<index_t> gsDofMapper::computeOrdering(dofOrdering::type ordering, index_t numDofs,
+                                               const std::vector<index_t> & elPtr,
+                                               const std::vector<index_t> & elInd)
+{
+    GISMO_ASSERT(!elPtr.empty() && elPtr.back() == static_cast<index_t>(elInd.size()),
+                 "Invalid element connectivity");
+    gsVector<index_t> perm = gsVector<index_t>::Constant(numDofs, -1);
+    index_t cur = 0;
+
+    if (dofOrdering::natural == ordering)
+        perm.setLinSpaced(numDofs, 0, numDofs - 1);
+    else if (dofOrdering::element == ordering)
+    {
+        for (std::vector<index_t>::const_iterator i = elInd.begin(); i != elInd.end(); ++i)
+            if (perm[*i] < 0) perm[*i] = cur++;
+    }
+    else
+    {
+        // Adjacency graph, two dofs are adjacent if they share an element
+        std::vector<std::vector<index_t> > adj(numDofs);
+        std::vector<index_t> mask(numDofs, -1);
+        for (size_t e = 0; e + 1 < elPtr.size(); ++e)
+            for (index_t i = elPtr[e]; i != elPtr[e+1]; ++i)
+            {
+                mask[elInd[i]] = 0;
+                for (index_t j = elPtr[e]; j != elPtr[e+1]; ++j)
+                    if (elInd[i] != elInd[j])
+                        adj[elInd[i]].push_back(elInd[j]);
+            }
+
+        dofGraph g;
+        g.ptr.reserve(numDofs + 1);
+        g.ptr.push_back(0);
+        for (index_t v = 0; v != numDofs; ++v)
+        {
+            std::sort(adj[v].begin(), adj[v].end());
+            adj[v].erase(std::unique(adj[v].begin(), adj[v].end()), adj[v].end());
+            g.adj.insert(g.adj.end(), adj[v].begin(), adj[v].end());
+            g.ptr.push_back(g.adj.size());
+            std::vector<index_t>().swap(adj[v]);
+        }
+
+        // the dofs which belong to some element
+        std::vector<index_t> nodes, order, level(numDofs, -1);
+        for (index_t v = 0; v != numDofs; ++v)
+            if (0 == mask[v]) nodes.push_back(v);
+        order.reserve(nodes.size());
+
+        switch (ordering)
+        {
+        case dofOrdering::rcm:
+            for (std::vector<index_t>::const_iterator v = nodes.begin(); v != nodes.end(); ++v)
+                if (level[*v] < 0)
+                    peripheralBfs(g, *v, mask, 0, level, order);
+            std::reverse(order.begin(), order.end());
+            break;
+        case dofOrdering::nestedDissection:
+        {
+            index_t nextId = 0;
+            dissect(g, nodes, mask, 0, nextId, level, order);
+            break;
+        }
+        default:
+            GISMO_ERROR("Unknown dof ordering "<< ordering);
+        }
+
+        for (std::vector<index_t>::const_iterator v = order.begin(); v != order.end(); ++v)
+            perm[*v] = cur++;
+    }
+
+    // dofs which do not belong to any element
+    for (index_t v = 0; v != numDofs; ++v)
+        if (perm[v] < 0) perm[v] = cur++;
+    return perm;
+}
+
 } // namespace gismo
@@ -22,6 +22,27 @@ namespace gismo
 
 #define MAPPER_PATCH_DOF(a,b,c) m_dofs[c][m_offset[b]+a]
 
+/// Orderings of the free dofs, see gsDofMapper::reorder()
+struct dofOrdering
+{
+    enum type
+    {
+        /// Patch by patch, coupled dofs last (the ordering of finalize())
+        natural = 0,
+
+        /// Reverse Cuthill-McKee, reduces the bandwidth of the matrix
+        rcm = 1,
+
+        /// Nested dissection by level structure separators, reduces
+        /// the fill of direct solvers
+        nestedDissection = 2,
+
+        /// In the order in which the dofs are met by the element
+        /// iteration, improves the locality of the assembly
+        element = 3
+    };
+};
+
 /** @brief Maintains a mapping from patch-local dofs to global dof indices
     and allows the elimination of individual dofs.
 
@@ -257,6 +278,31 @@ public:
     /// markCoupledAsTagged() and then use the corresponding functions for tagged dofs.
     void permuteFreeDofs(const gsVector<index_t>& permutation, index_t comp = 0);
 
+    /// \brief Reorders the free dofs of all components by the strategy
+    /// \a ordering, for the connectivity given by the elements of \a
+    /// bases (the bases that this mapper was initialized with).
+    ///
+    /// Everything which uses the mapper for the global indices
+    /// (assembly, gsSparseSystem, the reconstruction of solutions)
+    /// follows the new ordering, as long as it is applied before the
+    /// system is assembled. The same warning as for permuteFreeDofs()
+    /// applies to the coupled dofs.
+    template<class T>
+    void reorder(const gsMultiBasis<T> & bases, dofOrdering::type ordering);
+
+    /** \brief Returns the permutation of \a numDofs dofs by the
+        strategy \a ordering, for the connectivity given by elements
+        in compressed storage: the dofs of element \a e are
+        elInd[elPtr[e]], ..., elInd[elPtr[e+1]-1].
+
+        The result maps old to new indices, as expected by
+        permuteFreeDofs(). Dofs which do not belong to any element
+        are numbered last.
+    */
+    static gsVector<index_t> computeOrdering(dofOrdering::type ordering, index_t numDofs,
+                                              const std::vector<index_t> & elPtr,
+                                              const std::vector<index_t> & elInd);
+
     ///\brief Returns the smallest value of the indices for \a comp
     index_t firstIndex(index_t comp = 0) const
     { return m_numFreeDofs[comp] + m_numElimDofs[comp] + m_shift; }
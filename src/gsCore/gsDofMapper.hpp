@@ -12,6 +12,7 @@
 **/
 
 #include <gsCore/gsMultiBasis.h>
+#include <gsCore/gsDomainIterator.h>
 
 namespace gismo
 {
@@ -137,5 +138,45 @@ void gsDofMapper::initSingle( const gsBasis<T> & basis, index_t nComp)
     m_dofs.resize(nComp, std::vector<index_t>(m_numFreeDofs.back(), 0));
 }
 
+template<class T>
+void gsDofMapper::reorder(const gsMultiBasis<T> & bases, dofOrdering::type ordering)
+{
+    GISMO_ASSERT(m_curElimId>=0, "finalize() was not called on gsDofMapper");
+    GISMO_ASSERT(bases.nBases()==numPatches(), "The bases do not match the mapper");
+    if (dofOrdering::natural == ordering)
+        return;
+
+    gsMatrix<index_t> act;
+    std::vector<index_t> elPtr, elInd;
+    for (size_t c = 0; c!=m_dofs.size(); ++c)
+    {
+        // The free dofs of every element
+        const index_t f0 = m_numFreeDofs[c], f1 = m_numFreeDofs[c+1];
+        elPtr.assign(1, 0);
+        elInd.clear();
+        for (size_t k = 0; k!=bases.nBases(); ++k)
+        {
+            typename gsBasis<T>::domainIter domIt = bases[k].makeDomainIterator();
+            for (; domIt->good(); domIt->next())
+            {
+                bases[k].active_into(domIt->centerPoint(), act);
+                for (index_t i = 0; i!=act.rows(); ++i)
+                {
+                    const index_t gl = MAPPER_PATCH_DOF(act.at(i),k,c);
+                    if (gl < f1) // free dof
+                        elInd.push_back(gl - f0);
+                }
+                elPtr.push_back(elInd.size());
+            }
+        }
+
+        // Lower components keep their indices
+        gsVector<index_t> perm(f1);
+        perm.head(f0).setLinSpaced(f0, 0, f0-1);
+        perm.tail(f1-f0) = computeOrdering(ordering, f1-f0, elPtr, elInd).array() + f0;
+        permuteFreeDofs(perm, c);
+    }
+}
+
 }//namespace gismo
 
@@ -33,6 +33,9 @@ namespace gismo {
     TEMPLATE_INST void gsDofMapper::initSingle(
         const gsBasis<real_t> & bases, index_t nComp);
 
+    TEMPLATE_INST void gsDofMapper::reorder(
+        const gsMultiBasis<real_t> & bases, dofOrdering::type ordering);
+
 #ifdef GISMO_WITH_PYBIND11
 
 namespace py = pybind11;
@@ -138,6 +138,7 @@ template <class T=real_t>                class gsPiecewiseFunction;
 template <class T=real_t>                class gsConstantFunction;
 template <class T=real_t>                class gsAffineFunction;
 template <class T=real_t>                class gsMultiPatch;
+template <class T=real_t>                class gsPointLocator;
 
 // Bases
 template <class basis_t >                class gsRationalBasis;
@@ -302,10 +303,12 @@ template <class T=real_t>                class gsCompositePrecOp;
 template <class T=real_t>                class gsKroneckerOp;
 template <class T=real_t>                class gsBlockOp;
 template <class T=real_t>                class gsPatchPreconditionersCreator;
+template <class T=real_t>                class gsMultiPatchPreconditionersCreator;
 
 // gsMultiGrid
 
 template <class T=real_t>                class gsMultiGridOp;
+template <class T=real_t>                class gsAlgebraicMultiGridOp;
 template <class T=real_t>                class gsGridHierarchy;
 
 // gsIeti
@@ -161,6 +161,11 @@ public:
     typedef gsEigen::ConjugateGradient<gsEigen::SparseMatrix<T,0,index_t>, 
             gsEigen::Lower|gsEigen::Upper, gsEigen::DiagonalPreconditioner<T> > CGDiagonal;
 
+    /// Congugate gradient with incomplete Cholesky preconditioner
+    typedef gsEigen::ConjugateGradient<gsEigen::SparseMatrix<T,0,index_t>,
+            gsEigen::Lower|gsEigen::Upper,
+            gsEigen::IncompleteCholesky<T, gsEigen::Lower, gsEigen::AMDOrdering<index_t> > > CGIncompleteCholesky;
+
     /// BiCGSTAB with Incomplete LU factorization with dual-threshold strategy
     typedef gsEigen::BiCGSTAB<gsEigen::SparseMatrix<T,0,index_t>,
                             gsEigen::IncompleteLUT<T, index_t> > BiCGSTABILUT;
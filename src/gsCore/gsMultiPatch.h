@@ -464,6 +464,45 @@ public:
     std::pair<index_t,gsVector<T> > closestPointTo(const gsVector<T> & pt,
                                                    const T accuracy = 1e-6) const;
 
+    /// @brief Computes the closest points to all columns of \a points,
+    /// using a gsPointLocator.
+    /// \param pids the patch of the closest point of each column
+    /// \param preim the parameters of the closest points, one per column
+    /// \param dist the distances of the points to the closest points
+    void closestPointsTo(const gsMatrix<T> & points, gsVector<index_t> & pids,
+                         gsMatrix<T> & preim, gsVector<T> & dist,
+                         const T accuracy = 1e-6) const;
+
+    /// @brief Evaluates the multipatch at many points scattered over
+    /// the patches.
+    ///
+    /// The points are grouped by patch and, within each patch, sorted
+    /// along the first parameter direction, so that consecutive
+    /// evaluations hit the same knot spans. The groups are evaluated
+    /// in parallel in chunks of at most \a chunk points, using
+    /// per-thread buffers.
+    /// \param pids the patch of each point
+    /// \param u the parameters of the points, one per column
+    /// \param result in column k, the values (\a deriv = 0), the
+    /// first derivatives (\a deriv = 1, as in gsFunction::deriv_into)
+    /// or the second derivatives (\a deriv = 2, as in
+    /// gsFunction::deriv2_into) at the k-th point
+    void evalBatch_into(const gsVector<index_t> & pids, const gsMatrix<T> & u,
+                        gsMatrix<T> & result, int deriv = 0,
+                        index_t chunk = 4096) const;
+
+    /// @brief Evaluates every patch on a tensor grid of \a npts points
+    /// per direction over its parameter domain, in parallel over the
+    /// patches.
+    ///
+    /// The values (or derivatives, see evalBatch_into) on patch k
+    /// are stored in result[k], the grid points are ordered as in
+    /// gsPointGrid. If \a params is not null, (*params)[k] receives
+    /// the grid of patch k.
+    void evalGrid_into(const gsVector<unsigned> & npts,
+                       std::vector<gsMatrix<T> > & result, int deriv = 0,
+                       std::vector<gsMatrix<T> > * params = NULL) const;
+
     /// Construct the interface representation
     std::vector<T> HausdorffDistance(   const gsMultiPatch<T> & other,
                                         const index_t nsamples = 1000,
@@ -17,7 +17,9 @@
 #include <gsCore/gsGeometry.h>
 #include <gsCore/gsDofMapper.h>
 #include <gsCore/gsAffineFunction.h>
+#include <gsCore/gsPointLocator.h>
 #include <gsUtils/gsCombinatorics.h>
+#include <gsUtils/gsPointGrid.h>
 #include <gsMesh2/gsSurfMesh.h>
 #include <gsTensor/gsTensorBasis.h>
 #include <gsAssembler/gsQuadrature.h>
@@ -867,6 +869,145 @@ gsMultiPatch<T>::closestPointTo(const gsVector<T> & pt,
 }
 
 
+template<class T>
+void gsMultiPatch<T>::closestPointsTo(const gsMatrix<T> & points,
+                                      gsVector<index_t> & pids,
+                                      gsMatrix<T> & preim, gsVector<T> & dist,
+                                      const T accuracy) const
+{
+    gsPointLocator<T> locator(*this);
+    locator.closestPoints(points, pids, preim, dist, accuracy);
+}
+
+template<class T>
+void gsMultiPatch<T>::evalBatch_into(const gsVector<index_t> & pids,
+                                     const gsMatrix<T> & u,
+                                     gsMatrix<T> & result, int deriv,
+                                     index_t chunk) const
+{
+    GISMO_ASSERT( pids.size() == u.cols(), "Expecting one patch id per point." );
+    GISMO_ASSERT( u.rows() == parDim(), "Invalid parameter dimension." );
+    GISMO_ENSURE( deriv >= 0 && deriv <= 2, "Derivatives up to order two are supported." );
+    const index_t np = nPatches(), n = u.cols(), d = parDim();
+
+    // Group the points by patch (counting sort) ..
+    std::vector<index_t> offset(np + 1, 0), perm(n);
+    for (index_t k = 0; k != n; ++k)
+    {
+        GISMO_ASSERT( pids[k] >= 0 && pids[k] < np, "Invalid patch id " << pids[k] );
+        ++offset[pids[k] + 1];
+    }
+    std::partial_sum(offset.begin(), offset.end(), offset.begin());
+    std::vector<index_t> pos(offset.begin(), offset.end() - 1);
+    for (index_t k = 0; k != n; ++k)
+        perm[pos[pids[k]]++] = k;
+
+    // .. and, within each patch, by knot span along the first direction
+    for (index_t p = 0; p != np; ++p)
+        std::sort(perm.begin() + offset[p], perm.begin() + offset[p + 1],
+                  [&u](index_t i, index_t j) { return u(0, i) < u(0, j); });
+
+    // Work items: chunks of points on the same patch
+    std::vector<std::pair<index_t,index_t> > items;
+    for (index_t p = 0; p != np; ++p)
+        for (index_t b = offset[p]; b < offset[p + 1]; b += chunk)
+            items.push_back( std::make_pair(p, b) );
+
+    const index_t nr = targetDim() * (0 == deriv ? 1 : 1 == deriv ? d : d * (d + 1) / 2);
+    result.resize(nr, n);
+
+#   pragma omp parallel
+    {
+        gsMatrix<T> pts, vals; // per-thread scratch buffers
+#       pragma omp for schedule(dynamic)
+        for (index_t it = 0; it < static_cast<index_t>(items.size()); ++it)
+        {
+            const index_t p = items[it].first, b = items[it].second,
+                e = math::min(b + chunk, offset[p + 1]);
+
+            pts.resize(d, e - b);
+            for (index_t k = b; k != e; ++k)
+                pts.col(k - b) = u.col(perm[k]);
+
+            switch (deriv)
+            {
+            case 0 : m_patches[p]->eval_into  (pts, vals); break;
+            case 1 : m_patches[p]->deriv_into (pts, vals); break;
+            default: m_patches[p]->deriv2_into(pts, vals); break;
+            }
+
+            for (index_t k = b; k != e; ++k)
+                result.col(perm[k]) = vals.col(k - b);
+        }
+    }//omp parallel
+}
+
+namespace internal
+{
+
+// Tensor-product patches are sampled by per-direction basis tables,
+// curves have no tensor structure to exploit
+template<short_t d, class T>
+bool evalTensorGrid(const gsGeometry<T> & g, const gsMatrix<T> & supp,
+                    const gsVector<unsigned> & npts, gsMatrix<T> & result,
+                    int deriv)
+{
+    const gsTensorBasis<d,T> * tb = dynamic_cast<const gsTensorBasis<d,T>*>(&g.basis());
+    if ( NULL == tb || deriv > 1 )
+        return false;
+    std::vector<gsMatrix<T> > grid(d);
+    for (short_t i = 0; i < d; ++i)
+        grid[i] = gsVector<T>::LinSpaced(npts[i], supp(i,0), supp(i,1)).transpose();
+    tb->evalGrid_into(grid, g.coefs(), result, deriv);
+    return true;
+}
+
+} // namespace internal
+
+template<class T>
+void gsMultiPatch<T>::evalGrid_into(const gsVector<unsigned> & npts,
+                                    std::vector<gsMatrix<T> > & result, int deriv,
+                                    std::vector<gsMatrix<T> > * params) const
+{
+    GISMO_ASSERT( npts.size() == parDim(), "Invalid number of grid points." );
+    GISMO_ENSURE( deriv >= 0 && deriv <= 2, "Derivatives up to order two are supported." );
+    const index_t np = nPatches();
+    result.resize(np);
+    if (params)
+        params->resize(np);
+
+#   pragma omp parallel
+    {
+        gsMatrix<T> pts, supp; // per-thread scratch buffers
+#       pragma omp for schedule(dynamic)
+        for (index_t p = 0; p < np; ++p)
+        {
+            supp = m_patches[p]->support();
+            if (params)
+                (*params)[p] = gsPointGrid<T>(supp.col(0), supp.col(1), npts);
+
+            bool done = false;
+            switch (parDim())
+            {
+            case 2 : done = internal::evalTensorGrid<2,T>(*m_patches[p], supp, npts, result[p], deriv); break;
+            case 3 : done = internal::evalTensorGrid<3,T>(*m_patches[p], supp, npts, result[p], deriv); break;
+            case 4 : done = internal::evalTensorGrid<4,T>(*m_patches[p], supp, npts, result[p], deriv); break;
+            default: break;
+            }
+            if (done)
+                continue;
+
+            pts = gsPointGrid<T>(supp.col(0), supp.col(1), npts);
+            switch (deriv)
+            {
+            case 0 : m_patches[p]->eval_into  (pts, result[p]); break;
+            case 1 : m_patches[p]->deriv_into (pts, result[p]); break;
+            default: m_patches[p]->deriv2_into(pts, result[p]); break;
+            }
+        }
+    }//omp parallel
+}
+
 template<class T>
 T gsMultiPatch<T>::closestDistance(const gsVector<T> & pt,
                                 std::pair<index_t,gsVector<T> > & result,
@@ -0,0 +1,150 @@
+/** @file gsPointLocator.h
+
+    @brief Bounding volume hierarchy for closest point queries and
+    point inversion on multi-patch geometries.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsMultiPatch.h>
+
+namespace gismo
+{
+
+/**
+   \brief Accelerates closest point queries and point inversion on a
+   collection of patches.
+
+   Every element of every patch is enclosed in the bounding box of the
+   control points which are active on it. By the convex hull property
+   of B-splines, NURBS (with positive weights) and THB-splines this
+   box contains the image of the element. The boxes are organized in
+   a bounding volume hierarchy which is traversed nearest-first, so
+   that the Newton iteration is only started on the few elements
+   which may contain the closest point.
+
+   Batches of points are sorted along a space filling curve and
+   processed in parallel; every query is warm-started from the result
+   of the previous (nearby) point.
+
+   The locator keeps references to the patches, which must outlive it.
+   If the control points change (eg. in a fitting loop) call refit(),
+   if the bases are refined call rebuild().
+
+   \ingroup Core
+*/
+template<class T>
+class gsPointLocator
+{
+public:
+
+    /// Creates a locator for the patches of \a mp
+    explicit gsPointLocator(const gsMultiPatch<T> & mp);
+
+    /// Creates a locator for the single patch \a geo
+    explicit gsPointLocator(const gsGeometry<T> & geo);
+
+public:
+
+    /// Updates the boxes to the current control points, keeping
+    /// the elements and the hierarchy
+    void refit();
+
+    /// Rebuilds the hierarchy, eg. after the bases were refined
+    void rebuild();
+
+    /// Number of elements (leaves) stored
+    index_t numElements() const { return m_elPatch.size(); }
+
+    /// Returns the bounding box of all patches as a matrix with two
+    /// columns, the lower and the upper corner
+    gsMatrix<T> boundingBox() const;
+
+    /**
+       \brief Computes the closest point to \a pt.
+
+       \param pt the query point
+       \param pid the patch of the closest point. On input, if \a
+       pid is a valid patch index then (\a pid, \a preim) is used as an
+       initial guess
+       \param preim the parameters of the closest point on patch \a pid
+       \param accuracy accuracy of the Newton iteration
+       \returns the distance of \a pt to the closest point
+     */
+    T closestPoint(const gsVector<T> & pt, index_t & pid,
+                   gsVector<T> & preim, const T accuracy = 1e-6) const;
+
+    /**
+       \brief Computes the closest points to the columns of \a points, in parallel.
+
+       \param points the query points, one per column
+       \param pids the patch of the closest point of each column
+       \param preim the parameters of the closest points, one per column
+       \param dist the distances of the points to the closest points
+       \param accuracy accuracy of the Newton iteration
+     */
+    void closestPoints(const gsMatrix<T> & points, gsVector<index_t> & pids,
+                       gsMatrix<T> & preim, gsVector<T> & dist,
+                       const T accuracy = 1e-6) const;
+
+    /**
+       \brief Computes the parameters of the columns of \a points,
+       which are assumed to lie on the patches.
+
+       Points which are not found within \a accuracy on any patch get
+       the patch index -1 and infinite parameters.
+     */
+    void invertPoints(const gsMatrix<T> & points, gsVector<index_t> & pids,
+                      gsMatrix<T> & preim, const T accuracy = 1e-6) const;
+
+private:
+
+    struct Node
+    {
+        index_t first, count; // leaf: elements m_order[first,first+count)
+        index_t right;        // inner node: the left child is the next node
+    };
+
+    void computeElementBoxes();
+
+    index_t buildNode(index_t first, index_t last);
+
+    void refitNodes();
+
+    T query(const gsVector<T> & pt, index_t & pid, gsVector<T> & preim,
+            const T accuracy) const;
+
+    T solveOn(const index_t k, const gsVector<T> & pt, gsVector<T> & u,
+              const T accuracy) const;
+
+    uint64_t mortonCode(const gsVector<T> & pt, const gsMatrix<T> & box) const;
+
+private:
+
+    std::vector<const gsGeometry<T>*> m_patches;
+
+    // Per element: patch, parameter corners, bounding box
+    std::vector<index_t> m_elPatch;
+    gsMatrix<T> m_elLow, m_elUpp;
+    gsMatrix<T> m_boxLow, m_boxUpp;
+
+    // Hierarchy, node 0 is the root
+    std::vector<Node> m_nodes;
+    std::vector<index_t> m_order;
+    gsMatrix<T> m_nodeLow, m_nodeUpp;
+};
+
+} // namespace gismo
+
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsPointLocator.hpp)
+#endif
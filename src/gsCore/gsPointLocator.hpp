@@ -0,0 +1,369 @@
+/** @file gsPointLocator.hpp
+
+    @brief Bounding volume hierarchy for closest point queries and
+    point inversion on multi-patch geometries.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsDomainIterator.h>
+
+namespace gismo
+{
+
+namespace internal
+{
+
+// Squared distance of a point to an axis aligned box
+template<class T, class Vec, class Box>
+T boxDistance2(const Vec & pt, const Box & low, const Box & upp)
+{
+    T result = 0;
+    for (index_t i = 0; i != pt.rows(); ++i)
+    {
+        const T d = math::max(low[i] - pt[i], pt[i] - upp[i]);
+        if (d > 0) result += d * d;
+    }
+    return result;
+}
+
+}
+
+template<class T>
+gsPointLocator<T>::gsPointLocator(const gsMultiPatch<T> & mp)
+{
+    for (size_t k = 0; k != mp.nPatches(); ++k)
+        m_patches.push_back(&mp.patch(k));
+    rebuild();
+}
+
+template<class T>
+gsPointLocator<T>::gsPointLocator(const gsGeometry<T> & geo)
+: m_patches(1, &geo)
+{
+    rebuild();
+}
+
+template<class T>
+void gsPointLocator<T>::rebuild()
+{
+    GISMO_ENSURE(!m_patches.empty(), "No patches given.");
+    const short_t pdim = m_patches.front()->parDim();
+
+    // Collect the elements of all patches
+    m_elPatch.clear();
+    std::vector<T> low, upp;
+    for (size_t k = 0; k != m_patches.size(); ++k)
+    {
+        typename gsBasis<T>::domainIter domIt =
+            m_patches[k]->basis().makeDomainIterator();
+        for (; domIt->good(); domIt->next())
+        {
+            m_elPatch.push_back(k);
+            low.insert(low.end(), domIt->lowerCorner().data(),
+                       domIt->lowerCorner().data() + pdim);
+            upp.insert(upp.end(), domIt->upperCorner().data(),
+                       domIt->upperCorner().data() + pdim);
+        }
+    }
+    const index_t nEl = m_elPatch.size();
+    GISMO_ENSURE(nEl > 0, "The patches have no elements.");
+    m_elLow = gsAsConstMatrix<T>(low, pdim, nEl);
+    m_elUpp = gsAsConstMatrix<T>(upp, pdim, nEl);
+
+    computeElementBoxes();
+
+    // Build the hierarchy
+    m_order.resize(nEl);
+    for (index_t e = 0; e != nEl; ++e) m_order[e] = e;
+    m_nodes.clear();
+    m_nodes.reserve(2 * nEl);
+    m_nodeLow.resize(m_boxLow.rows(), 2 * nEl);
+    m_nodeUpp.resize(m_boxLow.rows(), 2 * nEl);
+    buildNode(0, nEl);
+    m_nodeLow.conservativeResize(gsEigen::NoChange, m_nodes.size());
+    m_nodeUpp.conservativeResize(gsEigen::NoChange, m_nodes.size());
+}
+
+template<class T>
+void gsPointLocator<T>::refit()
+{
+    computeElementBoxes();
+    refitNodes();
+}
+
+template<class T>
+void gsPointLocator<T>::computeElementBoxes()
+{
+    const index_t nEl = m_elPatch.size();
+    const short_t gdim = m_patches.front()->geoDim();
+    m_boxLow.resize(gdim, nEl);
+    m_boxUpp.resize(gdim, nEl);
+
+#   pragma omp parallel
+    {
+        gsMatrix<index_t> act;
+        gsMatrix<T> center;
+#       pragma omp for
+        for (index_t e = 0; e < nEl; ++e)
+        {
+            // Bounding box of the control points acting on the element
+            const gsGeometry<T> & geo = *m_patches[m_elPatch[e]];
+            center = (m_elLow.col(e) + m_elUpp.col(e)) / 2;
+            geo.basis().active_into(center, act);
+            m_boxLow.col(e) = geo.coef(act(0,0)).transpose();
+            m_boxUpp.col(e) = m_boxLow.col(e);
+            for (index_t i = 1; i < act.rows(); ++i)
+            {
+                m_boxLow.col(e) = m_boxLow.col(e).cwiseMin(geo.coef(act(i,0)).transpose());
+                m_boxUpp.col(e) = m_boxUpp.col(e).cwiseMax(geo.coef(act(i,0)).transpose());
+            }
+        }
+    }
+}
+
+template<class T>
+index_t gsPointLocator<T>::buildNode(index_t first, index_t last)
+{
+    const index_t id = m_nodes.size();
+    m_nodes.push_back(Node());
+    const index_t count = last - first;
+
+    // Bounds of the boxes and of their centers
+    m_nodeLow.col(id) = m_boxLow.col(m_order[first]);
+    m_nodeUpp.col(id) = m_boxUpp.col(m_order[first]);
+    gsVector<T> cLow = m_nodeLow.col(id) + m_nodeUpp.col(id), cUpp = cLow;
+    for (index_t i = first + 1; i < last; ++i)
+    {
+        const index_t e = m_order[i];
+        m_nodeLow.col(id) = m_nodeLow.col(id).cwiseMin(m_boxLow.col(e));
+        m_nodeUpp.col(id) = m_nodeUpp.col(id).cwiseMax(m_boxUpp.col(e));
+        cLow = cLow.cwiseMin(m_boxLow.col(e) + m_boxUpp.col(e));
+        cUpp = cUpp.cwiseMax(m_boxLow.col(e) + m_boxUpp.col(e));
+    }
+
+    index_t axis;
+    if (count <= 4 || 0 == (cUpp - cLow).maxCoeff(&axis))
+    {
+        m_nodes[id].first = first;
+        m_nodes[id].count = count;
+        m_nodes[id].right = -1;
+        return id;
+    }
+
+    // Split at the median of the centers along the widest direction
+    const index_t mid = first + count / 2;
+    const gsMatrix<T> & bl = m_boxLow, & bu = m_boxUpp;
+    std::nth_element(m_order.begin() + first, m_order.begin() + mid,
+                     m_order.begin() + last,
+                     [&bl, &bu, axis](index_t a, index_t b)
+                     { return bl(axis,a) + bu(axis,a) < bl(axis,b) + bu(axis,b); });
+
+    m_nodes[id].first = first;
+    m_nodes[id].count = 0;
+    buildNode(first, mid);
+    m_nodes[id].right = buildNode(mid, last);
+    return id;
+}
+
+template<class T>
+void gsPointLocator<T>::refitNodes()
+{
+    // Children are stored after their parents
+    for (index_t id = m_nodes.size() - 1; id >= 0; --id)
+    {
+        const Node & n = m_nodes[id];
+        if (n.count)
+        {
+            m_nodeLow.col(id) = m_boxLow.col(m_order[n.first]);
+            m_nodeUpp.col(id) = m_boxUpp.col(m_order[n.first]);
+            for (index_t i = n.first + 1; i < n.first + n.count; ++i)
+            {
+                m_nodeLow.col(id) = m_nodeLow.col(id).cwiseMin(m_boxLow.col(m_order[i]));
+                m_nodeUpp.col(id) = m_nodeUpp.col(id).cwiseMax(m_boxUpp.col(m_order[i]));
+            }
+        }
+        else
+        {
+            m_nodeLow.col(id) = m_nodeLow.col(id+1).cwiseMin(m_nodeLow.col(n.right));
+            m_nodeUpp.col(id) = m_nodeUpp.col(id+1).cwiseMax(m_nodeUpp.col(n.right));
+        }
+    }
+}
+
+template<class T>
+gsMatrix<T> gsPointLocator<T>::boundingBox() const
+{
+    gsMatrix<T> result(m_nodeLow.rows(), 2);
+    result.col(0) = m_nodeLow.col(0);
+    result.col(1) = m_nodeUpp.col(0);
+    return result;
+}
+
+template<class T>
+T gsPointLocator<T>::solveOn(const index_t k, const gsVector<T> & pt,
+                             gsVector<T> & u, const T accuracy) const
+{
+    m_patches[k]->closestPointTo(pt, u, accuracy, true);
+    return (m_patches[k]->eval(u) - pt).norm();
+}
+
+template<class T>
+T gsPointLocator<T>::query(const gsVector<T> & pt, index_t & pid,
+                           gsVector<T> & preim, const T accuracy) const
+{
+    T best = std::numeric_limits<T>::infinity();
+    if (pid >= 0 && pid < static_cast<index_t>(m_patches.size())
+        && preim.rows() == m_elLow.rows())
+        best = solveOn(pid, pt, preim, accuracy);
+    else
+        pid = -1;
+
+    // Nearest-first traversal, skipping boxes farther than the best point
+    gsVector<T> u;
+    std::vector<std::pair<T,index_t> > stack;
+    stack.push_back(std::make_pair(T(0), index_t(0)));
+    while (!stack.empty())
+    {
+        const std::pair<T,index_t> top = stack.back();
+        stack.pop_back();
+        if (top.first >= best * best) continue;
+
+        const Node & n = m_nodes[top.second];
+        if (n.count)
+        {
+            for (index_t i = n.first; i < n.first + n.count; ++i)
+            {
+                const index_t e = m_order[i];
+                if (internal::boxDistance2<T>(pt, m_boxLow.col(e), m_boxUpp.col(e)) >= best * best)
+                    continue;
+
+                // The current point is the minimum in this element
+                const index_t k = m_elPatch[e];
+                if (k == pid && (preim.array() >= m_elLow.col(e).array()).all()
+                    && (preim.array() <= m_elUpp.col(e).array()).all())
+                    continue;
+
+                u = (m_elLow.col(e) + m_elUpp.col(e)) / 2;
+                const T d = solveOn(k, pt, u, accuracy);
+                if (d < best)
+                {
+                    best = d;
+                    pid  = k;
+                    preim.swap(u);
+                }
+            }
+        }
+        else
+        {
+            const index_t l = top.second + 1, r = n.right;
+            const T dl = internal::boxDistance2<T>(pt, m_nodeLow.col(l), m_nodeUpp.col(l));
+            const T dr = internal::boxDistance2<T>(pt, m_nodeLow.col(r), m_nodeUpp.col(r));
+            if (dl < dr)
+            {
+                stack.push_back(std::make_pair(dr, r));
+                stack.push_back(std::make_pair(dl, l));
+            }
+            else
+            {
+                stack.push_back(std::make_pair(dl, l));
+                stack.push_back(std::make_pair(dr, r));
+            }
+        }
+    }
+    return best;
+}
+
+template<class T>
+T gsPointLocator<T>::closestPoint(const gsVector<T> & pt, index_t & pid,
+                                  gsVector<T> & preim, const T accuracy) const
+{
+    GISMO_ASSERT(pt.rows() == m_nodeLow.rows(), "Invalid input point.");
+    return query(pt, pid, preim, accuracy);
+}
+
+template<class T>
+uint64_t gsPointLocator<T>::mortonCode(const gsVector<T> & pt,
+                                       const gsMatrix<T> & box) const
+{
+    const index_t d = pt.rows();
+    const index_t bits = math::min(index_t(63) / d, index_t(21));
+    const T scale = static_cast<T>( (uint64_t(1) << bits) - 1 );
+    uint64_t result = 0;
+    for (index_t i = 0; i != d; ++i)
+    {
+        const T w = box(i,1) - box(i,0);
+        T t = (w > 0 ? (pt[i] - box(i,0)) / w : T(0));
+        t = math::min(math::max(t, T(0)), T(1));
+        const uint64_t q = static_cast<uint64_t>(cast<T,double>(t * scale));
+        for (index_t b = 0; b != bits; ++b)
+            result |= ((q >> b) & 1) << (b * d + i);
+    }
+    return result;
+}
+
+template<class T>
+void gsPointLocator<T>::closestPoints(const gsMatrix<T> & points,
+                                      gsVector<index_t> & pids,
+                                      gsMatrix<T> & preim, gsVector<T> & dist,
+                                      const T accuracy) const
+{
+    GISMO_ASSERT(points.rows() == m_nodeLow.rows(), "Invalid input points.");
+    const index_t n = points.cols();
+    pids.resize(n);
+    preim.resize(m_elLow.rows(), n);
+    dist.resize(n);
+
+    // Sort the points along a space filling curve, so that
+    // consecutive queries are close to each other
+    const gsMatrix<T> box = boundingBox();
+    std::vector<std::pair<uint64_t,index_t> > order(n);
+#   pragma omp parallel for
+    for (index_t i = 0; i < n; ++i)
+        order[i] = std::make_pair(mortonCode(points.col(i), box), i);
+    std::sort(order.begin(), order.end());
+
+    // Process chunks of consecutive points, warm-starting each query
+    // from the previous result
+    const index_t chunk = 64;
+#   pragma omp parallel for schedule(dynamic)
+    for (index_t c = 0; c < n; c += chunk)
+    {
+        index_t pid = -1;
+        gsVector<T> pt, u;
+        for (index_t i = c; i < math::min(c + chunk, n); ++i)
+        {
+            const index_t j = order[i].second;
+            pt = points.col(j);
+            dist[j] = query(pt, pid, u, accuracy);
+            pids[j] = pid;
+            preim.col(j) = u;
+        }
+    }
+}
+
+template<class T>
+void gsPointLocator<T>::invertPoints(const gsMatrix<T> & points,
+                                     gsVector<index_t> & pids,
+                                     gsMatrix<T> & preim,
+                                     const T accuracy) const
+{
+    gsVector<T> dist;
+    closestPoints(points, pids, preim, dist, accuracy);
+    for (index_t i = 0; i != dist.size(); ++i)
+        if (dist[i] > accuracy)
+        {
+            pids[i] = -1;
+            preim.col(i).setConstant(std::numeric_limits<T>::infinity());
+        }
+}
+
+} // namespace gismo
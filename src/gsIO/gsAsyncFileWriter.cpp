@@ -0,0 +1,91 @@
+/** @file gsAsyncFileWriter.cpp
+
+    @brief Background thread executing file-writing jobs in order.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gsIO/gsAsyncFileWriter.h>
+
+namespace gismo
+{
+
+gsAsyncFileWriter::gsAsyncFileWriter(size_t capacity)
+: m_capacity(capacity > 0 ? capacity : 1), m_busy(false), m_stop(false)
+{ }
+
+gsAsyncFileWriter::~gsAsyncFileWriter()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_hasJob.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();
+
+    if (m_error)
+        gsWarn << "gsAsyncFileWriter: a file could not be written.\n";
+}
+
+void gsAsyncFileWriter::push(Job job)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable())
+        m_thread = std::thread(&gsAsyncFileWriter::run, this);
+
+    m_hasRoom.wait(lock, [this] { return m_queue.size() < m_capacity; });
+    m_queue.push_back(give(job));
+    lock.unlock();
+    m_hasJob.notify_one();
+}
+
+void gsAsyncFileWriter::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_hasRoom.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+    if (m_error)
+    {
+        std::exception_ptr error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void gsAsyncFileWriter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_hasJob.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+        // Pending jobs are always completed before stopping
+        if (m_queue.empty())
+            return;
+
+        Job job = give(m_queue.front());
+        m_queue.pop_front();
+        m_busy = true;
+        lock.unlock();
+        m_hasRoom.notify_all();
+
+        try { job(); }
+        catch (...)
+        {
+            lock.lock();
+            if (!m_error) m_error = std::current_exception();
+            lock.unlock();
+        }
+
+        lock.lock();
+        m_busy = false;
+        m_hasRoom.notify_all();
+    }
+}
+
+} // namespace gismo
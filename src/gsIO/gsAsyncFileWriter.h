@@ -0,0 +1,83 @@
+/** @file gsAsyncFileWriter.h
+
+    @brief Background thread executing file-writing jobs in order.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsForwardDeclarations.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace gismo
+{
+
+/**
+    \brief Executes file-writing jobs on a single background (I/O)
+    thread, in the order they were submitted.
+
+    Jobs are kept in a bounded queue: push() blocks while the queue is
+    full, so that a fast producer cannot accumulate an unbounded amount
+    of pending output in memory. The thread is started on the first
+    push().
+
+    Jobs must own all the data they need (e.g. capture by value),
+    since they are executed after push() returns.
+
+    \ingroup IO
+*/
+class GISMO_EXPORT gsAsyncFileWriter
+{
+public:
+    typedef std::function<void()> Job;
+
+    /// Constructor, \a capacity is the maximum number of pending jobs
+    explicit gsAsyncFileWriter(size_t capacity = 16);
+
+    /// Destructor, waits for all pending jobs to finish
+    ~gsAsyncFileWriter();
+
+    /// Appends \a job to the queue, blocks while the queue is full
+    void push(Job job);
+
+    /// Blocks until all submitted jobs are executed. If a job has
+    /// thrown, the exception is re-thrown here.
+    void wait();
+
+    /// Returns the maximum number of pending jobs
+    size_t capacity() const { return m_capacity; }
+
+private:
+    gsAsyncFileWriter(const gsAsyncFileWriter &);
+    gsAsyncFileWriter & operator=(const gsAsyncFileWriter &);
+
+    void run();
+
+private:
+    std::deque<Job> m_queue;
+    size_t m_capacity;
+    bool m_busy;  // a job is being executed
+    bool m_stop;
+
+    std::mutex m_mutex;
+    std::condition_variable m_hasJob;
+    std::condition_variable m_hasRoom;
+
+    std::exception_ptr m_error;
+    std::thread m_thread;
+};
+
+} // namespace gismo
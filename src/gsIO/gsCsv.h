@@ -1,6 +1,6 @@
 /** @file gsCsv.h
 
-    @brief Provides functions writing .csv files.
+    @brief Provides functions reading and writing .csv files.
 
     This file is part of the G+Smo library.
 
@@ -12,6 +12,7 @@
 */
 
 #include <gsCore/gsForwardDeclarations.h>
+#include <gsIO/gsMappedFile.h>
 
 #include <fstream>
 
@@ -54,5 +55,46 @@ void gsWriteCsv(std::string const & filename, const gsMatrix<T> & matrix, const
     csv_file.close();
 }
 
+/// @brief Reads the next rows of numbers of a .csv (comma separated
+/// values) stream, allowing to process large files in chunks
+/// @tparam T
+/// @param is input stream, positioned at the first row to read
+/// @param result on output, the rows which were read. The number of
+/// columns is taken from the first row
+/// @param maxRows maximum number of rows to read
+/// @return the number of rows read, zero at the end of the stream
+///
+/// Lines which do not start with a number, such as headers, are skipped.
+///
+/// \ingroup IO
+template<class T>
+index_t gsReadCsvRows(std::istream & is, gsMatrix<T> & result, const index_t maxRows)
+{
+    std::string line;
+    std::vector<T> row;
+    index_t numRows = 0;
+    while (numRows < maxRows && std::getline(is, line))
+    {
+        const char * p = line.data(), * end = p + line.size();
+        row.clear();
+        T val;
+        while (internal::parseReal(p, end, val))
+        {
+            row.push_back(val);
+            internal::skipBlanks(p, end);
+            if (p != end && ',' == *p) ++p;
+        }
+        if (row.empty()) continue; // header or empty line
+
+        if (0 == numRows)
+            result.resize(maxRows, row.size());
+        GISMO_ENSURE(static_cast<index_t>(row.size()) == result.cols(),
+                     "Inconsistent number of columns in .csv row: "<< line);
+        result.row(numRows++) = gsAsConstVector<T>(row).transpose();
+    }
+    result.conservativeResize(numRows, gsEigen::NoChange);
+    return numRows;
+}
+
 
 } // namespace gismo
@@ -0,0 +1,107 @@
+/** @file gsMappedFile.cpp
+
+    @brief Read-only memory mapped file and fast parsing of numbers
+    from a character buffer.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gsIO/gsMappedFile.h>
+#include <fstream>
+
+#if defined _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gismo
+{
+
+gsMappedFile::gsMappedFile(const std::string & fn)
+: m_data(NULL), m_size(0), m_mapped(false)
+{
+#if defined _WIN32
+    HANDLE file = CreateFileA(fn.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (INVALID_HANDLE_VALUE != file)
+    {
+        LARGE_INTEGER sz;
+        if (GetFileSizeEx(file, &sz) && sz.QuadPart > 0)
+        {
+            HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (NULL != map)
+            {
+                m_data = static_cast<const char*>(MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0));
+                if (m_data)
+                {
+                    m_size = static_cast<size_t>(sz.QuadPart);
+                    m_mapped = true;
+                }
+                CloseHandle(map); // the view keeps the mapping alive
+            }
+        }
+        CloseHandle(file);
+    }
+#else
+    const int fd = ::open(fn.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (0 == ::fstat(fd, &st) && st.st_size > 0)
+        {
+            void * addr = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (MAP_FAILED != addr)
+            {
+                m_data = static_cast<const char*>(addr);
+                m_size = static_cast<size_t>(st.st_size);
+                m_mapped = true;
+#               if defined(MADV_SEQUENTIAL)
+                ::madvise(addr, m_size, MADV_SEQUENTIAL);
+#               endif
+            }
+        }
+        ::close(fd); // the mapping stays valid
+    }
+#endif
+
+    if (m_mapped) return;
+
+    // Fallback: read the file into a buffer
+    std::ifstream in(fn.c_str(), std::ios::in | std::ios::binary);
+    if (!in) return;
+    in.seekg(0, std::ios::end);
+    const std::streamoff sz = in.tellg();
+    if (sz <= 0) return;
+    in.seekg(0);
+    char * buf = new char[static_cast<size_t>(sz)];
+    if (in.read(buf, sz))
+    {
+        m_data = buf;
+        m_size = static_cast<size_t>(sz);
+    }
+    else
+        delete[] buf;
+}
+
+gsMappedFile::~gsMappedFile()
+{
+    if (NULL == m_data) return;
+#if defined _WIN32
+    if (m_mapped) { UnmapViewOfFile(m_data); return; }
+#else
+    if (m_mapped) { ::munmap(const_cast<char*>(m_data), m_size); return; }
+#endif
+    delete[] m_data;
+}
+
+} // namespace gismo
@@ -0,0 +1,169 @@
+/** @file gsMappedFile.h
+
+    @brief Read-only memory mapped file and fast parsing of numbers
+    from a character buffer.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsForwardDeclarations.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace gismo
+{
+
+/**
+    \brief Maps a file to memory (read-only), so that it can be parsed
+    in place without copying it through streams.
+
+    On platforms without memory mapping the file is read into a buffer.
+    The data is not null-terminated, use data() and size().
+
+    \ingroup IO
+*/
+class GISMO_EXPORT gsMappedFile
+{
+public:
+    /// Maps the file \a fn, check isOpen() for success
+    explicit gsMappedFile(const std::string & fn);
+
+    ~gsMappedFile();
+
+    /// True if the file could be mapped
+    bool isOpen() const { return NULL != m_data; }
+
+    /// Pointer to the contents of the file
+    const char * data() const { return m_data; }
+
+    /// Pointer past the end of the contents
+    const char * end() const { return m_data + m_size; }
+
+    /// Size of the file in bytes
+    size_t size() const { return m_size; }
+
+private:
+    gsMappedFile(const gsMappedFile &);
+    gsMappedFile & operator=(const gsMappedFile &);
+
+private:
+    const char * m_data;
+    size_t m_size;
+    bool m_mapped; // false: m_data is an allocated buffer
+};
+
+namespace internal
+{
+
+/// Advances \a p over blanks (but not over line ends)
+inline void skipBlanks(const char *& p, const char * end)
+{ while (p != end && (' ' == *p || '\t' == *p || '\r' == *p)) ++p; }
+
+/// Advances \a p over white space, including line ends
+inline void skipSpace(const char *& p, const char * end)
+{ while (p != end && (' ' == *p || '\t' == *p || '\r' == *p || '\n' == *p)) ++p; }
+
+/// Advances \a p past the end of the current line
+inline void skipLine(const char *& p, const char * end)
+{
+    const char * nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    p = (nl ? nl + 1 : end);
+}
+
+/// Advances \a p to the beginning of the next line which is neither
+/// blank nor a comment (starting with \a comment)
+inline void skipEmptyLines(const char *& p, const char * end, char comment = '#')
+{
+    for (;;)
+    {
+        skipSpace(p, end);
+        if (p == end || *p != comment) return;
+        skipLine(p, end);
+    }
+}
+
+/// Parses an integer at \a p (after white space), advancing \a p.
+/// Returns false if no digits are found.
+template<class I>
+bool parseInt(const char *& p, const char * end, I & result)
+{
+    skipBlanks(p, end);
+    bool neg = false;
+    if (p != end && ('-' == *p || '+' == *p)) neg = ('-' == *p++);
+    const char * start = p;
+    I v = 0;
+    for (; p != end && *p >= '0' && *p <= '9'; ++p)
+        v = 10 * v + static_cast<I>(*p - '0');
+    result = (neg ? -v : v);
+    return p != start;
+}
+
+/// Parses a real number at \a p (after white space), advancing \a p.
+/// Decimal numbers with at most 19 significant digits and a small
+/// exponent are converted directly (with correct rounding), other
+/// cases fall back to strtod. Returns false if no number is found.
+template<class T>
+bool parseReal(const char *& p, const char * end, T & result)
+{
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+        1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+        1e19, 1e20, 1e21, 1e22};
+
+    skipBlanks(p, end);
+    const char * start = p;
+    bool neg = false;
+    if (p != end && ('-' == *p || '+' == *p)) neg = ('-' == *p++);
+
+    uint64_t mant = 0;
+    int digits = 0, exp10 = 0;
+    bool any = false;
+    for (; p != end && *p >= '0' && *p <= '9'; ++p, any = true)
+        if (digits < 19) { mant = 10 * mant + (*p - '0'); if (mant) ++digits; }
+        else ++exp10;
+    if (p != end && '.' == *p)
+        for (++p; p != end && *p >= '0' && *p <= '9'; ++p, any = true)
+            if (digits < 19) { mant = 10 * mant + (*p - '0'); if (mant) ++digits; --exp10; }
+    if (!any) { p = start; return false; }
+
+    bool exact = (digits < 19);
+    if (p != end && ('e' == *p || 'E' == *p))
+    {
+        const char * ep = ++p;
+        int e = 0;
+        if (parseInt(p, end, e))
+            exp10 += e;
+        else
+            p = ep - 1; // not an exponent
+    }
+
+    // Fast path: both the mantissa and the power of ten are exact doubles
+    if (exact && mant < (uint64_t(1) << 53) && exp10 >= -22 && exp10 <= 22)
+    {
+        double v = static_cast<double>(mant);
+        v = (exp10 < 0 ? v / pow10[-exp10] : v * pow10[exp10]);
+        result = static_cast<T>(neg ? -v : v);
+        return true;
+    }
+
+    // Slow path, on a null-terminated copy of the token
+    char buf[64];
+    const size_t len = std::min<size_t>(p - start, sizeof(buf) - 1);
+    std::memcpy(buf, start, len);
+    buf[len] = '\0';
+    result = static_cast<T>(std::strtod(buf, NULL));
+    return true;
+}
+
+} // namespace internal
+
+} // namespace gismo
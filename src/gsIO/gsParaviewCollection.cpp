@@ -84,7 +84,8 @@ namespace gismo
 
         name += "_t" + std::to_string( cast<real_t, double>( time ) );
        
-        m_dataset = gsParaviewDataSet(name, geometry, m_evaluator, m_options);
+        gsAsyncFileWriter * writer = m_options.askSwitch("asyncWrite", false) ? &m_writer : nullptr;
+        m_dataset = gsParaviewDataSet(name, geometry, m_evaluator, m_options, writer);
     }
 }
 
@@ -49,6 +49,11 @@ namespace gismo {
     pc.options().setInt("precision",5);
     pc.options().setSwitch("plotElements",true);
     pc.options().setSwitch("plotControlNet",true);
+    // Stream binary (zlib-compressed) data instead of ascii text
+    pc.options().setSwitch("appended",true);
+    pc.options().setSwitch("compress",true);
+    // Overlap the file output with the computation
+    pc.options().setSwitch("asyncWrite",true);
 
     // In your solution loop:
     while ( ... )
@@ -87,7 +92,8 @@ public:
                         m_time(-1),
                         m_evaluator(evaluator),
                         m_options(gsParaviewDataSet::defaultOptions()),
-                        counter(0)
+                        counter(0),
+                        m_writer(4)
     {
         std::string path = gsFileManager::getPath(m_filename);
 
@@ -205,6 +211,9 @@ public:
         GISMO_ASSERT(!m_isSaved, "Error: gsParaviewCollection::save() already called." );
         if (!m_isSaved)
         {
+            // Join all outstanding (background) writes
+            m_writer.wait();
+
             mfile <<"</Collection>\n";
             mfile <<"</VTKFile>\n";
 
@@ -242,6 +251,10 @@ private:
 
     index_t counter;
 
+    /// Background writer, used if the option "asyncWrite" is set. At most
+    /// a few pieces are pending, to keep the memory bounded
+    gsAsyncFileWriter m_writer;
+
 private:
     // Construction without a filename is not allowed
     gsParaviewCollection();
@@ -15,22 +15,28 @@
 #include<gsIO/gsWriteParaview.h>
 #include<gsIO/gsParaviewUtils.h>
 
+#include<cstdio>
+
 namespace gismo
 {
     gsParaviewDataSet::gsParaviewDataSet(std::string basename,
                     gsMultiPatch<real_t> * const geometry,
                     gsExprEvaluator<real_t> * eval,
-                    gsOptionList options)
+                    gsOptionList options,
+                    gsAsyncFileWriter * writer)
                     :m_basename(basename),
                     m_geometry(geometry),
                     m_evaltr(eval),
                     m_options(options),
-                    m_isSaved(false)
+                    m_isSaved(false),
+                    m_writer(writer)
     {
         const unsigned nPts = m_options.askInt("numPoints", 1000);
 
         // Check if binary output is required
-        const bool export_base64 = m_options.askSwitch("base64", true);
+        const bool export_appended = m_options.askSwitch("appended", false);
+        const bool export_base64 = export_appended || m_options.askSwitch("base64", true);
+        const bool compress = export_appended && m_options.askSwitch("compress", false);
         const bool is_little_endian = []() -> bool {
             // Check if current system is running in little endian (most likely)
             const int n{1};
@@ -51,24 +57,42 @@ namespace gismo
 
             // initializes individual .vts files
             // for every patch
-            std::ofstream file(m_filenames[k].c_str());
-            file << std::fixed;            // no exponents
-            file << std::setprecision(5);  // PLOT_PRECISION
-            file << "<?xml version=\"1.0\"?>\n";
-            file << "<VTKFile type=\"StructuredGrid\" version=\"0.1\"";
+            std::stringstream header;
+            header << std::fixed;            // no exponents
+            header << std::setprecision(5);  // PLOT_PRECISION
+            header << "<?xml version=\"1.0\"?>\n";
+            header << "<VTKFile type=\"StructuredGrid\" version=\"0.1\"";
             if (export_base64) {
-                file << " byte_order=\""
-                     << (is_little_endian ? "LittleEndian" : "BigEndian")
-                     << "\" header_type=\"UInt64\"";
+                header << " byte_order=\""
+                       << (is_little_endian ? "LittleEndian" : "BigEndian")
+                       << "\" header_type=\"UInt64\"";
+                if (compress)
+                    header << " compressor=\"vtkZLibDataCompressor\"";
             }
-            file << ">\n";
-            file << "<StructuredGrid WholeExtent=\"0 " << np(0) - 1 << " 0 "
-                 << np1 << " 0 " << np2 << "\">\n";
-            file << "<Piece Extent=\"0 " << np(0) - 1 << " 0 " << np1 << " 0 "
-                 << np2 << "\">\n";
-            file << "<PointData>\n";
-            file.close();
+            header << ">\n";
+            header << "<StructuredGrid WholeExtent=\"0 " << np(0) - 1 << " 0 "
+                   << np1 << " 0 " << np2 << "\">\n";
+            header << "<Piece Extent=\"0 " << np(0) - 1 << " 0 " << np1 << " 0 "
+                   << np2 << "\">\n";
+            header << "<PointData>\n";
+
+            const std::string fn = m_filenames[k], rawFn = rawFilename(k);
+            const std::string xml = header.str();
+            auto job = [fn, rawFn, xml, export_appended]()
+            {
+                // Binary mode, the appended data must not be altered by
+                // newline conversions
+                std::ofstream file(fn.c_str(), std::ios_base::out |
+                                   std::ios_base::binary | std::ios_base::trunc);
+                GISMO_ENSURE(file.is_open(), "Cannot open "<< fn <<" for writing.");
+                file << xml;
+                if (export_appended) // Start an empty binary payload
+                    std::ofstream(rawFn.c_str(), std::ios_base::out |
+                                  std::ios_base::binary | std::ios_base::trunc);
+            };
+            if (m_writer) m_writer->push(give(job)); else job();
         }
+        m_offsets.assign(m_geometry->nPieces(), 0);
     }
 
     
@@ -86,27 +110,44 @@ namespace gismo
             m_isSaved = true;
 
             const unsigned nPts = m_options.askInt("numPoints", 1000);
-            const unsigned precision = m_options.askInt("precision", 5);
             const bool plotElements = m_options.askSwitch("plotElements", false);
             const bool plotControlNet = m_options.askSwitch("plotControlNet", false);
-            const bool export_base64 = m_options.askSwitch("base64", false);
+            const bool appended = m_options.askSwitch("appended", false);
+            const bool compress = appended && m_options.askSwitch("compress", false);
+
+            const index_t nPieces = m_geometry->nPieces();
+
+            // Transform points into strings for export, a chunk of
+            // patches at a time to bound the memory
+            const index_t chunk = omp_get_max_threads();
+            std::vector<std::string> points(chunk), raw(chunk);
+            for ( index_t k0=0; k0 < nPieces; k0 += chunk)
+            {
+                const index_t nk = std::min(chunk, nPieces - k0);
+#pragma omp parallel for
+                for ( index_t i=0; i < nk; i++)
+                {
+                    gsMatrix<real_t> xyzPoints;
+                    sampleOnGrid(*m_geometry, k0 + i, nPts, xyzPoints);
+                    if (xyzPoints.rows() < 3)
+                        // Pad matrix with zeros
+                        xyzPoints.conservativeResizeLike(gsEigen::MatrixXd::Zero(3,xyzPoints.cols()));
+                    points[i] = dataArray(k0 + i, xyzPoints, "", raw[i]);
+                }
 
-            // Transform points into strings for export
-            const std::vector<std::string> points =
-                toVTK(*m_geometry, nPts, precision, "", export_base64);
+                for ( index_t i=0; i < nk; i++)
+                    appendToPiece(k0 + i, "</PointData>\n\n\n<!-- GEOMETRY -->\n<Points>\n"
+                                  + points[i] + "</Points>\n</Piece>\n</StructuredGrid>\n",
+                                  give(raw[i]), true);
+            }
 
             // QUESTION: Can I be certain that the ids are consecutive?
-            for ( index_t k=0; k!=m_geometry->nPieces(); k++) // For every patch.
+            for ( index_t k=0; k!=nPieces; k++) // For every patch.
             {
-                std::ofstream file;
-                file.open(m_filenames[k].c_str(), std::ios_base::app); // Append to file 
-                file <<"</PointData>\n\n\n<!-- GEOMETRY -->\n<Points>\n";
-                file << points[k];
-                file << "</Points>\n</Piece>\n</StructuredGrid>\n</VTKFile>";
-                file.close();
                 if (plotControlNet)
                 {
-                    writeSingleControlNet( m_geometry->piece(k), m_basename + "_cnet" + std::to_string(k));
+                    writeSingleControlNet( m_geometry->piece(k), m_basename + "_cnet" + std::to_string(k),
+                                           appended, compress);
                     m_filenames.push_back( m_basename + "_cnet" + std::to_string(k)+".vtp");
                 } 
                 if ( plotElements)
@@ -124,7 +165,10 @@ namespace gismo
                     //gsMesh<real_t> msh( gsMultiBasis<real_t>(*m_geometry).basis(k), numPoints);
                     gsMesh<real_t> msh( m_evaltr->exprData()->multiBasis().basis(k), numPoints);
                     static_cast<const gsGeometry<real_t>&>(m_geometry->piece(k)).evaluateMesh(msh);
-                    gsWriteParaview(msh, m_basename + "_mesh" + std::to_string(k), false);
+                    if (appended)
+                        gsWriteParaviewAppended(msh, m_basename + "_mesh" + std::to_string(k), compress);
+                    else
+                        gsWriteParaview(msh, m_basename + "_mesh" + std::to_string(k), false);
                     m_filenames.push_back( m_basename + "_mesh" + std::to_string(k)+".vtp");
                 }
             }
@@ -142,6 +186,75 @@ namespace gismo
         return m_isSaved;
     }
 
+    std::string gsParaviewDataSet::dataArray(index_t k,
+                                             const gsMatrix<real_t> & values,
+                                             const std::string & label,
+                                             std::string & raw)
+    {
+        std::map<std::string, std::string> attributes;
+        if (""!=label)
+            attributes["Name"] = label;
+        else
+            attributes[""] = "";
+
+        raw.clear();
+        if (m_options.askSwitch("appended", false))
+            return toAppendedDataArray(values, raw, m_offsets[k], attributes,
+                                       m_options.askSwitch("compress", false));
+
+        return toDataArray(values, attributes,
+                           m_options.askInt("precision", 5),
+                           m_options.askSwitch("base64", false));
+    }
+
+    namespace
+    {
+    // Appends xml and binary data to the files of a piece. The data is
+    // owned (moved in), so that the job can run after the caller returns.
+    struct pieceAppendJob
+    {
+        std::string fn, rawFn, xml, raw;
+        bool appended, close;
+
+        void operator()() const
+        {
+            if (!raw.empty())
+            {
+                std::ofstream rawFile(rawFn.c_str(), std::ios_base::app | std::ios_base::binary);
+                GISMO_ENSURE(rawFile.is_open(), "Cannot open "<< rawFn <<" for writing.");
+                rawFile.write(raw.data(), raw.size());
+            }
+
+            std::ofstream file(fn.c_str(), std::ios_base::app |
+                               std::ios_base::binary); // Append to file
+            GISMO_ENSURE(file.is_open(), "Cannot open "<< fn <<" for writing.");
+            file << xml;
+            if (close)
+            {
+                if (appended)
+                {
+                    writeAppendedData(file, rawFn);
+                    std::remove(rawFn.c_str());
+                }
+                file << "</VTKFile>";
+            }
+        }
+    };
+    }
+
+    void gsParaviewDataSet::appendToPiece(index_t k, std::string xml,
+                                          std::string raw, bool close)
+    {
+        pieceAppendJob job;
+        job.fn       = m_filenames[k];
+        job.rawFn    = rawFilename(k);
+        job.xml      = give(xml);
+        job.raw      = give(raw);
+        job.appended = m_options.askSwitch("appended", false);
+        job.close    = close;
+        if (m_writer) m_writer->push(give(job)); else job();
+    }
+
     void gsParaviewDataSet::initFilenames()
     {   
         std::vector<std::string> names;
@@ -20,6 +20,7 @@
 #include <gsAssembler/gsExprEvaluator.h>
 #include <gsIO/gsIOUtils.h>
 #include <gsIO/gsParaviewUtils.h>
+#include <gsIO/gsAsyncFileWriter.h>
 
 #include<fstream>
 
@@ -43,6 +44,8 @@ private:
     gsExprEvaluator<real_t> * m_evaltr;
     gsOptionList m_options;
     bool m_isSaved;
+    std::vector<uint64_t> m_offsets; // Offsets inside the appended data, per patch
+    gsAsyncFileWriter * m_writer;
 
 public:
     /// @brief Basic constructor
@@ -50,16 +53,20 @@ public:
     /// @param geometry A gsMultiPatch of the geometry that will be exported and where the fields are defined
     /// @param eval Optional. A gsExprEvaluator, necessary when working with gsExpressions for evaluation purposes
     /// @param options A set of options, if unspecified, defaultOptions() is called.
+    /// @param writer Optional. A background writer, if given all files are
+    /// written asynchronously through it. It must outlive the pending writes.
     gsParaviewDataSet(std::string basename,
                       gsMultiPatch<real_t> * const geometry,
                       gsExprEvaluator<real_t> * eval=nullptr,
-                      gsOptionList options=defaultOptions());
+                      gsOptionList options=defaultOptions(),
+                      gsAsyncFileWriter * writer=nullptr);
 
     gsParaviewDataSet():m_basename(""),
                         m_geometry(nullptr),
                         m_evaltr(nullptr),
                         m_options(defaultOptions()),
-                        m_isSaved(false)
+                        m_isSaved(false),
+                        m_writer(nullptr)
                         {}
 
     /// @brief Evaluates an expression, and writes that data to the vtk files.
@@ -74,23 +81,32 @@ public:
         // evaluates the expression and appends it to the vts files
         // for every patch
         const unsigned nPts = m_options.askInt("numPoints", 1000);
-        const unsigned precision = m_options.askInt("precision", 5);
-        const bool export_base64 = m_options.askSwitch("base64", false);
-
-        // gsExprEvaluator<real_t> ev;
-        // gsMultiBasis<real_t> mb(*m_geometry);
-        // ev.setIntegrationElements(mb);
-        const std::vector<std::string> tags =
-            toVTK(expr, m_evaltr, nPts, precision, label, export_base64);
-        std::vector<std::string> fnames = filenames();
-
-        for (index_t k = 0; k != m_geometry->nPieces();
-             k++)  // For every patch.
+        const index_t nPieces = m_geometry->nPieces();
+
+        // The evaluator is not thread-safe, hence the evaluation is
+        // sequential, while the formatting is done in parallel. This is
+        // done a chunk of patches at a time, to bound the memory
+        const index_t chunk = omp_get_max_threads();
+        std::vector<gsMatrix<real_t> > values(chunk);
+        std::vector<std::string> tags(chunk), raw(chunk);
+        for (index_t k0 = 0; k0 < nPieces; k0 += chunk)
         {
-            std::ofstream file;
-            file.open(fnames[k].c_str(), std::ios_base::app);  // Append to file
-            file << tags[k];
-            file.close();
+            const index_t nk = std::min(chunk, nPieces - k0);
+            for (index_t i = 0; i != nk; i++)
+            {
+                sampleOnGrid(expr, m_evaltr, k0 + i, nPts, values[i]);
+                GISMO_ASSERT(values[i].rows() <= 3, "The expression can be scalar or have at most 3 components.");
+                if (values[i].rows() == 2)
+                    // Pad matrix with zeros
+                    values[i].conservativeResizeLike(gsEigen::MatrixXd::Zero(3,values[i].cols()));
+            }
+
+#pragma omp parallel for
+            for (index_t i = 0; i < nk; i++)
+                tags[i] = dataArray(k0 + i, values[i], label, raw[i]);
+
+            for (index_t i = 0; i != nk; i++)
+                appendToPiece(k0 + i, give(tags[i]), give(raw[i]));
         }
     }
 
@@ -134,20 +150,24 @@ public:
         // evaluates the field  and appends it to the vts files
         // for every patch
         const unsigned nPts = m_options.askInt("numPoints", 1000);
-        const unsigned precision = m_options.askInt("precision", 5);
-        const bool export_base64 = m_options.askSwitch("base64", false);
+        const index_t nPieces = m_geometry->nPieces();
 
-        const std::vector<std::string> tags =
-            toVTK(field, nPts, precision, label, export_base64);
-        const std::vector<std::string> fnames = filenames();
-
-        for (index_t k = 0; k != m_geometry->nPieces();
-             k++)  // For every patch.
+        // A chunk of patches at a time, to bound the memory
+        const index_t chunk = omp_get_max_threads();
+        std::vector<std::string> tags(chunk), raw(chunk);
+        for (index_t k0 = 0; k0 < nPieces; k0 += chunk)
         {
-            std::ofstream file;
-            file.open(fnames[k].c_str(), std::ios_base::app);  // Append to file
-            file << tags[k];
-            file.close();
+            const index_t nk = std::min(chunk, nPieces - k0);
+#pragma omp parallel for
+            for (index_t i = 0; i < nk; i++)  // For every patch.
+            {
+                gsMatrix<T> values;
+                sampleOnGrid(field, k0 + i, nPts, values);
+                tags[i] = dataArray(k0 + i, values, label, raw[i]);
+            }
+
+            for (index_t i = 0; i != nk; i++)
+                appendToPiece(k0 + i, give(tags[i]), give(raw[i]));
         }
     }
 
@@ -185,6 +205,9 @@ public:
         opt.addInt("plotElements.resolution", "Drawing resolution for element mesh.", -1);
         opt.addSwitch("makeSubfolder", "Export vtk files to subfolder ( below the .pvd file ).", true);
         opt.addSwitch("base64", "Export in base64 binary format", false);
+        opt.addSwitch("appended", "Export in VTK appended raw binary format (streamed per patch, overrides base64), also for the element mesh and control net", false);
+        opt.addSwitch("compress", "Compress the appended binary data with zlib", false);
+        opt.addSwitch("asyncWrite", "Write the files in a background thread (used by gsParaviewCollection)", false);
         opt.addString("subfolder","Name of subfolder where the vtk files will be stored.", "");
         opt.addSwitch("plotElements", "Controls plotting of element mesh.", false);
         opt.addSwitch("plotControlNet", "Controls plotting of control point grid.", false);
@@ -196,5 +219,21 @@ public:
 private:
 
  void initFilenames();
+
+ /// Name of the temporary file collecting the appended data of patch \a k
+ std::string rawFilename(index_t k) const { return m_filenames[k] + ".raw"; }
+
+ /// Formats \a values of patch \a k as a <DataArray> tag, according to
+ /// the options. In appended mode the binary payload is stored in \a raw
+ /// (which is cleared first).
+ /// Different patches can be formatted concurrently.
+ std::string dataArray(index_t k, const gsMatrix<real_t> & values,
+                       const std::string & label, std::string & raw);
+
+ /// Appends \a xml (and the appended data \a raw) to the files of patch
+ /// \a k. If \a close is true, the file is finalized. The writing is
+ /// done by the background writer, if one is set.
+ void appendToPiece(index_t k, std::string xml, std::string raw,
+                    bool close = false);
 };
 } // End namespace gismo
@@ -13,8 +13,16 @@
 
 #include <gsIO/gsParaviewUtils.h>
 #include <fstream>
+#include <cstring>
 #include <iostream>
 
+#ifdef GISMO_ZLIB_STATIC
+#define Z_PREFIX
+#include <zlib/zlib.h> // bundled zlib
+#else
+#include <zlib.h>      // system zlib
+#endif
+
 #define VTK_BEZIER_QUADRILATERAL 77
 
 
@@ -82,6 +90,79 @@ namespace gismo
         return stream.str();
     }
 
+    uint64_t writeVtkBinaryBlock(std::string & out, const char * data,
+                                 uint64_t nbytes, bool compress)
+    {
+        if (!compress)
+        {
+            // Header: number of bytes, followed by the data
+            out.append(reinterpret_cast<const char*>(&nbytes), sizeof(uint64_t));
+            out.append(data, nbytes);
+            return sizeof(uint64_t) + nbytes;
+        }
+
+        // Layout of vtkZLibDataCompressor: [#blocks, blockSize,
+        // lastBlockSize, compressedSize_1, ..., compressedSize_#blocks]
+        // followed by the compressed blocks
+        const uint64_t blockSize = 32768;
+        const uint64_t nBlocks = (nbytes + blockSize - 1) / blockSize;
+        std::vector<uint64_t> header(3 + nBlocks);
+        header[0] = nBlocks;
+        header[1] = blockSize;
+        header[2] = nbytes % blockSize;
+
+        // The header is filled in once the sizes are known
+        const size_t start = out.size();
+        const uint64_t headerBytes = header.size() * sizeof(uint64_t);
+        out.resize(start + headerBytes);
+
+        std::vector<Bytef> buffer(compressBound(blockSize));
+        for (uint64_t b = 0; b != nBlocks; ++b)
+        {
+            const uLong len = static_cast<uLong>(
+                std::min(blockSize, nbytes - b * blockSize) );
+            uLongf clen = static_cast<uLongf>(buffer.size());
+            // Favor speed over ratio, this is output of a running simulation
+            const int status = compress2(buffer.data(), &clen,
+                reinterpret_cast<const Bytef*>(data + b * blockSize),
+                len, Z_BEST_SPEED);
+            GISMO_ENSURE(Z_OK == status, "zlib compression failed (error "<< status <<").");
+            header[3 + b] = clen;
+            out.append(reinterpret_cast<const char*>(buffer.data()), clen);
+        }
+        std::memcpy(&out[start], header.data(), headerBytes);
+        return out.size() - start;
+    }
+
+    uint64_t writeVtkBinaryBlock(std::ostream & out, const char * data,
+                                 uint64_t nbytes, bool compress)
+    {
+        if (!compress)
+        {
+            // Written directly, without any copy
+            out.write(reinterpret_cast<const char*>(&nbytes), sizeof(uint64_t));
+            out.write(data, nbytes);
+            return sizeof(uint64_t) + nbytes;
+        }
+
+        std::string block;
+        const uint64_t bytes = writeVtkBinaryBlock(block, data, nbytes, true);
+        out.write(block.data(), block.size());
+        return bytes;
+    }
+
+    void writeAppendedData(std::ostream & out, std::string const & rawFile)
+    {
+        std::ifstream raw(rawFile.c_str(), std::ios::in | std::ios::binary);
+        GISMO_ENSURE(raw.is_open(), "Cannot open "<< rawFile <<" for reading.");
+
+        out << "<AppendedData encoding=\"raw\">\n_";
+        // Copy in chunks through the stream buffers
+        if (raw.peek() != std::ifstream::traits_type::eof())
+            out << raw.rdbuf();
+        out << "\n</AppendedData>\n";
+    }
+
 } // namespace gismo
 
 #undef VTK_BEZIER_QUADRILATERAL
@@ -66,6 +66,64 @@ namespace gismo
                             unsigned precision = 5,
                             const bool& export_base64=false);
 
+    /// @brief Formats the matrix as a <DataArray> xml tag in VTK
+    /// "appended" format, while its binary payload is streamed to \a raw.
+    /// @tparam T Arithmetic type
+    /// @param matrix The data, stored column-wise, size (numComponents, numTuples)
+    /// @param raw Binary stream collecting the appended data of the file
+    /// @param offset Current offset inside the appended data, it is advanced
+    /// by the number of bytes written to \a raw
+    /// @param attributes Optional, map of strings, with attribute name mapping to attribute value.
+    /// @param compress Compress the payload with zlib (vtkZLibDataCompressor)
+    /// @return The raw xml string, containing only the (empty) tag
+    template <class T>
+    std::string toAppendedDataArray(const gsMatrix<T> & matrix,
+                                    std::ostream & raw,
+                                    uint64_t & offset,
+                                    std::map<std::string, std::string> attributes={{"",""}},
+                                    const bool & compress = false);
+
+    /// @brief Same as above, but the binary payload is appended to the
+    /// string \a raw, which can be moved afterwards without any copy.
+    template <class T>
+    std::string toAppendedDataArray(const gsMatrix<T> & matrix,
+                                    std::string & raw,
+                                    uint64_t & offset,
+                                    std::map<std::string, std::string> attributes={{"",""}},
+                                    const bool & compress = false);
+
+    /// @brief Evaluates piece \a i of \a funSet on a uniform grid of
+    /// (approximately) \a nPts points, the values are stored column-wise in \a result.
+    template <class T>
+    void sampleOnGrid(const gsFunctionSet<T>& funSet, index_t i,
+                      unsigned nPts, gsMatrix<T> & result);
+
+    /// @brief Evaluates the function of patch \a i of \a field on a
+    /// uniform grid of (approximately) \a nPts points.
+    template <class T>
+    void sampleOnGrid(const gsField<T>& field, index_t i,
+                      unsigned nPts, gsMatrix<T> & result);
+
+    /// @brief Evaluates expression \a expr on patch \a i over a uniform
+    /// grid of (approximately) \a nPts points.
+    template <class E>
+    void sampleOnGrid(const expr::_expr<E>& expr,
+                      gsExprEvaluator<> * evaltr, index_t i,
+                      unsigned nPts, gsMatrix<real_t> & result)
+    {
+        // Get bounding box and sample evaluation points on current patch
+        const gsMatrix<real_t> bounding_box_dimensions =
+            evaltr->exprData()->multiBasis().piece(i).support();
+        gsGridIterator<real_t, CUBE> grid_iterator(bounding_box_dimensions,
+                                                   nPts);
+        evaltr->eval(expr, grid_iterator, i);
+
+        // Evaluate Expression on grid_points
+        result = evaltr->allValues(
+            evaltr->elementwise().size() / grid_iterator.numPoints(),
+            grid_iterator.numPoints());
+    }
+
     /// @brief  Evaluates one expression over all patches and returns all
     /// <DataArray> xml tags as a vector of strings, as no points are exported, no
     /// need to enforce 1:3D fields
@@ -87,21 +145,10 @@ namespace gismo
         // if false, embed topology ?
         const index_t n = evaltr->exprData()->multiBasis().nBases();
 
-        gsMatrix<real_t> evaluated_values, bounding_box_dimensions;
+        gsMatrix<real_t> evaluated_values;
 
         for (index_t i = 0; i != n; ++i) {
-            // Get bounding box and sample evaluation points on current patch
-            bounding_box_dimensions =
-                evaltr->exprData()->multiBasis().piece(i).support();
-            gsGridIterator<real_t, CUBE> grid_iterator(bounding_box_dimensions,
-                                                    nPts);
-            evaltr->eval(expr, grid_iterator, i);
-
-            // Evaluate Expression on grid_points
-            evaluated_values = evaltr->allValues(
-                evaltr->elementwise().size() / grid_iterator.numPoints(),
-                grid_iterator.numPoints());
-
+            sampleOnGrid(expr, evaltr, i, nPts, evaluated_values);
 
             GISMO_ASSERT(evaluated_values.rows() <= 3, "The expression can be scalar or have at most 3 components.");
             if (evaluated_values.rows() == 2)
@@ -133,6 +180,30 @@ namespace gismo
     /// @return 
     GISMO_EXPORT std::string toDataArray(index_t num, std::map<std::string, std::string> attributes={{"",""}});
 
+    /// @brief Writes a block of binary data, as expected inside the
+    /// <AppendedData> section of a VTK file with header_type="UInt64".
+    /// @param out The (binary) output stream
+    /// @param data Pointer to the data
+    /// @param nbytes Number of bytes to be written
+    /// @param compress If true, the block is compressed with zlib following
+    /// the layout of vtkZLibDataCompressor
+    /// @return The number of bytes written to \a out (including headers)
+    GISMO_EXPORT uint64_t writeVtkBinaryBlock(std::ostream & out,
+                                              const char * data,
+                                              uint64_t nbytes,
+                                              bool compress = false);
+
+    /// @brief Same as above, but the block is appended to the string \a out
+    GISMO_EXPORT uint64_t writeVtkBinaryBlock(std::string & out,
+                                              const char * data,
+                                              uint64_t nbytes,
+                                              bool compress = false);
+
+    /// @brief Writes the <AppendedData> section of a VTK file, copying the
+    /// contents of the binary file \a rawFile to \a out.
+    GISMO_EXPORT void writeAppendedData(std::ostream & out,
+                                        std::string const & rawFile);
+
 
 
     template<class T>
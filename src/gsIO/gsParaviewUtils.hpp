@@ -31,6 +31,44 @@
 
 namespace gismo
 {
+    template <class T>
+    void sampleOnGrid(const gsFunctionSet<T>& funSet, index_t i,
+                      unsigned nPts, gsMatrix<T> & result)
+    {
+        gsGridIterator<T,CUBE> grid(funSet.piece(i).support(), nPts);
+
+        // Evaluate the piece for every parametric point of the grid iterator
+        result.resize( funSet.targetDim(), grid.numPoints() );
+        gsMatrix<T> evalPoint;
+        index_t col = 0;
+        for( grid.reset(); grid; ++grid )
+        {
+            evalPoint = *grid; // ..
+            result.col(col) =  funSet.piece(i).eval(evalPoint);
+            col++;
+        }
+    }
+
+    template <class T>
+    void sampleOnGrid(const gsField<T>& field, index_t i,
+                      unsigned nPts, gsMatrix<T> & result)
+    {
+        // The grid is on the parameter domain of the geometry, which is
+        // also the domain of non-parametric fields
+        gsGridIterator<T,CUBE> grid(field.patches().piece(i).support(), nPts);
+
+        // Evaluate the field for every parametric point of the grid iterator
+        result.resize( field.dim(), grid.numPoints());
+        gsMatrix<T> evalPoint;
+        index_t col = 0;
+        for( grid.reset(); grid; ++grid )
+        {
+            evalPoint = *grid; // ..
+            result.col(col) =  field.value(evalPoint, i);
+            col++;
+        }
+    }
+
     template <class T>
     std::vector<std::string> toVTK(const gsFunctionSet<T>& funSet,
                                    unsigned nPts,
@@ -38,32 +76,24 @@ namespace gismo
                                    std::string label,
                                    const bool& export_base64)
     {
-        std::vector<std::string> out;
-        gsMatrix<T> evalPoint, xyzPoints;
+        const index_t nPieces = funSet.nPieces();
+        std::vector<std::string> out(nPieces);
 
         // Loop over all patches
-        for ( index_t i=0; i != funSet.nPieces(); ++i )
+#pragma omp parallel for
+        for ( index_t i=0; i < nPieces; ++i )
         {
-            gsGridIterator<T,CUBE> grid(funSet.piece(i).support(), nPts);
-
-            // Evaluate the MultiPatch for every parametric point of the grid iterator
-            xyzPoints.resize( funSet.targetDim(), grid.numPoints() );
-            index_t col = 0;
-            for( grid.reset(); grid; ++grid )
-            {
-                evalPoint = *grid; // ..
-                xyzPoints.col(col) =  funSet.piece(i).eval(evalPoint);
-                col++;
-            }
+            gsMatrix<T> xyzPoints;
+            sampleOnGrid(funSet, i, nPts, xyzPoints);
 
             if (xyzPoints.rows() < 3)
                 // Pad matrix with zeros
                 xyzPoints.conservativeResizeLike(gsEigen::MatrixXd::Zero(3,xyzPoints.cols()));
 
             if (""!=label)
-                out.push_back( toDataArray(xyzPoints, {{"Name",label}}, precision, export_base64)  );
+                out[i] = toDataArray(xyzPoints, {{"Name",label}}, precision, export_base64);
             else
-                out.push_back( toDataArray(xyzPoints, {{"",""}}, precision, export_base64)  );
+                out[i] = toDataArray(xyzPoints, {{"",""}}, precision, export_base64);
         }
         return out;
     }
@@ -75,30 +105,20 @@ namespace gismo
                                    std::string label,
                                    const bool& export_base64)
     {
-        std::vector<std::string> out;
-        gsMatrix<T> evalPoint, xyzPoints;
+        const index_t nPieces = field.nPieces();
+        std::vector<std::string> out(nPieces);
 
         // Loop over all patches
-        for ( index_t i=0; i != field.nPieces(); ++i )
+#pragma omp parallel for
+        for ( index_t i=0; i < nPieces; ++i )
         {
-            gsGridIterator<T,CUBE> grid(field.fields().piece(i).support(), nPts);
-
-            // Evaluate the MultiPatch for every parametric point of the grid iterator
-            xyzPoints.resize( field.dim(), grid.numPoints());
-            index_t col = 0;
-            for( grid.reset(); grid; ++grid )
-            {
-                evalPoint = *grid; // ..
-                xyzPoints.col(col) =  field.value(evalPoint, i);
-                col++;
-            }
+            gsMatrix<T> xyzPoints;
+            sampleOnGrid(field, i, nPts, xyzPoints);
 
             if (""!=label)
-                out.push_back(
-                    toDataArray(xyzPoints, {{"Name", label}}, precision, export_base64));
+                out[i] = toDataArray(xyzPoints, {{"Name", label}}, precision, export_base64);
             else
-                out.push_back(
-                    toDataArray(xyzPoints, {{"", ""}}, precision, export_base64));
+                out[i] = toDataArray(xyzPoints, {{"", ""}}, precision, export_base64);
 
         }
         return out;
@@ -194,6 +214,71 @@ namespace gismo
     }
 
 
+    namespace internal
+    {
+    // The <DataArray> tag of an appended array with \a rows components
+    template<class T>
+    std::string appendedDataArrayTag(index_t rows, uint64_t offset,
+                                     const std::map<std::string, std::string> & attributes)
+    {
+        std::stringstream stream;
+
+        // Determing 'type' attribute based on the size of T
+        const std::string vtk_typename = []() {
+            if (!std::is_integral<T>::value)
+                return std::string(sizeof(T) == 4 ? "Float32" : "Float64");
+            const std::string prefix = std::is_signed<T>::value ? "Int" : "UInt";
+            return prefix + std::to_string(8 * sizeof(T));
+        }();
+
+        stream << "<DataArray type=\"" << vtk_typename
+               << "\" format=\"appended\" offset=\"" << offset << "\" ";
+
+        // Write attributes
+        for (auto const& block : attributes)
+        {
+            if (block.first!="")
+            stream << block.first <<"=\""<< block.second <<"\" ";
+        }
+        if (rows>1)
+            stream << "NumberOfComponents=\"" << rows << "\" ";
+        stream << "/>\n";
+        return stream.str();
+    }
+    }
+
+    template <class T>
+    std::string toAppendedDataArray(const gsMatrix<T> & matrix,
+                                    std::ostream & raw,
+                                    uint64_t & offset,
+                                    std::map<std::string, std::string> attributes,
+                                    const bool & compress)
+    {
+        const std::string tag =
+            internal::appendedDataArrayTag<T>(matrix.rows(), offset, attributes);
+        // The matrix is stored column-wise, hence the tuples are
+        // already contiguous: the data is written without any copy
+        offset += writeVtkBinaryBlock(raw,
+                                      reinterpret_cast<const char*>(matrix.data()),
+                                      matrix.size() * sizeof(T), compress);
+        return tag;
+    }
+
+    template <class T>
+    std::string toAppendedDataArray(const gsMatrix<T> & matrix,
+                                    std::string & raw,
+                                    uint64_t & offset,
+                                    std::map<std::string, std::string> attributes,
+                                    const bool & compress)
+    {
+        const std::string tag =
+            internal::appendedDataArrayTag<T>(matrix.rows(), offset, attributes);
+        offset += writeVtkBinaryBlock(raw,
+                                      reinterpret_cast<const char*>(matrix.data()),
+                                      matrix.size() * sizeof(T), compress);
+        return tag;
+    }
+
     template<class T>
     // std::string BezierVTK(const gsGeometry<T> & geom)
     std::string BezierVTK(const gsMultiPatch<T> & mPatch)
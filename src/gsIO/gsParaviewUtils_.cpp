@@ -52,6 +52,42 @@ namespace gismo
                             unsigned precision,
                             const bool& export_base64);
 
+    TEMPLATE_INST
+    std::string toAppendedDataArray(const gsMatrix<real_t> & matrix,
+                                    std::ostream & raw,
+                                    uint64_t & offset,
+                                    std::map<std::string, std::string> attributes,
+                                    const bool & compress);
+
+    TEMPLATE_INST
+    std::string toAppendedDataArray(const gsMatrix<index_t> & matrix,
+                                    std::ostream & raw,
+                                    uint64_t & offset,
+                                    std::map<std::string, std::string> attributes,
+                                    const bool & compress);
+
+    TEMPLATE_INST
+    std::string toAppendedDataArray(const gsMatrix<real_t> & matrix,
+                                    std::string & raw,
+                                    uint64_t & offset,
+                                    std::map<std::string, std::string> attributes,
+                                    const bool & compress);
+
+    TEMPLATE_INST
+    std::string toAppendedDataArray(const gsMatrix<index_t> & matrix,
+                                    std::string & raw,
+                                    uint64_t & offset,
+                                    std::map<std::string, std::string> attributes,
+                                    const bool & compress);
+
+    TEMPLATE_INST
+    void sampleOnGrid(const gsFunctionSet<real_t>& funSet, index_t i,
+                      unsigned nPts, gsMatrix<real_t> & result);
+
+    TEMPLATE_INST
+    void sampleOnGrid(const gsField<real_t>& field, index_t i,
+                      unsigned nPts, gsMatrix<real_t> & result);
+
     TEMPLATE_INST
     std::string BezierVTK(const gsMultiPatch<real_t> & mPatch);
 
@@ -0,0 +1,76 @@
+/** @file gsSnapshotFile.cpp
+
+    @brief Append-only binary container for time series of coefficients
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gsCore/gsTemplateTools.h>
+#include <gsIO/gsSnapshotFile.h>
+#include <gsIO/gsParaviewCollection.h>
+#include <gsCore/gsField.h>
+
+#ifdef GISMO_ZLIB_STATIC
+#define Z_PREFIX
+#include <zlib/zlib.h> // bundled zlib
+#else
+#include <zlib.h>      // system zlib
+#endif
+
+namespace gismo
+{
+
+namespace internal
+{
+
+void zCompress(const char * data, uint64_t nbytes, std::string & out)
+{
+    uLongf clen = compressBound(static_cast<uLong>(nbytes));
+    out.resize(clen);
+    // Favor speed over ratio, snapshots are written during a simulation
+    const int status = compress2(reinterpret_cast<Bytef*>(&out[0]), &clen,
+                                 reinterpret_cast<const Bytef*>(data),
+                                 static_cast<uLong>(nbytes), Z_BEST_SPEED);
+    GISMO_ENSURE(Z_OK == status, "zlib compression failed (error "<< status <<").");
+    out.resize(clen);
+}
+
+void zUncompress(const char * data, uint64_t nbytes, char * out, uint64_t outBytes)
+{
+    uLongf len = static_cast<uLongf>(outBytes);
+    const int status = uncompress(reinterpret_cast<Bytef*>(out), &len,
+                                  reinterpret_cast<const Bytef*>(data),
+                                  static_cast<uLong>(nbytes));
+    GISMO_ENSURE(Z_OK == status && len == outBytes,
+                 "zlib decompression failed (error "<< status <<").");
+}
+
+}
+
+void gsWriteParaview(const gsSnapshotFile<real_t> & snap,
+                     gsParaviewCollection & pc,
+                     const std::string & label,
+                     index_t first, index_t last, index_t stride)
+{
+    if ( -1 == last ) last = snap.numSteps() - 1;
+    GISMO_ENSURE(first >= 0 && last < snap.numSteps() && stride > 0,
+                 "gsWriteParaview: Invalid range of steps.");
+
+    gsMultiPatch<real_t> geo, sol;
+    snap.getGeometry(geo);
+    for (index_t k = first; k <= last; k += stride)
+    {
+        snap.getStep(k, geo, sol);
+        pc.newTimeStep(&geo, snap.time(k));
+        pc.addField(gsField<real_t>(geo, sol), label);
+        pc.saveTimeStep();
+    }
+}
+
+} // namespace gismo
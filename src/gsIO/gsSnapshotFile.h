@@ -0,0 +1,168 @@
+/** @file gsSnapshotFile.h
+
+    @brief Append-only binary container for time series of coefficients
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsForwardDeclarations.h>
+#include <gsCore/gsMultiPatch.h>
+
+#include <fstream>
+
+namespace gismo
+{
+
+class gsParaviewCollection;
+
+namespace internal
+{
+/// Compresses \a nbytes of \a data with zlib and stores the result in \a out
+GISMO_EXPORT void zCompress(const char * data, uint64_t nbytes, std::string & out);
+
+/// Uncompresses \a nbytes of zlib-compressed \a data into \a out, which
+/// must already have the size of the uncompressed data
+GISMO_EXPORT void zUncompress(const char * data, uint64_t nbytes, char * out, uint64_t outBytes);
+}
+
+/**
+    \brief Compact, append-only binary container for a time series of
+    coefficient matrices (e.g. solution snapshots).
+
+    The file holds the geometry (a gsMultiPatch) once, followed by a
+    sequence of steps. Each step is a coefficient matrix together with a
+    time value, optionally zlib-compressed. Appending a step costs
+    O(step size), since nothing already written is touched.
+
+    An index of the steps is built when the file is opened, so that
+    any step \a k can be read without reading the others. Opening an
+    existing file continues the series (restart): a partially written
+    last step, e.g. after a crash, is discarded, and truncate() can be
+    used to go back to a checkpoint.
+
+    The coefficients of a step are meant to be stacked patch-wise, as in
+    gsMultiPatch::coefs(). In this case getStep() can return them as a
+    gsMultiPatch on the bases of the stored geometry, and the series
+    can be exported step by step to a gsParaviewCollection, see
+    gsWriteParaview(const gsSnapshotFile<real_t>&, ...).
+
+    Typical usage is
+    \verbatim
+    gsSnapshotFile<> snap("heat.gss");
+    if (!snap.hasGeometry()) snap.setGeometry(mp);
+    while ( ... )
+    {
+        // solve here
+        snap.append(solVector, time);
+    }
+    \endverbatim
+
+    \ingroup IO
+*/
+template<class T = real_t>
+class gsSnapshotFile
+{
+public:
+    typedef memory::unique_ptr<gsSnapshotFile> uPtr;
+
+public:
+
+    /// @brief Opens the file \a fn, which is created if it does not exist
+    /// @param fn Filename
+    /// @param compress Compress the steps that are appended from now on
+    explicit gsSnapshotFile(const std::string & fn, bool compress = false);
+
+    /// @brief Stores the geometry; this is possible only once and
+    /// before any step has been appended.
+    void setGeometry(const gsMultiPatch<T> & mp);
+
+    /// @brief Returns true if a geometry is stored
+    bool hasGeometry() const { return m_geoBytes > 0; }
+
+    /// @brief Reads the stored geometry into \a result
+    void getGeometry(gsMultiPatch<T> & result) const;
+
+    /// @brief Appends a step with coefficients \a coefs at time \a time.
+    /// @return The index of the new step
+    index_t append(const gsMatrix<T> & coefs, T time);
+
+    /// @brief Returns the number of steps stored
+    index_t numSteps() const { return static_cast<index_t>(m_index.size()); }
+
+    /// @brief Returns the time of step \a k
+    T time(index_t k) const { return m_index.at(k).time; }
+
+    /// @brief Reads the coefficients of step \a k into \a result
+    void getStep(index_t k, gsMatrix<T> & result) const;
+
+    /// @brief Reads step \a k as a gsMultiPatch defined on the bases of
+    /// the stored geometry \a geo (see getGeometry())
+    void getStep(index_t k, const gsMultiPatch<T> & geo,
+                 gsMultiPatch<T> & result) const;
+
+    /// @brief Removes all steps from \a n on (restart from a checkpoint).
+    void truncate(index_t n);
+
+    /// @brief Enables or disables compression for the steps appended
+    /// from now on
+    void setCompression(bool compress) { m_compress = compress; }
+
+    /// @brief Returns the filename
+    const std::string & filename() const { return m_filename; }
+
+    std::ostream & print(std::ostream & os) const;
+
+private:
+    // Scans the file and builds the index
+    void readIndex();
+
+private:
+    struct stepInfo
+    {
+        uint64_t offset; // position of the payload in the file
+        uint64_t bytes;  // size of the payload in the file
+        int64_t  rows, cols;
+        bool     compressed;
+        T        time;
+    };
+
+    std::string m_filename;
+    bool m_compress;
+    uint64_t m_geoBytes;
+    uint64_t m_end; // end of valid data
+    std::vector<stepInfo> m_index;
+};
+
+/// Print (as string) operator
+template<class T>
+std::ostream &operator<<(std::ostream &os, const gsSnapshotFile<T>& s)
+{ return s.print(os); }
+
+/// @brief Exports the steps \a first,...,\a last of \a snap to the
+/// collection \a pc, as a field named \a label over the stored
+/// geometry. The steps are read one at a time.
+/// @param snap The snapshot file
+/// @param pc The ParaView collection, the caller still needs to call save()
+/// @param label The name of the field shown in ParaView
+/// @param first First step to be exported
+/// @param last Last step to be exported (-1 for the last stored step)
+/// @param stride Export every \a stride-th step
+GISMO_EXPORT void gsWriteParaview(const gsSnapshotFile<real_t> & snap,
+                                  gsParaviewCollection & pc,
+                                  const std::string & label = "Solution",
+                                  index_t first = 0, index_t last = -1,
+                                  index_t stride = 1);
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsSnapshotFile.hpp)
+#endif
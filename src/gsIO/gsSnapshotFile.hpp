@@ -0,0 +1,302 @@
+/** @file gsSnapshotFile.hpp
+
+    @brief Append-only binary container for time series of coefficients
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsIO/gsFileData.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace gismo
+{
+
+/*
+  File layout (native byte order):
+
+  header : char[8] "GSSNAP01", uint32 sizeof(T), uint32 (reserved),
+           uint64 geoBytes, geometry in G+Smo XML (geoBytes)
+  step   : uint32 "STEP", uint32 compressed, int64 rows, int64 cols,
+           uint64 bytes, T time, payload (bytes)
+
+  The payload is the column-major matrix data, possibly compressed.
+*/
+
+namespace internal
+{
+static const char     snapMagic[8] = {'G','S','S','N','A','P','0','1'};
+static const uint32_t snapStepMagic = 0x50455453; // "STEP"
+static const uint64_t snapHeaderBytes = 8 + 2*sizeof(uint32_t) + sizeof(uint64_t);
+
+template<class V> inline
+void snapWrite(std::ostream & os, const V & v)
+{ os.write(reinterpret_cast<const char*>(&v), sizeof(V)); }
+
+template<class V> inline
+bool snapRead(std::istream & is, V & v)
+{ return static_cast<bool>(is.read(reinterpret_cast<char*>(&v), sizeof(V))); }
+
+// Keeps the first \a bytes bytes of file \a fn (via a temporary copy)
+// and discards the rest
+inline void snapShrink(const std::string & fn, uint64_t bytes)
+{
+    const std::string tmp = fn + ".tmp";
+    {
+        std::ifstream in(fn.c_str(), std::ios::binary);
+        std::ofstream out(tmp.c_str(), std::ios::binary | std::ios::trunc);
+        GISMO_ENSURE(in && out, "gsSnapshotFile: Cannot rewrite file "<< fn);
+        std::vector<char> buf(1<<20);
+        while (bytes > 0)
+        {
+            const std::streamsize n = static_cast<std::streamsize>(
+                std::min<uint64_t>(bytes, buf.size()) );
+            in.read(buf.data(), n);
+            out.write(buf.data(), n);
+            GISMO_ENSURE(in && out, "gsSnapshotFile: Cannot rewrite file "<< fn);
+            bytes -= n;
+        }
+    }
+    std::remove(fn.c_str());
+    GISMO_ENSURE(0 == std::rename(tmp.c_str(), fn.c_str()),
+                 "gsSnapshotFile: Cannot rename "<< tmp <<" to "<< fn);
+}
+}
+
+template<class T>
+gsSnapshotFile<T>::gsSnapshotFile(const std::string & fn, bool compress)
+: m_filename(fn), m_compress(compress), m_geoBytes(0), m_end(0)
+{
+    readIndex();
+}
+
+template<class T>
+void gsSnapshotFile<T>::readIndex()
+{
+    m_index.clear();
+    m_geoBytes = 0;
+
+    std::ifstream in(m_filename.c_str(), std::ios::binary);
+    if ( !in )
+    {
+        // New file, write an empty header
+        std::ofstream out(m_filename.c_str(), std::ios::binary | std::ios::trunc);
+        GISMO_ENSURE(out, "gsSnapshotFile: Cannot create file "<< m_filename);
+        out.write(internal::snapMagic, 8);
+        internal::snapWrite(out, static_cast<uint32_t>(sizeof(T)) );
+        internal::snapWrite(out, static_cast<uint32_t>(0) );
+        internal::snapWrite(out, m_geoBytes );
+        GISMO_ENSURE(out, "gsSnapshotFile: Cannot write to file "<< m_filename);
+        m_end = internal::snapHeaderBytes;
+        return;
+    }
+
+    char magic[8];
+    uint32_t tsize(0), reserved(0);
+    GISMO_ENSURE( in.read(magic, 8) && 0 == std::memcmp(magic, internal::snapMagic, 8)
+                  && internal::snapRead(in, tsize) && internal::snapRead(in, reserved)
+                  && internal::snapRead(in, m_geoBytes),
+                  "gsSnapshotFile: "<< m_filename <<" is not a snapshot file.");
+    GISMO_ENSURE(tsize == sizeof(T), "gsSnapshotFile: "<< m_filename
+                 <<" stores values of "<< tsize <<" bytes, expected "<< sizeof(T) <<".");
+
+    in.seekg(0, std::ios::end);
+    const uint64_t fileBytes = static_cast<uint64_t>(in.tellg());
+    m_end = internal::snapHeaderBytes + m_geoBytes;
+    GISMO_ENSURE(m_end <= fileBytes, "gsSnapshotFile: "<< m_filename <<" is corrupted.");
+    in.seekg(m_end);
+
+    // Scan the step records, stop at the first incomplete one
+    const uint64_t recBytes = 2*sizeof(uint32_t) + 2*sizeof(int64_t)
+        + sizeof(uint64_t) + sizeof(T);
+    stepInfo s;
+    uint32_t smagic, comp;
+    while ( m_end + recBytes <= fileBytes )
+    {
+        if ( !( internal::snapRead(in, smagic) && smagic == internal::snapStepMagic
+                && internal::snapRead(in, comp) && internal::snapRead(in, s.rows)
+                && internal::snapRead(in, s.cols) && internal::snapRead(in, s.bytes)
+                && internal::snapRead(in, s.time) ) )
+            break;
+        s.offset     = m_end + recBytes;
+        s.compressed = (0 != comp);
+        if ( s.offset + s.bytes > fileBytes )
+            break;
+        m_index.push_back(s);
+        m_end = s.offset + s.bytes;
+        in.seekg(m_end);
+    }
+    in.close();
+
+    if ( m_end != fileBytes ) // discard a partially written tail
+    {
+        gsWarn<<"gsSnapshotFile: Discarding "<< fileBytes - m_end
+              <<" bytes of incomplete data at the end of "<< m_filename <<".\n";
+        internal::snapShrink(m_filename, m_end);
+    }
+}
+
+template<class T>
+void gsSnapshotFile<T>::setGeometry(const gsMultiPatch<T> & mp)
+{
+    GISMO_ENSURE(!hasGeometry() && m_index.empty(),
+                 "gsSnapshotFile: The geometry can only be set once, before any step.");
+
+    gsFileData<T> fd;
+    fd << mp;
+    std::stringstream ss;
+    fd.print(ss);
+    const std::string xml = ss.str();
+
+    std::ofstream out(m_filename.c_str(), std::ios::binary | std::ios::trunc);
+    GISMO_ENSURE(out, "gsSnapshotFile: Cannot write to file "<< m_filename);
+    m_geoBytes = xml.size();
+    out.write(internal::snapMagic, 8);
+    internal::snapWrite(out, static_cast<uint32_t>(sizeof(T)) );
+    internal::snapWrite(out, static_cast<uint32_t>(0) );
+    internal::snapWrite(out, m_geoBytes );
+    out.write(xml.data(), xml.size());
+    GISMO_ENSURE(out, "gsSnapshotFile: Cannot write to file "<< m_filename);
+    m_end = internal::snapHeaderBytes + m_geoBytes;
+}
+
+template<class T>
+void gsSnapshotFile<T>::getGeometry(gsMultiPatch<T> & result) const
+{
+    GISMO_ENSURE(hasGeometry(), "gsSnapshotFile: No geometry stored in "<< m_filename);
+
+    std::ifstream in(m_filename.c_str(), std::ios::binary);
+    in.seekg(internal::snapHeaderBytes);
+    std::vector<char> buf(m_geoBytes + 1);
+    in.read(buf.data(), m_geoBytes);
+    GISMO_ENSURE(in, "gsSnapshotFile: Cannot read from file "<< m_filename);
+    buf.back() = '\0';
+
+    internal::gsXmlTree tree;
+    tree.parse<0>(buf.data());
+    internal::gsXmlNode * root = tree.first_node("xml");
+    internal::gsXmlNode * node = root ? root->first_node(
+        internal::gsXml< gsMultiPatch<T> >::tag().c_str() ) : NULL;
+    GISMO_ENSURE(node, "gsSnapshotFile: Invalid geometry in "<< m_filename);
+    internal::gsXml< gsMultiPatch<T> >::get_into(node, result);
+}
+
+template<class T>
+index_t gsSnapshotFile<T>::append(const gsMatrix<T> & coefs, T time)
+{
+    stepInfo s;
+    s.rows = coefs.rows();
+    s.cols = coefs.cols();
+    s.time = time;
+    s.compressed = m_compress;
+
+    const char * data = reinterpret_cast<const char*>(coefs.data());
+    const uint64_t rawBytes = static_cast<uint64_t>(coefs.size()) * sizeof(T);
+    std::string packed;
+    if ( m_compress )
+    {
+        internal::zCompress(data, rawBytes, packed);
+        data = packed.data();
+        s.bytes = packed.size();
+    }
+    else
+        s.bytes = rawBytes;
+
+    std::ofstream out(m_filename.c_str(), std::ios::binary | std::ios::app);
+    GISMO_ENSURE(out, "gsSnapshotFile: Cannot write to file "<< m_filename);
+    internal::snapWrite(out, internal::snapStepMagic);
+    internal::snapWrite(out, static_cast<uint32_t>(s.compressed) );
+    internal::snapWrite(out, s.rows);
+    internal::snapWrite(out, s.cols);
+    internal::snapWrite(out, s.bytes);
+    internal::snapWrite(out, s.time);
+    out.write(data, s.bytes);
+    out.flush();
+    GISMO_ENSURE(out, "gsSnapshotFile: Cannot write to file "<< m_filename);
+
+    s.offset = m_end + 2*sizeof(uint32_t) + 2*sizeof(int64_t)
+        + sizeof(uint64_t) + sizeof(T);
+    m_end = s.offset + s.bytes;
+    m_index.push_back(s);
+    return numSteps() - 1;
+}
+
+template<class T>
+void gsSnapshotFile<T>::getStep(index_t k, gsMatrix<T> & result) const
+{
+    GISMO_ENSURE(k >= 0 && k < numSteps(), "gsSnapshotFile: Step "<< k
+                 <<" does not exist, "<< numSteps() <<" steps are stored.");
+    const stepInfo & s = m_index[k];
+
+    std::ifstream in(m_filename.c_str(), std::ios::binary);
+    in.seekg(s.offset);
+    result.resize(s.rows, s.cols);
+    char * data = reinterpret_cast<char*>(result.data());
+    const uint64_t rawBytes = static_cast<uint64_t>(result.size()) * sizeof(T);
+    if ( s.compressed )
+    {
+        std::vector<char> packed(s.bytes);
+        in.read(packed.data(), s.bytes);
+        GISMO_ENSURE(in, "gsSnapshotFile: Cannot read from file "<< m_filename);
+        internal::zUncompress(packed.data(), s.bytes, data, rawBytes);
+    }
+    else
+    {
+        in.read(data, rawBytes);
+        GISMO_ENSURE(in, "gsSnapshotFile: Cannot read from file "<< m_filename);
+    }
+}
+
+template<class T>
+void gsSnapshotFile<T>::getStep(index_t k, const gsMultiPatch<T> & geo,
+                                gsMultiPatch<T> & result) const
+{
+    gsMatrix<T> coefs;
+    getStep(k, coefs);
+
+    result.clear();
+    index_t off = 0;
+    for (size_t p = 0; p != geo.nPatches(); ++p)
+    {
+        const index_t n = geo.basis(p).size();
+        GISMO_ENSURE(off + n <= coefs.rows(), "gsSnapshotFile: Step "<< k
+                     <<" does not match the geometry.");
+        result.addPatch( geo.basis(p).makeGeometry(coefs.middleRows(off, n)) );
+        off += n;
+    }
+    GISMO_ENSURE(off == coefs.rows(), "gsSnapshotFile: Step "<< k
+                 <<" does not match the geometry.");
+}
+
+template<class T>
+void gsSnapshotFile<T>::truncate(index_t n)
+{
+    GISMO_ENSURE(n >= 0, "gsSnapshotFile: Invalid number of steps.");
+    if ( n >= numSteps() ) return;
+
+    m_end = ( 0 == n ? internal::snapHeaderBytes + m_geoBytes
+                     : m_index[n-1].offset + m_index[n-1].bytes );
+    m_index.resize(n);
+    internal::snapShrink(m_filename, m_end);
+}
+
+template<class T>
+std::ostream & gsSnapshotFile<T>::print(std::ostream & os) const
+{
+    os << "Snapshot file "<< m_filename <<" with "<< numSteps() <<" steps";
+    if ( !m_index.empty() )
+        os <<", time "<< m_index.front().time <<" to "<< m_index.back().time;
+    os <<( hasGeometry() ? ", with geometry" : "" ) <<".\n";
+    return os;
+}
+
+} // namespace gismo
@@ -0,0 +1,11 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsIO/gsSnapshotFile.h>
+#include <gsIO/gsSnapshotFile.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsSnapshotFile<real_t>;
+
+}
@@ -96,6 +96,15 @@ void gsWriteParaview(gsFunctionSet<T> const& geom,
 template <class T>
 void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, const gsMatrix<T>& params);
 
+/// \brief Export a mesh to a paraview file in VTK appended (raw binary) format
+///
+/// \param sl a gsMesh object
+/// \param fn filename where paraview file is written (without extension)
+/// \param compress if true, the data is compressed with zlib
+template <class T>
+void gsWriteParaviewAppended(gsMesh<T> const& sl, std::string const & fn,
+                             bool compress = false);
+
 GISMO_EXPORT void gsWriteParaview(const gsSurfMesh & sm,
                                   std::string const & fn,
                                   std::initializer_list<std::string> props = {});
@@ -460,10 +469,11 @@ void writeSingleBox(const gsMatrix<T> & box, std::string const & fn, T value);
 template<class T>
 void writeSingleHBox(const gsHBox<2,T> & box, std::string const & fn);
 
-/// Export a control net
+/// Export a control net, optionally in VTK appended (binary) format
 template<class T>
 void writeSingleControlNet(const gsGeometry<T> & Geo,
-                           std::string const & fn);
+                           std::string const & fn,
+                           bool appended = false, bool compress = false);
 
 // Please document
 template <class T>
@@ -246,7 +246,8 @@ void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo,
 /// Export a control net
 template<class T>
 void writeSingleControlNet(const gsGeometry<T> & Geo,
-                           std::string const & fn)
+                           std::string const & fn,
+                           bool appended, bool compress)
 {
     const int d = Geo.parDim();
     gsMesh<T> msh;
@@ -270,7 +271,10 @@ void writeSingleControlNet(const gsGeometry<T> & Geo,
         return;
     }
 
-    gsWriteParaview(msh, fn, false);
+    if (appended)
+        gsWriteParaviewAppended(msh, fn, compress);
+    else
+        gsWriteParaview(msh, fn, false);
 }
 
 template<class T>
@@ -1916,6 +1920,64 @@ void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
         makeCollection(fn, ".vtp");
 }
 
+template <class T>
+void gsWriteParaviewAppended(gsMesh<T> const& sl, std::string const & fn, bool compress)
+{
+    std::string mfn(fn);
+    mfn.append(".vtp");
+    std::ofstream file(mfn.c_str(), std::ios_base::out | std::ios_base::binary);
+    GISMO_ENSURE(file.is_open(), "gsWriteParaview: Problem opening file \""<<mfn<<"\"");
+
+    const index_t nV = sl.numVertices(), nE = sl.numEdges(), nF = sl.numFaces();
+    gsMatrix<T> points(3, nV);
+    for (index_t i = 0; i != nV; ++i)
+        points.col(i) = *sl.vertices()[i];
+
+    gsMatrix<index_t> lines(2, nE), lineOffsets(1, nE);
+    for (index_t i = 0; i != nE; ++i)
+    {
+        lines(0,i) = sl.edges()[i].source->getId();
+        lines(1,i) = sl.edges()[i].target->getId();
+        lineOffsets(0,i) = 2*(i+1);
+    }
+
+    index_t count = 0;
+    gsMatrix<index_t> polyOffsets(1, nF);
+    for (index_t i = 0; i != nF; ++i)
+        polyOffsets(0,i) = (count += sl.faces()[i]->vertices.size());
+    gsMatrix<index_t> polys(1, count);
+    count = 0;
+    for (index_t i = 0; i != nF; ++i)
+        for (typename std::vector< gsVertex<T>* >::const_iterator vit = sl.faces()[i]->vertices.begin();
+             vit!=sl.faces()[i]->vertices.end(); ++vit)
+            polys(0,count++) = (*vit)->getId();
+
+    std::map<std::string, std::string> conn, offs;
+    conn["Name"] = "connectivity";
+    offs["Name"] = "offsets";
+
+    std::ostringstream raw(std::ios_base::out | std::ios_base::binary);
+    uint64_t offset = 0;
+
+    file <<"<?xml version=\"1.0\"?>\n";
+    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\" header_type=\"UInt64\"";
+    if (compress)
+        file <<" compressor=\"vtkZLibDataCompressor\"";
+    file <<">\n<PolyData>\n";
+    file <<"<Piece NumberOfPoints=\""<< nV <<"\" NumberOfVerts=\"0\" NumberOfLines=\""
+         << nE <<"\" NumberOfStrips=\"0\" NumberOfPolys=\""<< nF << "\">\n";
+    file <<"<Points>\n"<< toAppendedDataArray(points, raw, offset, {{"",""}}, compress) <<"</Points>\n";
+    file <<"<Lines>\n"<< toAppendedDataArray(lines, raw, offset, conn, compress)
+         << toAppendedDataArray(lineOffsets, raw, offset, offs, compress) <<"</Lines>\n";
+    file <<"<Polys>\n"<< toAppendedDataArray(polys, raw, offset, conn, compress)
+         << toAppendedDataArray(polyOffsets, raw, offset, offs, compress) <<"</Polys>\n";
+    file <<"</Piece>\n</PolyData>\n";
+    file <<"<AppendedData encoding=\"raw\">\n_";
+    const std::string data = raw.str();
+    file.write(data.data(), data.size());
+    file <<"\n</AppendedData>\n</VTKFile>\n";
+}
+
 template <class T>
 void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, const gsMatrix<T>& params)
 {
@@ -114,6 +114,9 @@ void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, const gsMatrix
 TEMPLATE_INST
 void gsWriteParaview(const std::vector<gsMesh<T> >& sl, std::string const & fn);
 
+TEMPLATE_INST
+void gsWriteParaviewAppended(gsMesh<T> const& sl, std::string const & fn, bool compress);
+
 //TEMPLATE_INST
 //void gsWriteParaview(gsHeMesh<T> const& sl, std::string const & fn);
 
@@ -170,7 +173,8 @@ TEMPLATE_INST
 void writeSingleHBox(const gsHBox<2,T> & box, std::string const & fn);
 
 TEMPLATE_INST
-void writeSingleControlNet(const gsGeometry<T> & Geo, std::string const & fn);
+void writeSingleControlNet(const gsGeometry<T> & Geo, std::string const & fn,
+                           bool appended, bool compress);
 
 ///////////////////////////////////////////////////////////////////////
 
@@ -18,6 +18,7 @@ namespace gismo {
 // forward declarations
 template<typename T> class gsEigenCGIdentity;
 template<typename T> class gsEigenCGDiagonal;
+template<typename T> class gsEigenCGIncompleteCholesky;
 template<typename T> class gsEigenBiCGSTABIdentity;
 template<typename T> class gsEigenBiCGSTABDiagonal;
 template<typename T> class gsEigenBiCGSTABILUT;
@@ -35,6 +36,11 @@ template<typename T> class gsEigenMINRES;
 template<typename T> class gsEigenGMRES;
 template<typename T> class gsEigenDGMRES;
 
+template<typename T> struct gsLowerPrecision;
+template<typename T, typename LowT = typename gsLowerPrecision<T>::type>
+class gsMixedPrecisionSolver;
+template<typename T> class gsCachedSparseSolver;
+
 /** @brief Abstract class for solvers.
     The solver interface is base on 3 methods:
     -compute set the system matrix (possibly compute the factorization or preconditioners)
@@ -70,6 +76,7 @@ public:
 
     typedef gsEigenCGIdentity<T>           CGIdentity ;
     typedef gsEigenCGDiagonal<T>           CGDiagonal;
+    typedef gsEigenCGIncompleteCholesky<T> CGIncompleteCholesky;
     typedef gsEigenBiCGSTABDiagonal<T>     BiCGSTABDiagonal;
     typedef gsEigenBiCGSTABIdentity<T>     BiCGSTABIdentity;
     typedef gsEigenBiCGSTABILUT<T>         BiCGSTABILUT;
@@ -87,6 +94,9 @@ public:
     typedef gsEigenMINRES<T>               MINRES;
     typedef gsEigenGMRES<T>                GMRES;
     typedef gsEigenDGMRES<T>               DGMRES;
+
+    typedef gsMixedPrecisionSolver<T>      MixedPrecision;
+    typedef gsCachedSparseSolver<T>        Cached;
     
 public:
     typedef gsSparseMatrix<T> MatrixT;
@@ -97,6 +107,17 @@ public:
 
     virtual gsSparseSolver& compute (const MatrixT &matrix) = 0;
 
+    /// Performs the symbolic analysis (e.g. the fill-reducing
+    /// ordering) of \a matrix. Subsequent calls of factorize() with
+    /// matrices of the same sparsity pattern skip this step.
+    virtual gsSparseSolver& analyzePattern (const MatrixT &)
+    { return *this; }
+
+    /// Computes the numerical factorization (or preconditioner) of \a
+    /// matrix, which has the pattern given to analyzePattern()
+    virtual gsSparseSolver& factorize (const MatrixT &matrix)
+    { return compute(matrix); }
+
     virtual VectorT   solve   (const VectorT &rhs)    const = 0;
 
     virtual bool      succeed ()                      const = 0;
@@ -121,6 +142,7 @@ public:
     static uPtr get(const std::string & slv)
     {
         if (slv=="CGDiagonal")       return uPtr(new CGDiagonal());
+        if (slv=="CGIncompleteCholesky") return uPtr(new CGIncompleteCholesky());
         if (slv=="SimplicialLDLT")   return uPtr(new SimplicialLDLT());
         if (slv=="SimplicialLLT")   return uPtr(new SimplicialLLT());
 #       ifdef GISMO_WITH_PARDISO
@@ -137,6 +159,12 @@ public:
         if (slv=="LU")               return uPtr(new LU());
         if (slv=="CGIdentity")       return uPtr(new CGIdentity());
         if (slv=="BiCGSTABIdentity") return uPtr(new BiCGSTABIdentity());
+        // "Mixed<Name>": factorization by <Name> in lower precision
+        if (0==slv.compare(0,5,"Mixed"))
+            return uPtr(new MixedPrecision(slv.substr(5)));
+        // "Cached<Name>": factorization by <Name>, shared through gsSparseSolverCache
+        if (0==slv.compare(0,6,"Cached"))
+            return uPtr(new Cached(slv.substr(6)));
         // if (slv=="MINRES") return uPtr(new MINRES());
         // if (slv=="GMRES")  return uPtr(new GMRES());
         // if (slv=="DGMRES") return uPtr(new DGMRES());
@@ -172,6 +200,18 @@ std::ostream &operator<<(std::ostream &os, const gsSparseSolver<T>& b)
             gsEigenAdaptor<T>::eigenName::compute(matrix);              \
             return *this;                                               \
         }                                                               \
+        gsname& analyzePattern (const MatrixT &matrix)                  \
+        {                                                               \
+            gsEigenAdaptor<T>::eigenName::analyzePattern(matrix);       \
+            return *this;                                               \
+        }                                                               \
+        gsname& factorize (const MatrixT &matrix)                       \
+        {                                                               \
+            m_rows=matrix.rows();                                       \
+            m_cols=matrix.cols();                                       \
+            gsEigenAdaptor<T>::eigenName::factorize(matrix);            \
+            return *this;                                               \
+        }                                                               \
         VectorT solve  (const VectorT &rhs) const                       \
         {                                                               \
             return gsEigenAdaptor<T>::eigenName::solve(rhs);            \
@@ -191,6 +231,7 @@ std::ostream &operator<<(std::ostream &os, const gsSparseSolver<T>& b)
 
 GISMO_EIGEN_SPARSE_SOLVER (gsEigenCGIdentity,     CGIdentity)
 GISMO_EIGEN_SPARSE_SOLVER (gsEigenCGDiagonal,     CGDiagonal)
+GISMO_EIGEN_SPARSE_SOLVER (gsEigenCGIncompleteCholesky, CGIncompleteCholesky)
 GISMO_EIGEN_SPARSE_SOLVER (gsEigenBiCGSTABIdentity, BiCGSTABIdentity)
 GISMO_EIGEN_SPARSE_SOLVER (gsEigenBiCGSTABDiagonal, BiCGSTABDiagonal)
 GISMO_EIGEN_SPARSE_SOLVER (gsEigenBiCGSTABILUT,     BiCGSTABILUT)
@@ -216,4 +257,216 @@ GISMO_EIGEN_SPARSE_SOLVER (gsEigenSimplicialLLT, SimplicialLLT)
 
 #undef GISMO_EIGEN_SPARSE_SOLVER
 
+/// The type in which gsMixedPrecisionSolver computes factorizations
+/// for the working precision T.
+template<typename T> struct gsLowerPrecision { typedef double type; };
+template<> struct gsLowerPrecision<float> { typedef float type; };
+template<> struct gsLowerPrecision<double> { typedef float type; };
+template<> struct gsLowerPrecision<long double> { typedef double type; };
+
+/** @brief Mixed precision direct solver.
+
+    The matrix is factorized in the lower precision LowT (float for
+    double, double for long double and for the multiprecision types)
+    by any solver available from gsSparseSolver<LowT>::get(), and the
+    accuracy of the working precision T is recovered by iterative
+    refinement: the residual is computed in T, and the correction is
+    computed by the low precision factorization. The factors need half
+    the memory and the triangular solves half the bandwidth of a
+    factorization in double.
+
+    Plain refinement converges if the condition number of the matrix
+    is below the inverse of the unit roundoff of LowT (about 1e7 for
+    float). With setKrylov(), the corrections are computed by a
+    flexible GMRES method preconditioned by the low precision
+    factorization (GMRES-IR), which extends this limit considerably.
+
+    The refinement stops when the normwise backward error
+    \f$ \|b-Ax\|_\infty / (\|A\|_\infty\|x\|_\infty+\|b\|_\infty) \f$
+    is below the tolerance, or when it stagnates. It is available by
+    gsSparseSolver<T>::get("Mixed<Name>"), e.g. "MixedSimplicialLDLT".
+
+    \ingroup Matrix
+*/
+template<typename T, typename LowT>
+class gsMixedPrecisionSolver : public gsSparseSolver<T>
+{
+    typedef typename gsSparseSolver<T>::MatrixT MatrixT;
+    typedef typename gsSparseSolver<T>::VectorT VectorT;
+    typedef gsSparseMatrix<LowT> LowMatrixT;
+    typedef gsMatrix<LowT>       LowVectorT;
+
+public:
+
+    /// Constructs the solver, where \a lowSolver is the name of the
+    /// low precision solver, cf. gsSparseSolver::get()
+    explicit gsMixedPrecisionSolver(const std::string & lowSolver = "SimplicialLDLT")
+    : m_low(gsSparseSolver<LowT>::get(lowSolver)), m_normA(0),
+      m_tol(100*std::numeric_limits<T>::epsilon()), m_maxIter(20),
+      m_restart(0), m_innerTol(1e-4), m_iter(0), m_error(0),
+      m_info(gsEigen::Success)
+    { }
+
+    gsMixedPrecisionSolver& compute (const MatrixT &matrix)
+    {
+        setMatrix(matrix);
+        m_low->compute( LowMatrixT(matrix.template cast<LowT>()) );
+        return *this;
+    }
+
+    gsMixedPrecisionSolver& analyzePattern (const MatrixT &matrix)
+    {
+        m_low->analyzePattern( LowMatrixT(matrix.template cast<LowT>()) );
+        return *this;
+    }
+
+    gsMixedPrecisionSolver& factorize (const MatrixT &matrix)
+    {
+        setMatrix(matrix);
+        m_low->factorize( LowMatrixT(matrix.template cast<LowT>()) );
+        return *this;
+    }
+
+    VectorT solve (const VectorT &rhs) const
+    {
+        VectorT x(rhs.rows(), rhs.cols()), r, d;
+        m_iter = 0;
+        m_error = 0;
+        m_info = m_low->info();
+        if (gsEigen::Success != m_info)
+            return x.setZero();
+
+        for (index_t c = 0; c != rhs.cols(); ++c)
+        {
+            const T normB = rhs.col(c).template lpNorm<gsEigen::Infinity>();
+            x.col(c) = lowSolve(rhs.col(c));
+            T err, errOld = std::numeric_limits<T>::max();
+            index_t k = 0;
+            for (;; ++k)
+            {
+                r.noalias() = rhs.col(c) - m_matrix * x.col(c);
+                const T den = m_normA * x.col(c).template lpNorm<gsEigen::Infinity>() + normB;
+                err = (0 == den ? T(0) : r.template lpNorm<gsEigen::Infinity>() / den);
+                // stop at convergence or when the error stagnates
+                if (err <= m_tol || k == m_maxIter || err > errOld / 2)
+                    break;
+                if (m_restart > 0)
+                    fgmres(r, d);
+                else
+                    d = lowSolve(r);
+                x.col(c) += d;
+                errOld = err;
+            }
+            m_iter  = std::max(m_iter, k);
+            m_error = std::max(m_error, err);
+        }
+        m_info = (m_error <= m_tol ? gsEigen::Success : gsEigen::NoConvergence);
+        return x;
+    }
+
+    bool succeed() const { return gsEigen::Success == m_info; }
+
+    int info() const { return m_info; }
+
+    /// Sets the tolerance for the normwise backward error
+    void setTolerance(const T tol) { m_tol = tol; }
+
+    /// Sets the maximum number of refinement steps
+    void setMaxIterations(const index_t maxIter) { m_maxIter = maxIter; }
+
+    /// Computes the corrections by at most \a restart iterations of
+    /// flexible GMRES, until the relative residual of the correction
+    /// is below \a innerTol; the value 0 switches back to plain
+    /// iterative refinement.
+    void setKrylov(const index_t restart, const T innerTol = T(1e-4))
+    {
+        m_restart  = restart;
+        m_innerTol = innerTol;
+    }
+
+    /// The maximum number of refinement steps of the last solve
+    index_t iterations() const { return m_iter; }
+
+    /// The normwise backward error of the last solve
+    T error() const { return m_error; }
+
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "MixedPrecision(";
+        m_low->print(os);
+        os << ")";
+        return os;
+    }
+
+private:
+
+    void setMatrix(const MatrixT &matrix)
+    {
+        m_matrix = matrix;
+        m_normA  = (matrix.cwiseAbs() * VectorT::Ones(matrix.cols(), 1)).maxCoeff();
+    }
+
+    /// Applies the low precision solver to \a v, which is scaled to
+    /// avoid underflow in LowT
+    template<class Derived>
+    VectorT lowSolve(const gsEigen::MatrixBase<Derived> & v) const
+    {
+        const T s = v.template lpNorm<gsEigen::Infinity>();
+        if (0 == s)
+            return VectorT::Zero(v.rows(), v.cols());
+        const LowVectorT vl = (v / s).template cast<LowT>();
+        return s * m_low->solve(vl).template cast<T>();
+    }
+
+    /// Flexible GMRES for A d = r, right-preconditioned by lowSolve()
+    void fgmres(const VectorT & r, VectorT & d) const
+    {
+        const index_t n = r.rows();
+        const T beta = r.norm();
+        gsMatrix<T> V(n, m_restart + 1), Z(n, m_restart), H;
+        H.setZero(m_restart + 1, m_restart);
+        gsVector<T> e, y, w;
+        V.col(0) = r / beta;
+        index_t j = 0;
+        while (j < m_restart)
+        {
+            Z.col(j) = lowSolve(V.col(j));
+            w.noalias() = m_matrix * Z.col(j);
+            for (index_t i = 0; i <= j; ++i) // modified Gram-Schmidt
+            {
+                H(i, j) = V.col(i).dot(w);
+                w -= H(i, j) * V.col(i);
+            }
+            H(j + 1, j) = w.norm();
+            ++j;
+
+            e.setZero(j + 1);
+            e[0] = beta;
+            y = H.topLeftCorner(j + 1, j).colPivHouseholderQr().solve(e);
+            if (0 == H(j, j - 1) ||
+                (e - H.topLeftCorner(j + 1, j) * y).norm() <= m_innerTol * beta)
+                break;
+            V.col(j) = w / H(j, j - 1);
+        }
+        d.noalias() = Z.leftCols(j) * y;
+    }
+
+private:
+    typename gsSparseSolver<LowT>::uPtr m_low;
+
+    // The matrix in working precision and its infinity norm
+    MatrixT m_matrix;
+    T m_normA;
+
+    T m_tol;
+    index_t m_maxIter, m_restart;
+    T m_innerTol;
+
+    mutable index_t m_iter;
+    mutable T m_error;
+    mutable int m_info;
+};
+
 }
+
+#include <gsMatrix/gsSparseSolverCache.h>
@@ -0,0 +1,266 @@
+/** @file gsSparseSolverCache.h
+
+    @brief Cache of sparse factorizations, keyed by the sparsity pattern
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <mutex>
+
+namespace gismo {
+
+/** @brief Process-wide cache of sparse solvers (factorizations).
+
+    The entries are sparse solvers together with a copy of the matrix
+    they were computed for, and are looked up by the solver name and a
+    hash of the sparsity pattern. A request with
+
+    - the same matrix (pattern and values) shares the factorization
+      of the entry,
+
+    - the same pattern only, reuses the symbolic analysis of an entry
+      which is not in use and computes the numerical factorization,
+
+    - otherwise, computes a new solver.
+
+    The least recently used entries which are not in use are evicted
+    when the memory of the cache exceeds the budget. The memory of an
+    entry is estimated as three times the storage of its matrix (the
+    copy, and the factors).
+
+    Use it by gsSparseSolver<T>::get("Cached<Name>"), e.g.
+    "CachedSimplicialLDLT", which returns a gsCachedSparseSolver.
+
+    \ingroup Matrix
+*/
+template<typename T>
+class gsSparseSolverCache
+{
+public:
+    typedef gsSparseMatrix<T> MatrixT;
+    typedef memory::shared_ptr<gsSparseSolver<T> > SolverPtr;
+
+private:
+    struct Entry
+    {
+        std::string name;
+        size_t      hash;
+        MatrixT     matrix;
+        SolverPtr   solver;
+        size_t      bytes;
+    };
+    typedef typename std::list<Entry>::iterator iterator;
+
+    gsSparseSolverCache()
+    : m_budget(size_t(256) << 20), m_bytes(0), m_hits(0), m_patternHits(0), m_misses(0)
+    { }
+
+public:
+
+    /// The cache for the scalar type T
+    static gsSparseSolverCache & get()
+    {
+        static gsSparseSolverCache cache;
+        return cache;
+    }
+
+    /// Returns a solver \a name computed for \a matrix
+    SolverPtr acquire(const std::string & name, const MatrixT & matrix)
+    {
+        const MatrixT * mat = &matrix;
+        MatrixT tmp;
+        if (!matrix.isCompressed())
+        {
+            tmp = matrix;
+            tmp.makeCompressed();
+            mat = &tmp;
+        }
+        const size_t h = patternHash(*mat);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        iterator free = m_entries.end();
+        for (iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            if (it->name != name || it->hash != h || !samePattern(it->matrix, *mat))
+                continue;
+            if (sameValues(it->matrix, *mat))
+            {
+                ++m_hits;
+                m_entries.splice(m_entries.begin(), m_entries, it);
+                return it->solver;
+            }
+            if (free == m_entries.end() && 1 == it->solver.use_count())
+                free = it;
+        }
+
+        if (free != m_entries.end())
+        {
+            ++m_patternHits;
+            free->solver->factorize(*mat);
+            free->matrix = *mat;
+            m_entries.splice(m_entries.begin(), m_entries, free);
+            return free->solver;
+        }
+
+        ++m_misses;
+        Entry e;
+        e.name   = name;
+        e.hash   = h;
+        e.matrix = *mat;
+        e.solver = SolverPtr(gsSparseSolver<T>::get(name).release());
+        e.solver->analyzePattern(*mat);
+        e.solver->factorize(*mat);
+        e.bytes  = 3 * mat->nonZeros() * (sizeof(T) + sizeof(index_t));
+        m_bytes += e.bytes;
+        m_entries.push_front(give(e));
+        evict();
+        return m_entries.front().solver;
+    }
+
+    /// Sets the memory budget in bytes
+    void setMemoryBudget(const size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_budget = bytes;
+        evict();
+    }
+
+    /// The memory budget in bytes
+    size_t memoryBudget() const { return m_budget; }
+
+    /// The estimated memory of the entries in bytes
+    size_t memory() const { return m_bytes; }
+
+    /// The number of entries
+    size_t size() const { return m_entries.size(); }
+
+    /// The number of requests that shared a factorization
+    size_t hits() const { return m_hits; }
+
+    /// The number of requests that reused a symbolic analysis
+    size_t patternHits() const { return m_patternHits; }
+
+    /// The number of requests that computed a new solver
+    size_t misses() const { return m_misses; }
+
+    /// Removes all entries (the solvers in use stay valid) and resets
+    /// the statistics
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_bytes = m_hits = m_patternHits = m_misses = 0;
+    }
+
+private:
+
+    // Evicts least recently used entries which are not in use, until
+    // the memory is within the budget
+    void evict()
+    {
+        for (iterator it = m_entries.end(); m_bytes > m_budget && it != m_entries.begin(); )
+        {
+            --it;
+            if (1 == it->solver.use_count())
+            {
+                m_bytes -= it->bytes;
+                it = m_entries.erase(it);
+            }
+        }
+    }
+
+    static size_t patternHash(const MatrixT & m)
+    {
+        size_t h = std::hash<index_t>()(m.rows()) ^ (std::hash<index_t>()(m.cols()) << 1);
+        const index_t * p = m.outerIndexPtr(), * pEnd = p + m.outerSize() + 1;
+        for (; p != pEnd; ++p)
+            h ^= std::hash<index_t>()(*p) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        p = m.innerIndexPtr(); pEnd = p + m.nonZeros();
+        for (; p != pEnd; ++p)
+            h ^= std::hash<index_t>()(*p) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+
+    static bool samePattern(const MatrixT & a, const MatrixT & b)
+    {
+        return a.rows() == b.rows() && a.cols() == b.cols() && a.nonZeros() == b.nonZeros()
+            && std::equal(a.outerIndexPtr(), a.outerIndexPtr() + a.outerSize() + 1, b.outerIndexPtr())
+            && std::equal(a.innerIndexPtr(), a.innerIndexPtr() + a.nonZeros(), b.innerIndexPtr());
+    }
+
+    static bool sameValues(const MatrixT & a, const MatrixT & b)
+    { return std::equal(a.valuePtr(), a.valuePtr() + a.nonZeros(), b.valuePtr()); }
+
+private:
+    std::list<Entry> m_entries; // most recently used first
+    std::mutex m_mutex;
+    size_t m_budget, m_bytes;
+    size_t m_hits, m_patternHits, m_misses;
+};
+
+/** @brief Sparse solver which takes its factorizations from the
+    gsSparseSolverCache.
+
+    \ingroup Matrix
+*/
+template<typename T>
+class gsCachedSparseSolver : public gsSparseSolver<T>
+{
+    typedef typename gsSparseSolver<T>::MatrixT MatrixT;
+    typedef typename gsSparseSolver<T>::VectorT VectorT;
+
+public:
+
+    /// Constructs the solver, where \a name is the name of the cached
+    /// solver, cf. gsSparseSolver::get()
+    explicit gsCachedSparseSolver(const std::string & name = "SimplicialLDLT")
+    : m_name(name)
+    { }
+
+    gsCachedSparseSolver& compute (const MatrixT &matrix)
+    {
+        m_solver.reset(); // release the entry for reuse
+        m_solver = gsSparseSolverCache<T>::get().acquire(m_name, matrix);
+        return *this;
+    }
+
+    // The symbolic analysis is reused by the cache
+    gsCachedSparseSolver& analyzePattern (const MatrixT &)
+    { return *this; }
+
+    gsCachedSparseSolver& factorize (const MatrixT &matrix)
+    { return compute(matrix); }
+
+    VectorT solve (const VectorT &rhs) const
+    {
+        GISMO_ASSERT(m_solver, "compute() was not called");
+        return m_solver->solve(rhs);
+    }
+
+    bool succeed() const { return m_solver && m_solver->succeed(); }
+
+    int info() const
+    { return m_solver ? m_solver->info() : (int)gsEigen::InvalidInput; }
+
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "Cached(" << m_name << ")";
+        return os;
+    }
+
+private:
+    std::string m_name;
+    typename gsSparseSolverCache<T>::SolverPtr m_solver;
+};
+
+} // namespace gismo
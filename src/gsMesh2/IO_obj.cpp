@@ -1,5 +1,7 @@
 
 #include <gsMesh2/IO.h>
+#include <gsIO/gsMappedFile.h>
+#include <numeric>
 
 #include <cstdio>
 
@@ -13,159 +15,142 @@ namespace gismo {
 //== IMPLEMENTATION ===========================================================
 
 
+namespace {
+
+// Parses one vertex of a face, "v", "v/vt", "v//vn" or "v/vt/vn",
+// returns false at the end of the line
+bool parseObjCorner(const char *& p, const char * end, index_t & v, index_t & vt)
+{
+    internal::skipBlanks(p, end);
+    if (!internal::parseInt(p, end, v)) return false;
+    vt = 0;
+    if (p != end && '/' == *p)
+    {
+        ++p;
+        internal::parseInt(p, end, vt);
+        if (p != end && '/' == *p)
+        {
+            ++p;
+            index_t vn;
+            internal::parseInt(p, end, vn);
+        }
+    }
+    return true;
+}
+
+}
+
+
 bool read_obj(gsSurfMesh& mesh, const std::string& filename)
 {
-    char   s[200];
-    float  x, y, z;
     std::vector<gsSurfMesh::Vertex>  vertices;
-    std::vector<Texture_coordinate> all_tex_coords;   //individual texture coordinates
-    std::vector<int> halfedge_tex_idx; //texture coordinates sorted for halfedges
     gsSurfMesh::Halfedge_property <Texture_coordinate> tex_coords = mesh.halfedge_property<Texture_coordinate>("h:texcoord", Texture_coordinate(0,0,0));
-    bool with_tex_coord=false;
 
     // clear mesh
     mesh.clear();
 
 
-    // open file (in ASCII mode)
-    FILE* in = fopen(filename.c_str(), "r");
-    if (!in) return false;
+    // map file
+    gsMappedFile file(filename);
+    if (!file.isOpen()) return false;
+    const char * end = file.end();
 
 
-    // clear line once
-    memset(&s, 0, 200);
-
-
-    // parse line by line (currently only supports vertex positions & faces
-    while(in && !feof(in) && fgets(s, 200, in))
+    // locate the lines of vertices, texture coordinates and faces
+    // (currently only supports vertex positions, texture coordinates & faces)
+    std::vector<const char*> vLines, vtLines, fLines;
+    for (const char * p = file.data(); p != end; internal::skipLine(p, end))
     {
         // comment
-        if (s[0] == '#' || isspace(s[0])) continue;
-
-        // vertex
-        else if (strncmp(s, "v ", 2) == 0)
-        {
-            if (sscanf(s, "v %f %f %f", &x, &y, &z))
-            {
-                mesh.add_vertex(Point(x,y,z));
-            }
-        }
-        // normal
-        else if (strncmp(s, "vn ", 3) == 0)
-        {
-          if (sscanf(s, "vn %f %f %f", &x, &y, &z))
-          {
-            // problematic as it can be either a vertex property when interpolated
-            // or a halfedge property for hard edges
-          }
-        }
-
-        // texture coordinate
-        else if (strncmp(s, "vt ", 3) == 0)
-        {
-          if (sscanf(s, "vt %f %f", &x, &y))
-          {
-            z=1;
-            all_tex_coords.push_back(Texture_coordinate(x,y,z));
-          }
-        }
-
-        // face
-        else if (strncmp(s, "f ", 2) == 0)
-        {
-          int component(0), nV(0);
-          bool endOfVertex(false);
-          char *p0, *p1(s+1);
-
-          vertices.clear();
-          halfedge_tex_idx.clear();
+        if (*p == '#' || isspace(*p)) continue;
+        else if (end - p > 2 && p[0] == 'v' && p[1] == ' ')
+            vLines.push_back(p + 2);
+        else if (end - p > 3 && p[0] == 'v' && p[1] == 't' && p[2] == ' ')
+            vtLines.push_back(p + 3);
+        else if (end - p > 2 && p[0] == 'f' && p[1] == ' ')
+            fLines.push_back(p + 2);
+        // normals are problematic as they can be either a vertex
+        // property when interpolated or a halfedge property for hard
+        // edges
+    }
+    const index_t nV  = vLines.size();
+    const index_t nVt = vtLines.size();
+    const index_t nF  = fLines.size();
 
-          // skip white-spaces
-          while (*p1==' ') ++p1;
 
-          while (p1)
-          {
-            p0 = p1;
+    // parse vertices and texture coordinates
+    std::vector<real_t> xyz(3*nV, 0), uv(2*nVt, 0);
+#pragma omp parallel for
+    for (index_t i=0; i<nV; ++i)
+    {
+        const char * p = vLines[i];
+        for (index_t k=0; k!=3; ++k)
+            internal::parseReal(p, end, xyz[3*i+k]);
+    }
+#pragma omp parallel for
+    for (index_t i=0; i<nVt; ++i)
+    {
+        const char * p = vtLines[i];
+        for (index_t k=0; k!=2; ++k)
+            internal::parseReal(p, end, uv[2*i+k]);
+    }
 
-            // overwrite next separator
 
-            // skip '/', '\n', ' ', '\0', '\r' <-- don't forget Windows
-            while (*p1!='/' && *p1!='\r' && *p1!='\n' && *p1!=' ' && *p1!='\0') ++p1;
+    // parse faces: count the corners, then read the (1-based) indices
+    std::vector<index_t> fstart(nF+1, 0);
+#pragma omp parallel for
+    for (index_t i=0; i<nF; ++i)
+    {
+        const char * p = fLines[i];
+        index_t v, vt;
+        while (parseObjCorner(p, end, v, vt)) ++fstart[i+1];
+    }
+    std::partial_sum(fstart.begin(), fstart.end(), fstart.begin());
+    std::vector<index_t> fv(fstart.back()), fvt(fstart.back());
+#pragma omp parallel for
+    for (index_t i=0; i<nF; ++i)
+    {
+        const char * p = fLines[i];
+        for (index_t j=fstart[i]; j!=fstart[i+1]; ++j)
+            parseObjCorner(p, end, fv[j], fvt[j]);
+    }
 
-            // detect end of vertex
-            if (*p1 != '/')
-            {
-              endOfVertex = true;
-            }
 
-            // replace separator by '\0'
-            if (*p1 != '\0')
-            {
-              *p1 = '\0';
-              p1++; // point to next token
-            }
+    // build the mesh
+    mesh.reserve(nV, 3*nV, nF);
+    for (index_t i=0; i<nV; ++i)
+        mesh.add_vertex(Point(xyz[3*i], xyz[3*i+1], xyz[3*i+2]));
 
-            // detect end of line and break
-            if (*p1 == '\0' || *p1 == '\n')
-            {
-              p1 = 0;
-            }
+    for (index_t i=0; i<nF; ++i)
+    {
+        vertices.clear();
+        bool with_tex_coord = (fstart[i]!=fstart[i+1]);
+        for (index_t j=fstart[i]; j!=fstart[i+1]; ++j)
+        {
+            vertices.push_back( gsSurfMesh::Vertex(fv[j] - 1) );
+            with_tex_coord = with_tex_coord && 0 < fvt[j] && fvt[j] <= nVt;
+        }
 
-            // read next vertex component
-            if (*p0 != '\0')
-            {
-              switch (component)
-              {
-                case 0: // vertex
-                {
-                  vertices.push_back( gsSurfMesh::Vertex(atoi(p0) - 1) );
-                  break;
-                }
-                case 1: // texture coord
-                {
-                  int idx = atoi(p0)-1;
-                  halfedge_tex_idx.push_back(idx);
-                  with_tex_coord=true;
-                  break;
-                }
-                case 2: // normal
-                  break;
-              }
-            }
+        gsSurfMesh::Face f=mesh.add_face(vertices);
 
-            ++component;
 
-            if (endOfVertex)
+        // add texture coordinates
+        if(with_tex_coord && f.is_valid())
+        {
+            gsSurfMesh::Halfedge_around_face_circulator h_fit = mesh.halfedges(f);
+            gsSurfMesh::Halfedge_around_face_circulator h_end = h_fit;
+            index_t j = fstart[i];
+            do
             {
-              component = 0;
-              nV++;
-              endOfVertex = false;
+                const index_t t = fvt[j] - 1;
+                tex_coords[*h_fit]=Texture_coordinate(uv[2*t], uv[2*t+1], 1);
+                ++j;
+                ++h_fit;
             }
-          }
-
-          gsSurfMesh::Face f=mesh.add_face(vertices);
-
-
-          // add texture coordinates
-          if(with_tex_coord)
-          {
-              gsSurfMesh::Halfedge_around_face_circulator h_fit = mesh.halfedges(f);
-              gsSurfMesh::Halfedge_around_face_circulator h_end = h_fit;
-              unsigned v_idx =0;
-              do
-              {
-                  tex_coords[*h_fit]=all_tex_coords.at(halfedge_tex_idx.at(v_idx));
-                  ++v_idx;
-                  ++h_fit;
-              }
-              while(h_fit!=h_end);
-          }
+            while(h_fit!=h_end);
         }
-        // clear line
-        memset(&s, 0, 200);
     }
 
-    fclose(in);
     return true;
 }
 
@@ -1,5 +1,7 @@
 
 #include <gsMesh2/IO.h>
+#include <gsIO/gsMappedFile.h>
+#include <numeric>
 
 #include <cstdio>
 
@@ -163,22 +165,66 @@ bool read_off_ascii(gsSurfMesh& mesh,
 }
 
 
+//-----------------------------------------------------------------------------
+
+
 bool read_off_ascii(gsSurfMesh& mesh,
-                    FILE* in,
+                    const char* p,
+                    const char* end,
                     const bool has_normals,
                     const bool has_texcoords,
                     const bool has_colors)
 {
-//    std::fstream fs;
-//    fs.getline(in, sizeof buffer );
+    // #Vertice, #Faces, #Edges
+    index_t nV(0), nF(0), nE(0);
+    internal::skipEmptyLines(p, end);
+    if (!internal::parseInt(p, end, nV) || !internal::parseInt(p, end, nF))
+        return false;
+    internal::parseInt(p, end, nE);
+    internal::skipLine(p, end);
 
-    char                 line[200], *lp;
-    int                  nc;
-    unsigned int         i, j, items, idx;
-    unsigned int         nV, nF, nE;
-    Point                p, n, c;
-    Vec2f                t;
-    gsSurfMesh::Vertex v;
+    // Locate the lines of the vertices and faces (serial, but fast),
+    // which are then parsed in parallel
+    std::vector<const char*> lines(nV + nF);
+    for (index_t i=0; i<nV+nF; ++i)
+    {
+        internal::skipEmptyLines(p, end);
+        if (p == end) return false;
+        lines[i] = p;
+        internal::skipLine(p, end);
+    }
+
+    // read vertices: pos [normal] [color] [texcoord]
+    const index_t nAttr = 3 + (has_normals ? 3 : 0) + (has_colors ? 3 : 0) + (has_texcoords ? 2 : 0);
+    std::vector<real_t> vdata(nAttr * nV, 0);
+#pragma omp parallel for
+    for (index_t i=0; i<nV; ++i)
+    {
+        const char * lp = lines[i];
+        for (index_t k=0; k!=nAttr; ++k)
+            internal::parseReal(lp, end, vdata[nAttr*i+k]);
+    }
+
+    // read faces: #N v[1] v[2] ... v[n-1]
+    std::vector<index_t> fstart(nF+1, 0);
+#pragma omp parallel for
+    for (index_t i=0; i<nF; ++i)
+    {
+        const char * lp = lines[nV+i];
+        internal::parseInt(lp, end, fstart[i+1]);
+    }
+    std::partial_sum(fstart.begin(), fstart.end(), fstart.begin());
+    std::vector<index_t> fdata(fstart.back());
+#pragma omp parallel for
+    for (index_t i=0; i<nF; ++i)
+    {
+        const char * lp = lines[nV+i];
+        index_t n;
+        internal::parseInt(lp, end, n);
+        for (index_t j=fstart[i]; j!=fstart[i+1]; ++j)
+            internal::parseInt(lp, end, fdata[j]);
+    }
+    std::vector<const char*>().swap(lines);
 
     // properties
     gsSurfMesh::Vertex_property<Normal>              normals;
@@ -188,87 +234,43 @@ bool read_off_ascii(gsSurfMesh& mesh,
     if (has_texcoords) texcoords = mesh.vertex_property<Texture_coordinate>("v:texcoord",Point(0,0,0));
     if (has_colors)    colors    = mesh.vertex_property<Color>("v:color",Color(0,0,0));
 
-
-    // #Vertice, #Faces, #Edges
-    items = fscanf(in, "%d %d %d\n", (int*)&nV, (int*)&nF, (int*)&nE);
-    (void)items;
     mesh.clear();
     mesh.reserve(nV, std::max(3*nV, nE), nF);
 
-
-    // read vertices: pos [normal] [color] [texcoord]
-    for (i=0; i<nV && !feof(in); ++i)
+    gsSurfMesh::Vertex v;
+    for (index_t i=0; i<nV; ++i)
     {
-        // read line
-        lp = fgets(line, 200, in);
-        lp = line;
-
-        // position
-        items = sscanf(lp, "%f %f %f%n", (float*)&p[0], (float*)&p[1], (float*)&p[2], &nc);
-        assert(items==3);
-        v = mesh.add_vertex(p.cast<gsSurfMesh::Scalar>());
-        lp += nc;
-
-        // normal
+        const real_t * d = &vdata[nAttr*i];
+        v = mesh.add_vertex(Point(d[0], d[1], d[2]));
+        d += 3;
         if (has_normals)
         {
-            if (sscanf(lp, "%f %f %f%n", (float*)&n[0], (float*)&n[1], (float*)&n[2], &nc) == 3)
-            {
-                normals[v] = n;
-            }
-            lp += nc;
+            normals[v] = Normal(d[0], d[1], d[2]);
+            d += 3;
         }
-
-        // color
         if (has_colors)
         {
-            if (sscanf(lp, "%f %f %f%n", (float*)&c[0], (float*)&c[1], (float*)&c[2], &nc) == 3)
-            {
-                if (c[0]>1.0f || c[1]>1.0f || c[2]>1.0f) c *= (1.0/255.0);
-                colors[v] = c;
-            }
-            lp += nc;
+            Color c(d[0], d[1], d[2]);
+            if (c[0]>1.0f || c[1]>1.0f || c[2]>1.0f) c *= (1.0/255.0);
+            colors[v] = c;
+            d += 3;
         }
-
-        // tex coord
         if (has_texcoords)
         {
-            items = sscanf(lp, "%f %f%n", (float*)&t[0], (float*)&t[1], &nc);
-            assert(items == 2);
-            texcoords[v][0] = t[0];
-            texcoords[v][1] = t[1];
-            lp += nc;
+            texcoords[v][0] = d[0];
+            texcoords[v][1] = d[1];
         }
     }
 
-
-
-    // read faces: #N v[1] v[2] ... v[n-1]
     std::vector<gsSurfMesh::Vertex> vertices;
-    for (i=0; i<nF; ++i)
+    for (index_t i=0; i<nF; ++i)
     {
-        // read line
-        lp = fgets(line, 200, in);
-        lp = line;
-
-        // #vertices
-        items = sscanf(lp, "%d%n", (int*)&nV, &nc);
-        assert(items == 1);
-        vertices.resize(nV);
-        lp += nc;
-
-        // indices
-        for (j=0; j<nV; ++j)
-        {
-            items = sscanf(lp, "%d%n", (int*)&idx, &nc);
-            assert(items == 1);
-            vertices[j] = gsSurfMesh::Vertex(idx);
-            lp += nc;
-        }
+        vertices.clear();
+        for (index_t j=fstart[i]; j!=fstart[i+1]; ++j)
+            vertices.push_back(gsSurfMesh::Vertex(fdata[j]));
         mesh.add_face(vertices);
     }
 
-
     return true;
 }
 
@@ -365,48 +367,43 @@ bool read_off(gsSurfMesh& mesh, const std::string& filename)
     bool  is_binary     = false;
 
 
-    // open file (in ASCII mode)
-    FILE* in = fopen(filename.c_str(), "r");
-    if (!in) return false;
+    // map the file
+    gsMappedFile file(filename);
+    if (!file.isOpen()) return false;
 
 
     // read header: [ST][C][N][4][n]OFF BINARY
-    char *c = fgets(line, 200, in);
-    assert(c != NULL);
-    c = line;
+    const char * p = file.data();
+    internal::skipLine(p, file.end());
+    const size_t len = std::min<size_t>(p - file.data(), 199);
+    std::memcpy(line, file.data(), len);
+    line[len] = '\0';
+    char *c = line;
     if (c[0] == 'S' && c[1] == 'T') { has_texcoords = true; c += 2; }
     if (c[0] == 'C') { has_colors  = true; ++c; }
     if (c[0] == 'N') { has_normals = true; ++c; }
     if (c[0] == '4') { has_hcoords = true; ++c; }
     if (c[0] == 'n') { has_dim     = true; ++c; }
-    if (strncmp(c, "OFF", 3) != 0) { fclose(in); return false; } // no OFF
+    if (strncmp(c, "OFF", 3) != 0) return false; // no OFF
     if (strncmp(c+4, "BINARY", 6) == 0) is_binary = true;
 
 
     // homogeneous coords, and vertex dimension != 3 are not supported
     if (has_hcoords || has_dim)
-    {
-        fclose(in);
         return false;
-    }
-
-
-    // if binary: reopen file in binary mode
-    if (is_binary)
-    {
-        fclose(in);
-        in = fopen(filename.c_str(), "rb");
-        c = fgets(line, 200, in);
-        assert(c != NULL);
-    }
 
 
-    // read as ASCII or binary
-    bool ok = (is_binary ?
-               read_off_binary(mesh, in, has_normals, has_texcoords, has_colors) :
-               read_off_ascii(mesh, in, has_normals, has_texcoords, has_colors));
+    // ASCII is parsed in place
+    if (!is_binary)
+        return read_off_ascii(mesh, p, file.end(), has_normals, has_texcoords, has_colors);
 
 
+    // binary
+    FILE* in = fopen(filename.c_str(), "rb");
+    if (!in) return false;
+    c = fgets(line, 200, in);
+    assert(c != NULL);
+    bool ok = read_off_binary(mesh, in, has_normals, has_texcoords, has_colors);
     fclose(in);
     return ok;
 }
@@ -2,11 +2,13 @@
 //== INCLUDES =================================================================
 
 #include <gsMesh2/IO.h>
+#include <gsIO/gsMappedFile.h>
 
 #include <cstdio>
-#include <cfloat>
-#include <map>
+#include <cstring>
 #include <fstream>
+#include <numeric>
+#include <unordered_map>
 
 
 //== NAMESPACES ===============================================================
@@ -18,42 +20,110 @@ namespace gismo {
 //== IMPLEMENTATION ===========================================================
 
 
-// helper function
-template <typename T> void read(FILE* in, T& t)
-{
-    size_t n_items(0);
-    (void)n_items;
-    n_items = fread((char*)&t, 1, sizeof(t), in);
-    assert(n_items > 0);
-}
+namespace {
 
+// Key of a vertex position: the bit patterns of its coordinates, equal
+// keys mean equal positions
+struct stlKey
+{
+    uint32_t c[3];
+    bool operator==(const stlKey & o) const
+    { return c[0]==o.c[0] && c[1]==o.c[1] && c[2]==o.c[2]; }
+};
 
-//-----------------------------------------------------------------------------
+inline stlKey stlMakeKey(const float * p)
+{
+    stlKey k;
+    for (int i=0; i!=3; ++i)
+    {
+        const float v = (0 == p[i] ? 0.0f : p[i]); // -0 == +0
+        std::memcpy(&k.c[i], &v, sizeof(float));
+    }
+    return k;
+}
 
+struct stlKeyHash
+{
+    size_t operator()(const stlKey & k) const
+    {
+        uint64_t h = k.c[0];
+        h = h * 0x9E3779B97F4A7C15ULL ^ k.c[1];
+        h = h * 0x9E3779B97F4A7C15ULL ^ k.c[2];
+        h ^= h >> 31; h *= 0xBF58476D1CE4E5B9ULL; h ^= h >> 29;
+        return static_cast<size_t>(h);
+    }
+};
 
-// helper class for STL reader
-class CmpVec
+// Welds the triangle corners with equal positions (given in xyz).
+// On output, vid[c] is the vertex of corner c and first[v] is the
+// first corner of vertex v, the vertices are numbered in order of
+// first appearance.
+void weldCorners(const std::vector<float> & xyz,
+                 std::vector<index_t> & vid, std::vector<index_t> & first)
 {
-public:
+    const index_t nc = static_cast<index_t>(xyz.size() / 3);
+    const stlKeyHash hash;
+    std::vector<size_t> h(nc);
+#pragma omp parallel for
+    for (index_t c = 0; c < nc; ++c)
+        h[c] = hash(stlMakeKey(&xyz[3*c]));
+
+    // Sort the corners in buckets by hash (stable counting sort)
+    const index_t nb = 64 * omp_get_max_threads();
+    std::vector<index_t> start(nb+1, 0), order(nc);
+    for (index_t c = 0; c != nc; ++c)
+        ++start[h[c] % nb + 1];
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::vector<index_t> pos(start.begin(), start.end()-1);
+    for (index_t c = 0; c != nc; ++c)
+        order[pos[h[c] % nb]++] = c;
+
+    // The buckets are welded independently, rep[c] is the first
+    // corner at the position of c
+    std::vector<index_t> rep(nc);
+#pragma omp parallel for schedule(dynamic)
+    for (index_t b = 0; b < nb; ++b)
+    {
+        std::unordered_map<stlKey, index_t, stlKeyHash> seen;
+        seen.reserve(start[b+1] - start[b]);
+        for (index_t i = start[b]; i != start[b+1]; ++i)
+        {
+            const index_t c = order[i];
+            rep[c] = seen.insert(std::make_pair(stlMakeKey(&xyz[3*c]), c)).first->second;
+        }
+    }
 
-    CmpVec(float _eps=FLT_MIN) : eps_(_eps) {}
+    vid.resize(nc);
+    first.clear();
+    for (index_t c = 0; c != nc; ++c)
+        if (rep[c] == c)
+        {
+            vid[c] = static_cast<index_t>(first.size());
+            first.push_back(c);
+        }
+        else
+            vid[c] = vid[rep[c]]; // rep[c] < c
+}
 
-    bool operator()(const Point& v0, const Point& v1) const
+// Parses the vertex coordinates of the ASCII STL lines in [p,end)
+void parseStlAscii(const char * p, const char * end, std::vector<float> & xyz)
+{
+    while (p != end)
     {
-        if (math::abs(v0[0] - v1[0]) <= eps_)
+        internal::skipSpace(p, end);
+        if (end - p > 6 && (0 == strncmp(p, "vertex", 6) || 0 == strncmp(p, "VERTEX", 6)))
         {
-            if (math::abs(v0[1] - v1[1]) <= eps_)
-            {
-                return (v0[2] < v1[2] - eps_);
-            }
-            else return (v0[1] < v1[1] - eps_);
+            p += 6;
+            float v;
+            for (int i = 0; i != 3; ++i)
+                if (internal::parseReal(p, end, v))
+                    xyz.push_back(v);
         }
-        return (v0[0] < v1[0] - eps_);
+        internal::skipLine(p, end);
     }
+}
 
-private:
-    float eps_;
-};
+}
 
 
 //-----------------------------------------------------------------------------
@@ -61,141 +131,75 @@ private:
 
 bool read_stl(gsSurfMesh& mesh, const std::string& filename)
 {
-    char                             line[100], *c;
-    unsigned int                     i, nT;
-    Point                            p;
-    gsSurfMesh::Vertex               v;
-    std::vector<gsSurfMesh::Vertex>  vertices(3);
-    size_t n_items(0);
-    (void)n_items;
-    
-    CmpVec comp(FLT_MIN);
-    std::map<Point, gsSurfMesh::Vertex, CmpVec>            vMap(comp);
-    std::map<Point, gsSurfMesh::Vertex, CmpVec>::iterator  vMapIt;
-
-
     // clear mesh
     mesh.clear();
 
-
-    // open file (in ASCII mode)
-    FILE* in = fopen(filename.c_str(), "r");
-    if (!in) return false;
-
-
-    // ASCII or binary STL?
-    c = fgets(line, 6, in);
-    assert(c != NULL);
-    const bool binary = ((strncmp(line, "SOLID", 5) != 0) &&
-                         (strncmp(line, "solid", 5) != 0));
-
-
-    // parse binary STL
+    gsMappedFile file(filename);
+    if (!file.isOpen() || file.size() < 15) return false;
+    const char * data = file.data();
+
+    // Binary STL: 80 bytes header, number of triangles, 50 bytes per
+    // triangle. The size check detects binary files with a header
+    // starting with "solid"
+    uint32_t nT = 0;
+    if (file.size() >= 84)
+        std::memcpy(&nT, data + 80, sizeof(uint32_t));
+    const bool binary = (file.size() >= 84 && 84 + 50 * uint64_t(nT) == file.size()) ||
+                        ((strncmp(data, "SOLID", 5) != 0) && (strncmp(data, "solid", 5) != 0));
+
+    // Triangle corner positions
+    std::vector<float> xyz;
     if (binary)
     {
-        // re-open file in binary mode
-        fclose(in);
-        in = fopen(filename.c_str(), "rb");
-        if (!in) return false;
-
-        // skip dummy header
-        n_items = fread(line, 1, 80, in);
-        assert(n_items > 0);
-
-        // read number of triangles
-        read(in, nT);
-
-        // read triangles
-        while (nT)
+        if (file.size() < 84 + 50 * uint64_t(nT)) return false;
+        xyz.resize(9 * size_t(nT));
+        const index_t n = nT;
+#pragma omp parallel for
+        for (index_t t = 0; t < n; ++t) // skip the normal and the attribute
+            std::memcpy(&xyz[9*t], data + 84 + 50*size_t(t) + 12, 9 * sizeof(float));
+    }
+    else
+    {
+        // Chunks of lines are parsed in parallel
+        const index_t nc = omp_get_max_threads();
+        std::vector<const char*> bounds(nc+1, file.end());
+        bounds[0] = data;
+        for (index_t i = 1; i < nc; ++i)
         {
-            // skip triangle normal
-            n_items = fread(line, 1, 12, in);
-            assert(n_items > 0);
-            // triangle's vertices
-            for (i=0; i<3; ++i)
-            {
-                read(in, p);
-
-                // has vector been referenced before?
-                if ((vMapIt=vMap.find(p)) == vMap.end())
-                {
-                    // No : add vertex and remember idx/vector mapping
-                    v = mesh.add_vertex(p.cast<gsSurfMesh::Scalar>());
-                    vertices[i] = v;
-                    vMap[p] = v;
-                }
-                else
-                {
-                    // Yes : get index from map
-                    vertices[i] = vMapIt->second;
-                }
-            }
-
-            // Add face only if it is not degenerated
-            if ((vertices[0] != vertices[1]) &&
-                (vertices[0] != vertices[2]) &&
-                (vertices[1] != vertices[2]))
-                mesh.add_face(vertices);
-
-            n_items = fread(line, 1, 2, in);
-            assert(n_items > 0);
-            --nT;
+            const char * b = std::max(bounds[i-1], data + i * (file.size() / nc));
+            internal::skipLine(b, file.end());
+            bounds[i] = b;
         }
+        std::vector<std::vector<float> > parts(nc);
+#pragma omp parallel for
+        for (index_t i = 0; i < nc; ++i)
+            parseStlAscii(bounds[i], bounds[i+1], parts[i]);
+
+        for (index_t i = 0; i != nc; ++i)
+            xyz.insert(xyz.end(), parts[i].begin(), parts[i].end());
+        xyz.resize(xyz.size() - xyz.size() % 9);
+        nT = static_cast<uint32_t>(xyz.size() / 9);
     }
 
+    std::vector<index_t> vid, first;
+    weldCorners(xyz, vid, first);
 
-    // parse ASCII STL
-    else
+    const index_t nV = static_cast<index_t>(first.size());
+    mesh.reserve(nV, nV + nT, nT);
+    for (index_t v = 0; v != nV; ++v)
     {
-        // parse line by line
-        while (in && !feof(in) && fgets(line, 100, in))
-        {
-            // skip white-space
-            for (c=line; isspace(*c) && *c!='\0'; ++c) {};
-
-            // face begins
-            if ((strncmp(c, "outer", 5) == 0) ||
-                (strncmp(c, "OUTER", 5) == 0))
-            {
-                // read three vertices
-                for (i=0; i<3; ++i)
-                {
-                    // read line
-                    c = fgets(line, 100, in);
-                    assert(c != NULL);
-
-                    // skip white-space
-                    for (c=line; isspace(*c) && *c!='\0'; ++c) {};
-
-                    // read x, y, z
-                    sscanf(c+6, "%f %f %f", (float*)&p[0], (float*)&p[1], (float*)&p[2]);
-
-                    // has vector been referenced before?
-                    if ((vMapIt=vMap.find(p)) == vMap.end())
-                    {
-                        // No : add vertex and remember idx/vector mapping
-                        v = mesh.add_vertex(p.cast<gsSurfMesh::Scalar>());
-                        vertices[i] = v;
-                        vMap[p] = v;
-                    }
-                    else
-                    {
-                        // Yes : get index from map
-                        vertices[i] = vMapIt->second;
-                    }
-                }
-
-                // Add face only if it is not degenerated
-                if ((vertices[0] != vertices[1]) &&
-                    (vertices[0] != vertices[2]) &&
-                    (vertices[1] != vertices[2]))
-                    mesh.add_face(vertices);
-            }
-        }
+        const float * p = &xyz[3*first[v]];
+        mesh.add_vertex(Point(p[0], p[1], p[2]));
     }
 
+    for (uint32_t t = 0; t != nT; ++t)
+    {
+        const gsSurfMesh::Vertex v0(vid[3*t]), v1(vid[3*t+1]), v2(vid[3*t+2]);
+        // Add face only if it is not degenerated
+        if (v0 != v1 && v0 != v2 && v1 != v2)
+            mesh.add_triangle(v0, v1, v2);
+    }
 
-    fclose(in);
     return true;
 }
 
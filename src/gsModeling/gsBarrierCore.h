@@ -28,6 +28,8 @@
 #include <gsAssembler/gsExprAssembler.h>
 
 
+#include <gsOptimizer/gsNewtonKrylov.h>
+
 #ifdef gsHLBFGS_ENABLED
 #include <gsHLBFGS/gsHLBFGS.h>
 #endif
@@ -97,6 +99,66 @@ void setOptimizerOptions(gsHLBFGS<T> &optimizer, const gsOptionList &options) {
 }
 #endif
 
+/// helper function to create the optimizer of a step of the barrier
+/// method, the options are read with the prefix \a pre ("ff_" or "qi_")
+template<typename T>
+memory::unique_ptr<gsOptimizer<T> >
+makeBarrierOptimizer(gsOptProblem<T> &problem, const gsOptionList &options,
+                     const std::string &pre, const T &tol) {
+  memory::unique_ptr<gsOptimizer<T> > optimizer;
+#ifdef gsHLBFGS_ENABLED
+  if (!options.askSwitch("NewtonKrylov", false)) {
+    optimizer.reset(new gsHLBFGS<T>(&problem));
+    optimizer->options().setReal("MinGradLen",
+                                 options.askReal(pre + "MinGradientLength", tol));
+    optimizer->options().setReal("MinStepLen",
+                                 options.askReal(pre + "MinStepLength", tol));
+  } else
+#endif
+  {
+    optimizer.reset(new gsNewtonKrylov<T>(&problem));
+    optimizer->options().setReal("MinGradientLength",
+                                 options.askReal(pre + "MinGradientLength", tol));
+    optimizer->options().setReal("MinStepLength",
+                                 options.askReal(pre + "MinStepLength", tol));
+  }
+  optimizer->options().setInt("MaxIterations",
+                              options.askInt(pre + "MaxIterations", 1e4));
+  optimizer->options().setInt("Verbose", options.askInt("Verbose", 0));
+  return optimizer;
+}
+
+/// Sparsity pattern of the Hessian of an energy integrated on the
+/// elements of \a mb, with respect to the free control points of
+/// \a mapper (all the components of the functions acting on an
+/// element are coupled)
+template<typename T>
+gsSparseMatrix<T> hessianPattern(const gsMultiBasis<T> &mb,
+                                 const gsDofMapper &mapper,
+                                 const short_t dim) {
+  gsSparseEntries<T> entries;
+  gsMatrix<index_t> act;
+  std::vector<index_t> dofs;
+  for (size_t p = 0; p != mb.nBases(); ++p) {
+    typename gsBasis<T>::domainIter domIt = mb.basis(p).makeDomainIterator();
+    for (; domIt->good(); domIt->next()) {
+      mb.basis(p).active_into(domIt->centerPoint(), act);
+      dofs.clear();
+      for (short_t c = 0; c != dim; ++c)
+        for (index_t i = 0; i != act.rows(); ++i)
+          if (mapper.is_free(act(i, 0), p, c))
+            dofs.push_back(mapper.index(act(i, 0), p, c));
+      for (size_t i = 0; i != dofs.size(); ++i)
+        for (size_t j = 0; j != dofs.size(); ++j)
+          entries.add(dofs[i], dofs[j], 1);
+    }
+  }
+  gsSparseMatrix<T> pattern(mapper.freeSize(), mapper.freeSize());
+  pattern.setFrom(entries);
+  pattern.makeCompressed();
+  return pattern;
+}
+
 /// helper function to verbose log
 inline void verboseLog(const std::string &message, const index_t &verbose) {
   if (verbose > 0) { gsInfo << message << "\n"; }
@@ -182,7 +244,6 @@ class gsBarrierCore
                                  const gsOptionList &options);
 };
 
-#ifdef gsHLBFGS_ENABLED
 template<short_t d, typename T = real_t>
 class gsObjFoldoverFree : public gsOptProblem<T> {
 
@@ -202,6 +263,11 @@ class gsObjFoldoverFree : public gsOptProblem<T> {
   void gradObj_into(const gsAsConstVector<T> &u,
                     gsAsVector<T> &result) const override;
 
+  /// Computes the sparse Hessian of the objective function at the
+  /// given point u, by finite differences of the gradient
+  bool hessObj_into(const gsAsConstVector<T> &u,
+                    gsSparseMatrix<T> &result) const override;
+
   void setDelta(const T &delta) { m_eps = delta; };
 
   /// Returns the options list for the class instance.
@@ -226,6 +292,8 @@ class gsObjFoldoverFree : public gsOptProblem<T> {
 
   gsOptionList m_options;
 
+  mutable gsSparseMatrix<T> m_pattern;
+
   T m_eps = T (1e-2);
 };
 
@@ -247,6 +315,11 @@ class gsObjQualityImprovePt : public gsOptProblem<T> {
   void gradObj_into(const gsAsConstVector<T> &u,
                     gsAsVector<T> &result) const override;
 
+  /// Computes the sparse Hessian of the objective function at the
+  /// given point u, by finite differences of the gradient
+  bool hessObj_into(const gsAsConstVector<T> &u,
+                    gsSparseMatrix<T> &result) const override;
+
   /// Returns the options list for the class instance.
   gsOptionList options() { return m_options; }
 
@@ -301,9 +374,12 @@ class gsObjQualityImprovePt : public gsOptProblem<T> {
 
   gsOptionList m_options;
 
+  mutable gsSparseMatrix<T> m_pattern;
+
   T m_lambda1 = 1.0, m_lambda2 = 1.0;
 };
 
+#ifdef gsHLBFGS_ENABLED
 template<short_t d, typename T>
 class gsObjVHPt : public gsOptProblem<T> {
  private:
@@ -58,6 +58,12 @@ gsOptionList gsBarrierCore<d, T>::defaultOptions() {
                   "Min step length for quality improvement",
                   1e-4);
 
+  // Optimizer of the barrier method: gsHLBFGS (default, if available) or
+  // trust-region Newton-Krylov with finite difference Hessians
+  options.addSwitch("NewtonKrylov",
+                    "Use the Newton-Krylov optimizer for the barrier method",
+                    false);
+
   // Set quadrature rules for objective function and gradient evaluation
   options.addReal("quA",
                   "Quadrature points: quA*deg + quB; For patchRule: Order of target space",
@@ -156,12 +162,7 @@ gsMultiPatch<T> gsBarrierCore<d, T>::compute(const gsMultiPatch<T> &mp,
       break;
     }
     case ParamMethod::BarrierPatch: {
-#ifdef gsHLBFGS_ENABLED
       result = computeBarrierPatch(mp, mapper, options);
-#else
-      GISMO_ERROR("BarrierPatch not available without gsHLBFGS. Please "
-                  "compile with gsHLBGFS enabled");
-#endif
       break;
     }
     case ParamMethod::VariationalHarmonicPatch: {
@@ -286,6 +287,8 @@ gsBarrierCore<d, T>::computePenaltyPatch2(const gsMultiPatch<T> &mp,
   return result;
 }
 
+#endif
+
 template<short_t d, typename T>
 gsMultiPatch<T>
     gsBarrierCore<d,T>::computeBarrierPatch(const gsMultiPatch<T> &mp,
@@ -325,25 +328,18 @@ void gsBarrierCore<d, T>::foldoverElimination(const gsMultiPatch<T> &mp,
   gsObjFoldoverFree<d, T> objFoldoverFree(mp, mapper);
   objFoldoverFree.addOptions(options);
 
-  gsHLBFGS<T> optFoldoverFree(&objFoldoverFree);
-  optFoldoverFree.options().setInt("MaxIterations",
-                                   options.askInt("ff_MaxIterations", 1e4));
-  optFoldoverFree.options().setReal("MinGradLen",
-                                    options.askReal("ff_MinGradientLength",
-                                                    1e-12));
-  optFoldoverFree.options().setReal("MinStepLen",
-                                    options.askReal("ff_MinStepLength", 1e-12));
-  optFoldoverFree.options().setInt("Verbose", options.askInt("Verbose", 0));
+  memory::unique_ptr<gsOptimizer<T> > optFoldoverFree =
+      makeBarrierOptimizer<T>(objFoldoverFree, options, "ff_", 1e-12);
 
   T Efoldover = std::numeric_limits<T>::max();
   for (index_t it = 0; it < MAX_ITER; ++it) {
     T delta = pow(0.1, it) * 5e-2 * scaledArea; // parameter delta
     objFoldoverFree.setDelta(delta);
 
-    optFoldoverFree.solve(initialGuessVector);
+    optFoldoverFree->solve(initialGuessVector);
 
-    Efoldover = optFoldoverFree.objective();
-    initialGuessVector = optFoldoverFree.currentDesign();
+    Efoldover = optFoldoverFree->objective();
+    initialGuessVector = optFoldoverFree->currentDesign();
 
     if (Efoldover <= EPSILON) { break; }
   }
@@ -373,11 +369,11 @@ void gsBarrierCore<d, T>::qualityImprovement(const gsMultiPatch<T> &mp,
                       1.0 / pow(scaledArea, 2));
   objQualityImprovePt.applyOptions(thisOptions);
 
-  gsHLBFGS<T> optQualityImprovePt(&objQualityImprovePt);
-  setOptimizerOptions<T>(optQualityImprovePt, options);
+  memory::unique_ptr<gsOptimizer<T> > optQualityImprovePt =
+      makeBarrierOptimizer<T>(objQualityImprovePt, options, "qi_", 1e-4);
 
-  optQualityImprovePt.solve(initialGuessVector);
-  initialGuessVector = optQualityImprovePt.currentDesign();
+  optQualityImprovePt->solve(initialGuessVector);
+  initialGuessVector = optQualityImprovePt->currentDesign();
 }
 
 template<short_t d, typename T>
@@ -445,6 +441,15 @@ void gsObjFoldoverFree<d, T>::gradObj_into(const gsAsConstVector<T> &u,
             result.data());
 }
 
+template<short_t d, typename T>
+bool gsObjFoldoverFree<d, T>::hessObj_into(const gsAsConstVector<T> &u,
+                                           gsSparseMatrix<T> &result) const {
+  if (0 == m_pattern.rows())
+    m_pattern = hessianPattern(m_mb, m_mapper, d);
+  this->hessObjFD_into(u, m_pattern, result);
+  return true;
+}
+
 template<short_t d, typename T>
 gsObjQualityImprovePt<d, T>::gsObjQualityImprovePt(
     const gsMultiPatch<T> &patches,
@@ -528,6 +533,15 @@ void gsObjQualityImprovePt<d, T>::gradObj_into(const gsAsConstVector<T> &u,
   gradObj_into_impl<d>(u, result);
 }
 
+template<short_t d, typename T>
+bool gsObjQualityImprovePt<d, T>::hessObj_into(const gsAsConstVector<T> &u,
+                                               gsSparseMatrix<T> &result) const {
+  if (0 == m_pattern.rows())
+    m_pattern = hessianPattern(m_mb, m_mapper, d);
+  this->hessObjFD_into(u, m_pattern, result);
+  return true;
+}
+
 template<short_t d, typename T>
 template<short_t _d>
 typename std::enable_if<_d == 2, T>::type
@@ -586,6 +600,7 @@ gsObjQualityImprovePt<d, T>::gradObj_into_impl(const gsAsConstVector<T> &u,
   return EXIT_SUCCESS;
 }
 
+#ifdef gsHLBFGS_ENABLED
 template<short_t d, typename T>
 gsObjVHPt<d, T>::gsObjVHPt(const gsMultiPatch<T> &patches,
                            gsDofMapper mapper)
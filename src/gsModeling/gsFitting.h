@@ -15,6 +15,7 @@
 #pragma once
 
 #include <gsCore/gsForwardDeclarations.h>
+#include <gsIO/gsOptionList.h>
 #include <gsMSplines/gsMappedBasis.h>
 #include <gsMSplines/gsMappedSpline.h>
 
@@ -36,6 +37,8 @@ public:
     {
         m_basis = nullptr;
         m_result= nullptr;
+        m_streamCount = 0;
+        m_options = defaultOptions();
     }
 
     /** @brief gsFitting: Main constructor of the fitting class
@@ -53,16 +56,98 @@ public:
               gsVector<index_t>  offset,
               gsMappedBasis<2,T>  & mbasis) ;
 
+    /// @brief gsFitting: Constructor for fitting a point cloud which
+    /// is streamed in chunks, see streamPoints()
+    explicit gsFitting(gsBasis<T> & basis);
+
     /// Destructor
     virtual ~gsFitting();
 
 public:
 
+    /// Returns the default options of the fitting
+    ///
+    /// Solver: the sparse solver for the (symmetric positive
+    /// definite) normal equations, see gsSparseSolver::get(). Direct
+    /// solvers are SimplicialLDLT, SimplicialLLT and, if enabled,
+    /// PardisoLLT/PardisoLDLT or SuperLU; iterative ones are
+    /// CGDiagonal, CGIncompleteCholesky and BiCGSTABILUT. Systems with
+    /// constraints are saddle point problems and are always solved
+    /// with BiCGSTABILUT.
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addString("Solver", "Sparse solver for the normal equations", "SimplicialLDLT");
+        return opt;
+    }
+
+    /// Returns the options, which are applied in the next computation
+    gsOptionList & options() { return m_options; }
+
     /** @brief compute: Computes the coefficients of the spline geometry via penalized least squares
     * @param lambda smoothing weight
     */
     void compute(T lambda = 0);
 
+    /** @brief computeGridded: Computes the least squares fit of data
+    * sampled on the tensor grid \a grid, without assembling the
+    * global system. The basis must be a tensor-product basis of
+    * dimension grid.size().
+    *
+    * The least squares matrix of gridded data is the Kronecker
+    * product of the 1D matrices of the directions, therefore the fit
+    * is computed by 1D factorizations applied direction by direction
+    * (see gsKroneckerOp). compute() switches to this method
+    * automatically if the parameters form a tensor grid, there is no
+    * smoothing and there are no constraints.
+    * @param grid the 1D parameters of each direction, strictly increasing
+    * @param values the values to be fitted, one column per grid point;
+    * the first direction runs fastest, as in gsPointGrid
+    */
+    void computeGridded(const std::vector<gsVector<T> > & grid,
+                        const gsMatrix<T> & values);
+
+    /** @brief streamPoints: Accumulates the least squares system of the
+    * points \a points with parameters \a param_values (one point per
+    * column), without storing them. The memory needed is proportional
+    * to the size of the basis, not to the number of points.
+    * The points are accumulated in parallel.
+    * @param param_values the parameters of the points
+    * @param points the points to be fitted
+    */
+    void streamPoints(const gsMatrix<T> & param_values, const gsMatrix<T> & points);
+
+    /** @brief streamCsv: Streams the points of a .csv file, in chunks
+    * of \a chunkSize points. Each row holds the parameters followed
+    * by the coordinates of a point.
+    */
+    void streamCsv(const std::string & filename, index_t chunkSize = 65536);
+
+    /** @brief streamBinary: Streams the points of a binary file, in
+    * chunks of \a chunkSize points. The file contains one record of
+    * values of type T per point: the parameters followed by the \a
+    * dim coordinates.
+    */
+    void streamBinary(const std::string & filename, index_t dim,
+                      index_t chunkSize = 65536);
+
+    /** @brief computeStreamed: Computes the coefficients of the spline
+    * geometry from the streamed points via penalized least squares
+    * @param lambda smoothing weight
+    */
+    void computeStreamed(T lambda = 0);
+
+    /// Discards the streamed points
+    void resetStream()
+    {
+        m_streamA.clear();
+        m_streamB.clear();
+        m_streamCount = 0;
+    }
+
+    /// Returns the number of points streamed so far
+    index_t numStreamedPoints() const { return m_streamCount; }
+
     /** @brief updateGeometry: Updates the fitted geometry with new coefficients and parameters
     * @param coefficients the new coefficients
     * @param parameters the new parameters
@@ -173,6 +258,10 @@ public:
     /// \a type = 0: point-wise infinity/maximum norm
     void get_Error(std::vector<T>& errors, int type = 0) const;
 
+    /// Computes the point-wise errors in parallel, in euclidean
+    /// norm if \a norm = 0, in infinity/maximum norm if \a norm = 1
+    void pointErrors(std::vector<T>& errors, int norm = 0) const;
+
     /// Returns the minimum point-wise error from the pount cloud (or zero if not fitted)
     T minPointError() const { return m_min_error; }
 
@@ -314,6 +403,38 @@ private:
     /// Extends the system of equations by taking constraints into account.
     void extendSystem(gsSparseMatrix<T>& A_mat, gsMatrix<T>& m_B);
 
+    /// Solves the system \a A_mat * \a x = \a B with the solver of
+    /// the options (or BiCGSTABILUT if \a spd is false). The solver
+    /// is kept, and its factorization is reused as long as the matrix
+    /// does not change (eg. only the points, not the parameters, change).
+    bool solveSystem(const gsSparseMatrix<T> & A_mat, const gsMatrix<T> & B,
+                     gsMatrix<T> & x, bool spd = true);
+
+    /// Prepares one least squares system per thread with \a dim
+    /// right-hand sides; existing systems keep their sparsity pattern
+    void initThreadSystems(std::vector<gsSparseMatrix<T> > & A,
+                           std::vector<gsMatrix<T> > & B, index_t dim) const;
+
+    /// Accumulates the least squares system of the points with
+    /// indices \a first,...,\a first+\a num-1 into the thread-private
+    /// systems \a A, \a B in parallel. The k-th point is \a points.row(k)
+    /// with parameters \a params.col(k)
+    template<class Points>
+    void accumulateSystem(const gsBasis<T> & basis, const gsMatrix<T> & params,
+                          const Points & points, index_t first, index_t num,
+                          std::vector<gsSparseMatrix<T> > & A,
+                          std::vector<gsMatrix<T> > & B) const;
+
+    /// Extracts the 1D parameters \a grid if the parameter values
+    /// form a tensor grid, with the first direction running fastest
+    bool griddedParameters(std::vector<gsVector<T> > & grid) const;
+
+    /// Solves the least squares problem of the gridded data \a values
+    /// (one row per grid point) by 1D factorizations. Returns false if
+    /// the basis is not a tensor basis or a 1D system is singular.
+    bool solveGridded(const std::vector<gsVector<T> > & grid,
+                      const gsMatrix<T> & values, gsMatrix<T> & x) const;
+
 protected:
 
     /// Assembles 3xblock collocation matrix.
@@ -339,7 +460,8 @@ protected:
 
 protected:
 
-    //gsOptionList
+    /// Options, see defaultOptions()
+    gsOptionList m_options;
 
     /// the parameter values of the point cloud
     gsMatrix<T> m_param_values;
@@ -387,6 +509,22 @@ protected:
 
     T m_uMin, m_uMax, m_vMin, m_vMax;
 
+    /// Thread-private parts of the streamed least squares system
+    std::vector<gsSparseMatrix<T> > m_streamA;
+    std::vector<gsMatrix<T> >       m_streamB;
+
+    /// Number of streamed points
+    index_t m_streamCount;
+
+    /// Thread-private parts of the least squares system of assembleSystem()
+    std::vector<gsSparseMatrix<T> > m_threadA;
+    std::vector<gsMatrix<T> >       m_threadB;
+
+    /// The last solver, its name and the matrix it was factorized for
+    typename gsSparseSolver<T>::uPtr m_solver;
+    std::string                      m_solverName;
+    gsSparseMatrix<T>                m_solverMatrix;
+
 private:
     //void applySmoothing(T lambda, gsMatrix<T> & A_mat);
 
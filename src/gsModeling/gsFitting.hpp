@@ -21,6 +21,10 @@
 #include <gsAssembler/gsExprEvaluator.h>
 #include <gsNurbs/gsBSpline.h>
 #include <gsTensor/gsTensorDomainIterator.h>
+#include <gsSolver/gsKroneckerOp.h>
+#include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsProductOp.h>
+#include <gsIO/gsCsv.h>
 
 #include <gsModeling/gsModelingUtils.hpp>
 
@@ -53,6 +57,19 @@ gsFitting<T>::  gsFitting(gsMatrix<T> const & param_values,
     m_offset.resize(2);
     m_offset[0] = 0;
     m_offset[1] = m_points.rows();
+    m_streamCount = 0;
+    m_options = defaultOptions();
+}
+
+
+// constructor
+template<class T>
+gsFitting<T>::gsFitting(gsBasis<T> & basis)
+{
+    m_result = nullptr;
+    m_basis = &basis;
+    m_streamCount = 0;
+    m_options = defaultOptions();
 }
 
 
@@ -69,6 +86,8 @@ gsFitting<T>::gsFitting(gsMatrix<T> const& param_values,
     m_basis = &mbasis;
     m_points.transposeInPlace();
     m_offset = give(offset);
+    m_streamCount = 0;
+    m_options = defaultOptions();
 }
 
 
@@ -82,6 +101,18 @@ void gsFitting<T>::compute(T lambda)
   // Wipe out previous result
   if ( m_result!=nullptr )
       delete m_result;
+  m_result = nullptr;
+
+  // Gridded data: the system is a Kronecker product of 1D systems
+  const gsBasis<T> * tb = dynamic_cast<const gsBasis<T> *>(m_basis);
+  std::vector<gsVector<T> > grid;
+  gsMatrix<T> xg;
+  if ( 0 == lambda && 0 == m_constraintsLHS.rows() && nullptr != tb &&
+       griddedParameters(grid) && solveGridded(grid, m_points, xg) )
+  {
+      m_result = tb->makeGeometry( give(xg) ).release();
+      return;
+  }
 
   const int num_basis = m_basis->size();
   const short_t dimension = m_points.cols();
@@ -120,18 +151,10 @@ void gsFitting<T>::compute(T lambda)
   //Solving the system of linear equations A*x=b (works directly for a right side which has a dimension with higher than 1)
   A_mat.makeCompressed();
 
-  typename gsSparseSolver<T>::BiCGSTABILUT solver( A_mat );
-
-  if ( solver.preconditioner().info() != gsEigen::Success )
-  {
-      gsWarn<<  "The preconditioner failed. Aborting.\n";
-
-      return;
-  }
   //Solves for many right hand side  columns
   gsMatrix<T> x;
-
-  x = solver.solve(m_B); //toDense()
+  if ( !solveSystem(A_mat, m_B, x, 0 == m_constraintsLHS.rows()) )
+      return;
 
   // If there were constraints, we obtained too many coefficients.
   x.conservativeResize(num_basis, gsEigen::NoChange);
@@ -149,6 +172,340 @@ void gsFitting<T>::compute(T lambda)
 }
 
 
+// solve the normal equations, reusing the last factorization if possible
+template<class T>
+bool gsFitting<T>::solveSystem(const gsSparseMatrix<T> & A_mat,
+                               const gsMatrix<T> & B, gsMatrix<T> & x, bool spd)
+{
+    const std::string name = spd ? m_options.getString("Solver") : "BiCGSTABILUT";
+
+    // Same solver and same matrix: only the right-hand side changed
+    const bool reuse = m_solver && name == m_solverName &&
+        A_mat.isCompressed() && m_solverMatrix.rows() == A_mat.rows() &&
+        m_solverMatrix.nonZeros() == A_mat.nonZeros() &&
+        std::equal(A_mat.outerIndexPtr(), A_mat.outerIndexPtr() + A_mat.outerSize() + 1,
+                   m_solverMatrix.outerIndexPtr()) &&
+        std::equal(A_mat.innerIndexPtr(), A_mat.innerIndexPtr() + A_mat.nonZeros(),
+                   m_solverMatrix.innerIndexPtr()) &&
+        std::equal(A_mat.valuePtr(), A_mat.valuePtr() + A_mat.nonZeros(),
+                   m_solverMatrix.valuePtr());
+
+    if (!reuse)
+    {
+        m_solver = gsSparseSolver<T>::get(name);
+        m_solverName = name;
+        m_solver->compute(A_mat);
+        if ( !m_solver->succeed() )
+        {
+            m_solver.reset();
+            if ("BiCGSTABILUT" == name)
+            {
+                gsWarn<<  "The preconditioner failed. Aborting.\n";
+                return false;
+            }
+            gsWarn<< "The solver "<< name <<" failed, the system is not positive "
+                  "definite. Using BiCGSTABILUT.\n";
+            return solveSystem(A_mat, B, x, false);
+        }
+        m_solverMatrix = A_mat;
+        m_solverMatrix.makeCompressed();
+    }
+
+    x = m_solver->solve(B);
+    return true;
+}
+
+
+// fit gridded data by 1D factorizations
+template<class T>
+void gsFitting<T>::computeGridded(const std::vector<gsVector<T> > & grid,
+                                  const gsMatrix<T> & values)
+{
+    const gsBasis<T> * bb = dynamic_cast<const gsBasis<T> *>(m_basis);
+    GISMO_ENSURE(nullptr != bb, "Gridded fitting needs a tensor-product basis.");
+    GISMO_ENSURE(static_cast<index_t>(grid.size()) == bb->dim(),
+                 "The grid dimension does not match the basis.");
+    m_last_lambda = 0;
+
+    if ( m_result!=nullptr )
+        delete m_result;
+    m_result = nullptr;
+
+    gsMatrix<T> x;
+    GISMO_ENSURE( solveGridded(grid, values.transpose(), x),
+                  "Gridded fitting failed: the basis is not a tensor basis or "
+                  "the grid does not satisfy the Schoenberg-Whitney conditions.");
+    m_result = bb->makeGeometry( give(x) ).release();
+}
+
+
+// detect parameters lying on a tensor grid
+template<class T>
+bool gsFitting<T>::griddedParameters(std::vector<gsVector<T> > & grid) const
+{
+    const index_t d = m_param_values.rows();
+    const index_t N = m_param_values.cols();
+    if (0 == N) return false;
+
+    // The grid lines of direction k are the parameters at the multiples
+    // of the stride of k, as long as they increase
+    grid.resize(d);
+    index_t stride = 1;
+    for (index_t k = 0; k != d; ++k)
+    {
+        index_t n = 1;
+        while ( n * stride < N &&
+                m_param_values(k, n * stride) > m_param_values(k, (n - 1) * stride) )
+            ++n;
+        grid[k].resize(n);
+        for (index_t j = 0; j != n; ++j)
+            grid[k][j] = m_param_values(k, j * stride);
+        stride *= n;
+    }
+    if (stride != N) return false;
+
+    // Verify all points
+    stride = 1;
+    for (index_t k = 0; k != d; ++k)
+    {
+        const index_t n = grid[k].size();
+        for (index_t i = 0; i != N; ++i)
+            if ( m_param_values(k, i) != grid[k][(i / stride) % n] )
+                return false;
+        stride *= n;
+    }
+    return true;
+}
+
+
+// solve the gridded least squares problem direction by direction
+template<class T>
+bool gsFitting<T>::solveGridded(const std::vector<gsVector<T> > & grid,
+                                const gsMatrix<T> & values, gsMatrix<T> & x) const
+{
+    typedef typename gsSparseSolver<T>::SimplicialLDLT Cholesky;
+    const gsBasis<T> & basis = *static_cast<const gsBasis<T> *>(m_basis);
+    const short_t d = basis.dim();
+
+    bool isTensor = false;
+    switch (d)
+    {
+    case 1: isTensor = (nullptr != dynamic_cast<const gsTensorBasis<1,T>*>(&basis)); break;
+    case 2: isTensor = (nullptr != dynamic_cast<const gsTensorBasis<2,T>*>(&basis)); break;
+    case 3: isTensor = (nullptr != dynamic_cast<const gsTensorBasis<3,T>*>(&basis)); break;
+    case 4: isTensor = (nullptr != dynamic_cast<const gsTensorBasis<4,T>*>(&basis)); break;
+    default: break;
+    }
+    if (!isTensor || static_cast<index_t>(grid.size()) != d) return false;
+
+    // One operator (N^T N)^{-1} N^T per direction, in reversed order
+    // for the Kronecker product (the first direction runs fastest)
+    std::vector<typename gsLinearOperator<T>::Ptr> ops(d);
+    index_t numPts = 1;
+    for (short_t i = 0; i != d; ++i)
+    {
+        const short_t k = d - 1 - i;
+        numPts *= grid[k].size();
+        gsSparseMatrix<T> Nt = basis.component(k).collocationMatrix(grid[k].transpose()).transpose();
+        const gsSparseMatrix<T> M = Nt * Nt.transpose();
+
+        typename gsSolverOp<Cholesky>::uPtr solver = makeSparseCholeskySolver(M);
+        const gsVector<T> D = solver->solver().vectorD();
+        if ( solver->solver().info() != gsEigen::Success ||
+             (D.array() <= D.cwiseAbs().maxCoeff() * std::numeric_limits<T>::epsilon() * M.rows()).any() )
+        {
+            gsWarn << "The 1D least squares matrix of direction " << k << " is singular.\n";
+            return false;
+        }
+        ops[i] = gsProductOp<T>::make( makeMatrixOp(Nt.moveToPtr()), give(solver) );
+    }
+    GISMO_ENSURE(numPts == values.rows(), "The number of values does not match the grid, "
+                 << values.rows() << " != " << numPts);
+
+    gsKroneckerOp<T>::apply(ops, values, x);
+    return true;
+}
+
+
+// accumulate the least squares system of a chunk of points
+template<class T>
+void gsFitting<T>::streamPoints(const gsMatrix<T> & param_values,
+                                const gsMatrix<T> & points)
+{
+    GISMO_ASSERT(points.cols()==param_values.cols(), "Pointset dimensions problem "<< points.cols() << " != " <<param_values.cols() );
+    GISMO_ENSURE(1==m_basis->nPieces(), "Streaming is available for single patch bases.");
+
+    // One system per thread, summed up in computeStreamed()
+    if (m_streamA.empty())
+        initThreadSystems(m_streamA, m_streamB, points.rows());
+    GISMO_ASSERT(m_streamB.front().cols()==points.rows(), "The dimension of the points changed.");
+
+    accumulateSystem(m_basis->basis(0), param_values, points.transpose(),
+                     0, points.cols(), m_streamA, m_streamB);
+    m_streamCount += points.cols();
+}
+
+
+// prepare the thread-private least squares systems
+template<class T>
+void gsFitting<T>::initThreadSystems(std::vector<gsSparseMatrix<T> > & A,
+                                     std::vector<gsMatrix<T> > & B,
+                                     index_t dim) const
+{
+    const index_t num_basis = m_basis->size();
+    if (A.empty() || A.front().rows() != num_basis)
+    {
+        int nonZerosPerCol = 1;
+        for (short_t i = 0; i < m_basis->domainDim(); ++i)
+            nonZerosPerCol *= 2 * m_basis->basis(0).degree(i) + 1;
+        A.assign(omp_get_max_threads(), gsSparseMatrix<T>(num_basis, num_basis));
+        for (size_t t = 0; t != A.size(); ++t)
+            A[t].reservePerColumn(nonZerosPerCol);
+    }
+    else // keep the sparsity pattern of the previous assembly
+    {
+        for (size_t t = 0; t != A.size(); ++t)
+            for (index_t k = 0; k < A[t].outerSize(); ++k)
+                for (typename gsSparseMatrix<T>::InnerIterator it(A[t],k); it; ++it)
+                    it.valueRef() = 0;
+    }
+    gsMatrix<T> zero;
+    zero.setZero(num_basis, dim);
+    B.assign(A.size(), zero);
+}
+
+
+// accumulate the least squares system of the points first,..,first+num-1
+template<class T>
+template<class Points>
+void gsFitting<T>::accumulateSystem(const gsBasis<T> & basis,
+                                    const gsMatrix<T> & params,
+                                    const Points & points,
+                                    index_t first, index_t num,
+                                    std::vector<gsSparseMatrix<T> > & A,
+                                    std::vector<gsMatrix<T> > & B) const
+{
+    // Points are evaluated in blocks; the static schedule keeps the
+    // summation order fixed
+    const index_t blockSize = 256;
+    const index_t numBlocks = (num + blockSize - 1) / blockSize;
+#   pragma omp parallel num_threads(A.size())
+    {
+        const int tid = omp_get_thread_num();
+        gsSparseMatrix<T> & A_mat = A[tid];
+        gsMatrix<T> & m_B = B[tid];
+        gsMatrix<T> values;
+        gsMatrix<index_t> actives;
+
+#       pragma omp for schedule(static)
+        for (index_t b = 0; b < numBlocks; ++b)
+        {
+            const index_t k0  = first + b * blockSize;
+            const index_t len = math::min(blockSize, first + num - k0);
+            basis.eval_into(params.middleCols(k0, len), values);
+            basis.active_into(params.middleCols(k0, len), actives);
+
+            for (index_t k = 0; k != len; ++k)
+            {
+                for (index_t i = 0; i != actives.rows(); ++i)
+                {
+                    const index_t ii = actives(i,k);
+                    m_B.row(ii) += values(i,k) * points.row(k0+k);
+                    for (index_t j = 0; j != actives.rows(); ++j)
+                        A_mat(ii, actives(j,k)) += values(i,k) * values(j,k);
+                }
+            }
+        }
+    }
+}
+
+
+// stream the points of a csv file
+template<class T>
+void gsFitting<T>::streamCsv(const std::string & filename, index_t chunkSize)
+{
+    std::ifstream file(filename.c_str());
+    GISMO_ENSURE(file.good(), "Cannot open file "<< filename);
+    const index_t pdim = m_basis->domainDim();
+    gsMatrix<T> chunk;
+    while (gsReadCsvRows(file, chunk, chunkSize))
+    {
+        GISMO_ENSURE(chunk.cols() > pdim, "Too few columns in "<< filename);
+        streamPoints(chunk.leftCols(pdim).transpose(),
+                     chunk.rightCols(chunk.cols() - pdim).transpose());
+    }
+}
+
+
+// stream the points of a binary file
+template<class T>
+void gsFitting<T>::streamBinary(const std::string & filename, index_t dim,
+                                index_t chunkSize)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    GISMO_ENSURE(file.good(), "Cannot open file "<< filename);
+    const index_t pdim = m_basis->domainDim();
+    const index_t len  = pdim + dim;
+    std::vector<T> buf(len * chunkSize);
+    for (;;)
+    {
+        file.read(reinterpret_cast<char*>(buf.data()), buf.size() * sizeof(T));
+        const index_t num_pts = file.gcount() / (len * sizeof(T));
+        if (0 == num_pts) break;
+        gsAsConstMatrix<T> records(buf.data(), len, num_pts);
+        streamPoints(records.topRows(pdim), records.bottomRows(dim));
+    }
+}
+
+
+// compute the fit from the streamed points
+template<class T>
+void gsFitting<T>::computeStreamed(T lambda)
+{
+    GISMO_ENSURE(!m_streamA.empty(), "No points were streamed.");
+    m_last_lambda = lambda;
+
+    // Wipe out previous result
+    if ( m_result!=nullptr )
+        delete m_result;
+    m_result = nullptr;
+
+    const index_t num_basis = m_basis->size();
+    const index_t num_con   = m_constraintsLHS.rows();
+
+    // Sum up the thread-private systems, in a fixed order
+    gsSparseMatrix<T> A_mat = m_streamA.front();
+    gsMatrix<T> m_B = m_streamB.front();
+    for (size_t t = 1; t < m_streamA.size(); ++t)
+    {
+        A_mat += m_streamA[t];
+        m_B   += m_streamB[t];
+    }
+    if (num_con > 0)
+    {
+        A_mat.conservativeResize(num_basis + num_con, num_basis + num_con);
+        m_B.conservativeResize(num_basis + num_con, gsEigen::NoChange);
+    }
+
+    if(lambda > 0)
+      applySmoothing(lambda, A_mat);
+
+    if(num_con > 0)
+      extendSystem(A_mat, m_B);
+
+    A_mat.makeCompressed();
+
+    gsMatrix<T> x;
+    if ( !solveSystem(A_mat, m_B, x, 0 == num_con) )
+        return;
+
+    // If there were constraints, we obtained too many coefficients.
+    x.conservativeResize(num_basis, gsEigen::NoChange);
+
+    m_result = m_basis->basis(0).makeGeometry( give(x) ).release();
+}
+
+
 // update the geometry with the given coefficients and parameters
 template<class T>
 void gsFitting<T>::updateGeometry(gsMatrix<T> coefficients,
@@ -444,16 +801,9 @@ void gsFitting<T>::compute_tdm(T lambda, T mu, T sigma, const std::vector<index_
 
         A_tilde.makeCompressed();
 
-        // typename gsSparseSolver<T>::QR solver(A_tilde);
-        typename gsSparseSolver<T>::BiCGSTABILUT solver( A_tilde );
-        if ( solver.preconditioner().info() != gsEigen::Success )
-        {
-            gsWarn<<  "The preconditioner failed. Aborting.\n";
-
+        gsMatrix<T> sol_tilde;
+        if ( !solveSystem(A_tilde, rhs, sol_tilde) )
             return;
-        }
-
-        gsMatrix<T> sol_tilde = solver.solve(rhs);
 
         // If there were constraints, we obtained too many coefficients.
         sol_tilde.conservativeResize(num_basis * 3, gsEigen::NoChange);
@@ -557,8 +907,8 @@ void gsFitting<T>::parameterProjectionSepBoundary(T accuracy,const std::vector<i
   {
     compute(m_last_lambda);
   }
-//#       pragma omp parallel for default(shared) private(newParam)
   //Parameter projection for interior points
+# pragma omp parallel for
   for (index_t i = 0; i < interpIdx[0]; ++i)
   {
     gsVector<T> newParam;
@@ -574,7 +924,14 @@ void gsFitting<T>::parameterProjectionSepBoundary(T accuracy,const std::vector<i
     }
   }
 
+  // boundary curves
+  typename gsGeometry<T>::uPtr south = m_result->boundary(3);
+  typename gsGeometry<T>::uPtr east  = m_result->boundary(2);
+  typename gsGeometry<T>::uPtr north = m_result->boundary(4);
+  typename gsGeometry<T>::uPtr west  = m_result->boundary(1);
+
   // south boundary parameters: (u,0)
+# pragma omp parallel for
   for (index_t i = interpIdx[0]+1; i < interpIdx[1]; ++i)
   {
     gsVector<> newParam(1,1);
@@ -582,11 +939,10 @@ void gsFitting<T>::parameterProjectionSepBoundary(T accuracy,const std::vector<i
     newParam(0,0) = m_param_values(0,i);
     oldParam(0,0) = m_param_values(0,i);
     const auto & curr = m_points.row(i).transpose();
-    typename gsGeometry<T>::uPtr b = m_result->boundary(3); // south edge
-    b->closestPointTo(curr, newParam, accuracy, true);
+    south->closestPointTo(curr, newParam, accuracy, true);
 
-    if ((b->eval(newParam) - curr).norm()
-            < (b->eval(oldParam) - curr).norm())
+    if ((south->eval(newParam) - curr).norm()
+            < (south->eval(oldParam) - curr).norm())
     {
     m_param_values(0,i) = newParam(0,0);
 
@@ -594,6 +950,7 @@ void gsFitting<T>::parameterProjectionSepBoundary(T accuracy,const std::vector<i
   }
 
   // east boundary parameters: (1,v)
+# pragma omp parallel for
   for (index_t i = interpIdx[1]+1; i < interpIdx[2]; ++i)
   {
     gsVector<> newParam(1,1);
@@ -601,14 +958,14 @@ void gsFitting<T>::parameterProjectionSepBoundary(T accuracy,const std::vector<i
     newParam(0,0) = m_param_values(1,i); // we consider the v of the i-th parameter
     oldParam(0,0) = m_param_values(1,i); // we consider the v of the i-th parameter
     const auto & curr = m_points.row(i).transpose();
-    typename gsGeometry<T>::uPtr b = m_result->boundary(2); // east edge
-    b->closestPointTo(curr, newParam, accuracy, true);
+    east->closestPointTo(curr, newParam, accuracy, true);
 
-    if ((b->eval(newParam) - curr).norm()
-      < (b->eval(oldParam) - curr).norm())
+    if ((east->eval(newParam) - curr).norm()
+      < (east->eval(oldParam) - curr).norm())
         m_param_values(1,i) = newParam(0,0);
   }
   //north boundary parameters: (u,1)
+# pragma omp parallel for
   for (index_t i = interpIdx[2]+1; i < interpIdx[3]; ++i)
   {
     gsVector<> newParam(1,1);
@@ -616,14 +973,14 @@ void gsFitting<T>::parameterProjectionSepBoundary(T accuracy,const std::vector<i
     newParam(0,0) = m_param_values(0,i); // we consider the u of the i-th parameter
     oldParam(0,0) = m_param_values(0,i); // we consider the u of the i-th parameter
     const auto & curr = m_points.row(i).transpose();
-    typename gsGeometry<T>::uPtr b = m_result->boundary(4); // north edge
-    b->closestPointTo(curr, newParam, accuracy, true);
+    north->closestPointTo(curr, newParam, accuracy, true);
 
-    if ((b->eval(newParam) - curr).norm()
-      < (b->eval(oldParam) - curr).norm())
+    if ((north->eval(newParam) - curr).norm()
+      < (north->eval(oldParam) - curr).norm())
       m_param_values(0,i) = newParam(0,0);
   }
   //west boundary parameters: (0,v)
+# pragma omp parallel for
   for (index_t i = interpIdx[3]+1; i < m_points.rows(); ++i)
   {
     gsVector<> newParam(1,1);
@@ -631,11 +988,10 @@ void gsFitting<T>::parameterProjectionSepBoundary(T accuracy,const std::vector<i
     newParam(0,0) = m_param_values(1,i); // we consider the v of the i-th parameter
     oldParam(0,0) = m_param_values(1,i); // we consider the v of the i-th parameter
     const auto & curr = m_points.row(i).transpose();
-    typename gsGeometry<T>::uPtr b = m_result->boundary(1); // west edge
-    b->closestPointTo(curr, newParam, accuracy, true);
+    west->closestPointTo(curr, newParam, accuracy, true);
 
-    if ((b->eval(newParam) - curr).norm()
-        < (b->eval(oldParam) - curr).norm())
+    if ((west->eval(newParam) - curr).norm()
+        < (west->eval(oldParam) - curr).norm())
         m_param_values(1,i) = newParam(0,0);
   }
 }
@@ -658,7 +1014,6 @@ void gsFitting<T>::parameterCorrectionSepBoundary_tdm(T accuracy,
     //const index_t n = m_points.cols();
     for (index_t it = 0; it<maxIter; ++it)
     {
-//#       pragma omp parallel for default(shared) private(newParam)
       parameterProjectionSepBoundary(accuracy, interpIdx); // projection of the points  on the geometry
       compute_tdm(m_last_lambda, mu, sigma, interpIdx, method); // updates of the coefficients with HDM
     }// step of PC
@@ -680,7 +1035,6 @@ void gsFitting<T>::parameterCorrectionSepBoundary_pdm(T accuracy,
     //const index_t n = m_points.cols();
     for (index_t it = 0; it<maxIter; ++it)
     {
-//#  pragma omp parallel for default(shared) private(newParam)
       parameterProjectionSepBoundary(accuracy, interpIdx); // projection of the points  on the geometry
       compute(m_last_lambda); // updates of the coefficients with PDM
     }// step of PC
@@ -702,7 +1056,7 @@ void gsFitting<T>::parameterCorrection(T accuracy,
 
     for (index_t it = 0; it<maxIter; ++it)
     {
-//#       pragma omp parallel for
+#       pragma omp parallel for
         for (index_t i = 0; i<m_points.rows(); ++i)
         //for (index_t i = 1; i<m_points.rows()-1; ++i) //(!curve) skip first last pt
         {
@@ -733,37 +1087,21 @@ void gsFitting<T>::assembleSystem(gsSparseMatrix<T>& A_mat,
 {
     const int num_patches ( m_basis->nPieces() ); //initialize
 
-    //for computing the value of the basis function
-    gsMatrix<T> value, curr_point;
-    gsMatrix<index_t> actives;
+    // Thread-private systems, reusing the sparsity pattern of the
+    // previous call (eg. in parameter correction)
+    initThreadSystems(m_threadA, m_threadB, m_points.cols());
 
     for (index_t h = 0; h < num_patches; h++ )
-    {
-        auto & basis = m_basis->basis(h);
-
-//#   pragma omp parallel for default(shared) private(curr_point,actives,value)
-        for (index_t k = m_offset[h]; k < m_offset[h+1]; ++k)
-        {
-            curr_point = m_param_values.col(k);
-
-            //computing the values of the basis functions at the current point
-            basis.eval_into(curr_point, value);
-
-            // which functions have been computed i.e. which are active
-            basis.active_into(curr_point, actives);
-
-            const index_t numActive = actives.rows();
+        accumulateSystem(m_basis->basis(h), m_param_values, m_points, m_offset[h],
+                         m_offset[h+1] - m_offset[h], m_threadA, m_threadB);
 
-            for (index_t i = 0; i != numActive; ++i)
-            {
-                const index_t ii = actives.at(i);
-//#           pragma omp critical (acc_m_B)
-                m_B.row(ii) += value.at(i) * m_points.row(k);
-                for (index_t j = 0; j != numActive; ++j)
-//#               pragma omp critical (acc_A_mat)
-                    A_mat(ii, actives.at(j)) += value.at(i) * value.at(j);
-            }
-        }
+    // Sum up the thread-private systems, in a fixed order
+    for (size_t t = 0; t != m_threadA.size(); ++t)
+    {
+        m_B.topRows(m_threadB[t].rows()) += m_threadB[t];
+        for (index_t k = 0; k < m_threadA[t].outerSize(); ++k)
+            for (typename gsSparseMatrix<T>::InnerIterator it(m_threadA[t],k); it; ++it)
+                A_mat.coeffRef(it.row(), it.col()) += it.value();
     }
 }
 
@@ -906,21 +1244,17 @@ void gsFitting<T>::applySmoothing(T lambda, gsSparseMatrix<T> & A_mat)
 template<class T>
 void gsFitting<T>::computeErrors()
 {
-    m_pointErrors.clear();
+    const index_t num_pts = m_points.rows();
+    m_pointErrors.resize(num_pts);
 
     gsMatrix<T> val_i;
     m_result->eval_into(m_param_values, val_i);
-    m_pointErrors.push_back( (m_points.row(0) - val_i.col(0).transpose()).norm() );
-    m_max_error = m_min_error = m_pointErrors.back();
+#   pragma omp parallel for
+    for (index_t i = 0; i < num_pts; i++)
+        m_pointErrors[i] = (m_points.row(i) - val_i.col(i).transpose()).norm();
 
-    for (index_t i = 1; i < m_points.rows(); i++)
-    {
-        const T err = (m_points.row(i) - val_i.col(i).transpose()).norm() ;
-        m_pointErrors.push_back(err);
-
-        if ( err > m_max_error ) m_max_error = err;
-        if ( err < m_min_error ) m_min_error = err;
-    }
+    m_min_error = *std::min_element(m_pointErrors.begin(), m_pointErrors.end());
+    m_max_error = *std::max_element(m_pointErrors.begin(), m_pointErrors.end());
 }
 
 
@@ -978,72 +1312,32 @@ std::vector<T> gsFitting<T>::computeErrors(const gsMatrix<> & parameters,const g
 template<class T>
 void gsFitting<T>::computeMaxNormErrors()
 {
-    m_pointErrors.clear();
-    gsMatrix<T> values;
-    const int num_patches(m_basis->nPieces());
-
-    for (index_t h = 0; h < num_patches; h++)
-    {
-        for (index_t k = m_offset[h]; k < m_offset[h + 1]; ++k)
-        {
-            auto curr_point = m_param_values.col(k);
-
-            if (m_result)
-                m_result->eval_into(curr_point, values);
-            else
-            {
-                m_mresult.eval_into(h, curr_point, values);
-            }
-
-            //const T err = (m_points.row(k) - values.col(k).transpose()).cwiseAbs().maxCoeff();
-            const T err = (m_points.row(k) - values.transpose()).template lpNorm<gsEigen::Infinity>();
-
-            m_pointErrors.push_back(err);
-
-            if ( k == 0 || m_max_error < err ) m_max_error = err;
-            if ( k == 0 || err < m_min_error ) m_min_error = err;
-        }
-    }
+    get_Error(m_pointErrors, 0);
+    m_min_error = *std::min_element(m_pointErrors.begin(), m_pointErrors.end());
+    m_max_error = *std::max_element(m_pointErrors.begin(), m_pointErrors.end());
 }
 
 
 template<class T>
 void gsFitting<T>::computeApproxError(T& error, int type) const
-
 {
-    gsMatrix<T> results;
-
-    const int num_patches(m_basis->nPieces());
+    std::vector<T> errors;
+    pointErrors(errors, 0);
 
+    // summation in a fixed order
     error = 0;
-
-    for (index_t h = 0; h < num_patches; h++)
+    for (size_t k = 0; k != errors.size(); ++k)
     {
-
-        for (index_t k = m_offset[h]; k < m_offset[h + 1]; ++k)
-        {
-            auto curr_point = m_param_values.col(k);
-
-            if (m_result)
-                m_result->eval_into(curr_point, results);
-            else
-            {
-                m_mresult.eval_into(h, curr_point, results);
-            }
-
-                const T err = (m_points.row(k) - results.transpose()).squaredNorm();
-
-                switch (type) {
-                case 0:
-                    error += err;
-                    break;
-                case 1:
-                    error += math::sqrt(err);
-                    break;
-                default:
-                    gsWarn << "Unknown type in computeApproxError(error, type)...\n";
-                    break;
-                }
+        switch (type) {
+        case 0:
+            error += errors[k] * errors[k];
+            break;
+        case 1:
+            error += errors[k];
+            break;
+        default:
+            gsWarn << "Unknown type in computeApproxError(error, type)...\n";
+            return;
         }
     }
 }
@@ -1052,41 +1346,42 @@ void gsFitting<T>::computeApproxError(T& error, int type) const
 template<class T>
 void gsFitting<T>::get_Error(std::vector<T>& errors, int type) const
 {
-    errors.clear();
-    errors.reserve(m_points.rows());
-
-    gsMatrix<T> curr_point, results;
+    switch (type)
+    {
+    case 0:
+        pointErrors(errors, 1);
+        break;
+    default:
+        gsWarn << "Unknown type in get_Error(errors, type)...\n";
+        errors.clear();
+        break;
+    }
+}
 
-    T err = 0;
 
+template<class T>
+void gsFitting<T>::pointErrors(std::vector<T>& errors, int norm) const
+{
+    errors.resize(m_points.rows());
     const int num_patches(m_basis->nPieces());
 
     for (index_t h = 0; h < num_patches; h++)
     {
-        for (index_t k = m_offset[h]; k < m_offset[h + 1]; ++k)
+#       pragma omp parallel
         {
-            curr_point = m_param_values.col(k);
-
-            if (m_result)
-                m_result->eval_into(curr_point, results);
-            else
+            gsMatrix<T> results;
+#           pragma omp for
+            for (index_t k = m_offset[h]; k < m_offset[h + 1]; ++k)
             {
-                m_mresult.eval_into(h, curr_point, results);
+                if (m_result)
+                    m_result->eval_into(m_param_values.col(k), results);
+                else
+                    m_mresult.eval_into(h, m_param_values.col(k), results);
+
+                errors[k] = 0==norm
+                    ? (m_points.row(k) - results.transpose()).norm()
+                    : (m_points.row(k) - results.transpose()).template lpNorm<gsEigen::Infinity>();
             }
-
-            results.transposeInPlace();
-
-            err = (m_points.row(k) - results).template lpNorm<gsEigen::Infinity>();
-
-                    switch (type)
-                    {
-                    case 0:
-                        errors.push_back(err);
-                        break;
-                    default:
-                        gsWarn << "Unknown type in get_Error(errors, type)...\n";
-                        break;
-                    }
         }
     }
 }
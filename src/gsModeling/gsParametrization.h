@@ -128,6 +128,9 @@ protected:
     {
 
     public:
+        /// Default constructor, the object is assigned later
+        LocalNeighbourhood() : m_vertexIndex(0) { }
+
         /**
          * @brief Constructor
          *
@@ -222,6 +225,9 @@ protected:
     {
 
     public:
+        /// Default constructor, the object is assigned later
+        LocalParametrization() : m_vertexIndex(0) { }
+
         /**
          * @brief Constructor
          * Using this constructor one needs to input mesh information, a local neighbourhood and a parametrization method.
@@ -239,11 +245,12 @@ protected:
 
         /**
          * @brief Get lambdas
-         * The lambdas are returned.
+         * The lambdas are returned, the j-th entry is the weight of the
+         * vertex with index j+1 and only the neighbours are non-zero.
          *
          * @return lambdas
          */
-        const std::vector<T> &getLambdas() const;
+        const gsSparseVector<T> &getLambdas() const;
 
     private:
         /**
@@ -256,7 +263,7 @@ protected:
         void calculateLambdas(const size_t N, VectorType& points);
 
         size_t m_vertexIndex; ///< vertex index
-        std::vector<T> m_lambdas; ///< lambdas
+        gsSparseVector<T> m_lambdas; ///< lambdas
 
     };
 
@@ -306,11 +313,19 @@ protected:
         /**
          * @brief Get vector of lambdas
          *
-         * This method returns a vector that stores the lambdas.
+         * This method returns a vector that stores the lambdas of the
+         * i-th inner vertex for all the vertices of the mesh.
          *
          * @return vector of lambdas
          */
-        const std::vector<T> &getLambdas(const size_t i) const;
+        std::vector<T> getLambdas(const size_t i) const;
+
+        /**
+         * @brief Get the lambdas of the i-th inner vertex as a sparse
+         * vector, whose non-zeros are the neighbours of the vertex
+         */
+        const gsSparseVector<T> &getSparseLambdas(const size_t i) const
+        { return m_localParametrizations[i].getLambdas(); }
 
         /**
          * @brief Get boundary corners depending on the method
@@ -362,6 +377,8 @@ protected:
     *  a(i,j) = -lambda(i,j) for j!=i
     * and the right hand side is calculated using the boundary parameters found beforehand. The parameter values are multiplied with corresponding lambda values and summed up.
     * In the last step the system is solved and the parameter points are stored in m_parameterPoints.
+    * The matrix is sparse and assembled in parallel, the solver is
+    * given by the option "solver" (see gsSparseSolver::get).
     *
     * @param[in] neighbourhood const Neighbourhood& - neighbourhood information of the mesh
     * @param[in] n const int - number of inner vertices and therefore size of the square matrix
@@ -14,6 +14,7 @@
 
 #include <gsIO/gsOptionList.h>
 #include <gsIO/gsWriteParaview.h>
+#include <gsParallel/gsOpenMP.h>
 #include <gsModeling/gsLineSegment.h>
 #include <gsModeling/gsParametrization.h>
 
@@ -42,6 +43,7 @@ gsOptionList gsParametrization<T>::defaultOptions()
     opt.addReal("range", "in case of restrict or opposite", 0.1);
     opt.addInt("number", "number of corners, in case of corners", 4);
     opt.addReal("precision", "precision to calculate", 1E-8);
+    opt.addString("solver", "sparse solver for the inner parameter points, e.g. LU, BiCGSTABILUT (see gsSparseSolver::get)", "LU");
     return opt;
 }
 
@@ -126,34 +128,44 @@ void gsParametrization<T>::constructAndSolveEquationSystem(const Neighbourhood &
                                                            const size_t n,
                                                            const size_t N)
 {
-    gsMatrix<T> A;
-    A.resize(n, n);
-    std::vector<T> lambdas;
-    gsVector<T> b1(n), b2(n);
-    b1.setZero(); b2.setZero();
+    GISMO_UNUSED(N);
+    // Every thread collects the entries of its rows
+    std::vector<gsSparseEntries<T> > entries(omp_get_max_threads());
+    gsMatrix<T> b(n, 2);
+    b.setZero();
 
-    for (size_t i = 0; i < n; i++)
+#pragma omp parallel
     {
-        lambdas = neighbourhood.getLambdas(i);
-        for (size_t j = 0; j < n; j++)
-        {
-            A(i, j) = ( i==j ? (T)(1) : -lambdas[j] );
-        }
-
-        for (size_t j = n; j < N; j++)
+        gsSparseEntries<T> & local = entries[omp_get_thread_num()];
+#pragma omp for
+        for (index_t i = 0; i < (index_t)n; i++)
         {
-            b1(i) += (lambdas[j]) * (m_parameterPoints[j][0]);
-            b2(i) += (lambdas[j]) * (m_parameterPoints[j][1]);
+            local.add(i, i, (T)(1));
+            for (typename gsSparseVector<T>::InnerIterator it(neighbourhood.getSparseLambdas(i)); it; ++it)
+            {
+                const size_t j = it.index();
+                if (j < n)
+                    local.add(i, j, -it.value());
+                else
+                    b.row(i) += it.value() * m_parameterPoints[j].transpose();
+            }
         }
     }
 
-    gsVector<T> u(n), v(n);
-    gsEigen::PartialPivLU<typename gsMatrix<T>::Base> LU = A.partialPivLu();
-    u = LU.solve(b1);
-    v = LU.solve(b2);
+    for (size_t k = 1; k < entries.size(); ++k)
+        entries[0].insert(entries[0].end(), entries[k].begin(), entries[k].end());
+    gsSparseMatrix<T> A(n, n);
+    A.setFrom(entries[0]);
+    A.makeCompressed();
+
+    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<T>::get(m_options.askString("solver", "LU"));
+    solver->compute(A);
+    GISMO_ENSURE(solver->succeed(), "gsParametrization: the solver "
+                 << m_options.askString("solver", "LU") << " failed on the parametrization system.");
+    const gsMatrix<T> uv = solver->solve(b);
 
     for (size_t i = 0; i < n; i++)
-        m_parameterPoints[i] << u(i), v(i);
+        m_parameterPoints[i] << uv(i, 0), uv(i, 1);
 }
 
 template<class T>
@@ -265,23 +277,35 @@ T gsParametrization<T>::findLengthOfPositionPart(const size_t position,
 template<class T>
 gsParametrization<T>::Neighbourhood::Neighbourhood(const gsHalfEdgeMesh<T> & meshInfo, const size_t parametrizationMethod) : m_basicInfos(meshInfo)
 {
-    m_localParametrizations.reserve(meshInfo.getNumberOfInnerVertices());
-    for(size_t i=1; i <= meshInfo.getNumberOfInnerVertices(); i++)
+    GISMO_ENSURE(parametrizationMethod >= 1 && parametrizationMethod <= 3,
+                 "parametrizationMethod not valid: " << parametrizationMethod);
+
+    // The vertices are independent of each other
+    const index_t n = meshInfo.getNumberOfInnerVertices();
+    m_localParametrizations.resize(n);
+#pragma omp parallel for schedule(dynamic, 64)
+    for(index_t i=0; i < n; i++)
     {
-        m_localParametrizations.push_back(LocalParametrization(meshInfo, LocalNeighbourhood(meshInfo, i), parametrizationMethod));
+        m_localParametrizations[i] = LocalParametrization(meshInfo, LocalNeighbourhood(meshInfo, i+1), parametrizationMethod);
     }
 
-    m_localBoundaryNeighbourhoods.reserve(meshInfo.getNumberOfVertices() - meshInfo.getNumberOfInnerVertices());
-    for(size_t i=meshInfo.getNumberOfInnerVertices()+1; i<= meshInfo.getNumberOfVertices(); i++)
+    const index_t B = meshInfo.getNumberOfVertices() - n;
+    m_localBoundaryNeighbourhoods.resize(B);
+#pragma omp parallel for schedule(dynamic, 64)
+    for(index_t i=0; i < B; i++)
     {
-        m_localBoundaryNeighbourhoods.push_back(LocalNeighbourhood(meshInfo, i, 0));
+        m_localBoundaryNeighbourhoods[i] = LocalNeighbourhood(meshInfo, n+i+1, 0);
     }
 }
 
 template<class T>
-const std::vector<T>& gsParametrization<T>::Neighbourhood::getLambdas(const size_t i) const
+std::vector<T> gsParametrization<T>::Neighbourhood::getLambdas(const size_t i) const
 {
-    return m_localParametrizations[i].getLambdas();
+    const gsSparseVector<T> & lambdas = m_localParametrizations[i].getLambdas();
+    std::vector<T> result(m_basicInfos.getNumberOfVertices(), 0);
+    for (typename gsSparseVector<T>::InnerIterator it(lambdas); it; ++it)
+        result[it.index()] = it.value();
+    return result;
 }
 
 template<class T>
@@ -566,14 +590,11 @@ gsParametrization<T>::LocalParametrization::LocalParametrization(const gsHalfEdg
         }
             break;
         case 2:
-            m_lambdas.reserve(meshInfo.getNumberOfVertices());
-            for(size_t j=1; j <= meshInfo.getNumberOfVertices(); j++)
-            {
-                m_lambdas.push_back(0); // Lambda(m_vertexIndex, j, 0)
-            }
+            m_lambdas.resize(meshInfo.getNumberOfVertices());
+            m_lambdas.reserve(d);
             while(!indices.empty())
             {
-                m_lambdas[indices.front()-1] += (1./d);
+                m_lambdas.coeffRef(indices.front()-1) += (1./d);
                 indices.pop_front();
             }
             break;
@@ -586,14 +607,11 @@ gsParametrization<T>::LocalParametrization::LocalParametrization(const gsHalfEdg
                 sumOfDistances += *it;
             }
             T sumOfDistancesInv = 1./sumOfDistances;
-            m_lambdas.reserve(meshInfo.getNumberOfVertices());
-            for(size_t j=1; j <= meshInfo.getNumberOfVertices(); j++)
-            {
-                m_lambdas.push_back(0); //Lambda(m_vertexIndex, j, 0)
-            }
+            m_lambdas.resize(meshInfo.getNumberOfVertices());
+            m_lambdas.reserve(d);
             for(typename std::list<T>::iterator it = neighbourDistances.begin(); it != neighbourDistances.end(); it++)
             {
-                m_lambdas[indices.front()-1] += ((*it)*sumOfDistancesInv);
+                m_lambdas.coeffRef(indices.front()-1) += ((*it)*sumOfDistancesInv);
                 indices.pop_front();
             }
         }
@@ -604,7 +622,7 @@ gsParametrization<T>::LocalParametrization::LocalParametrization(const gsHalfEdg
 }
 
 template<class T>
-const std::vector<T>& gsParametrization<T>::LocalParametrization::getLambdas() const
+const gsSparseVector<T>& gsParametrization<T>::LocalParametrization::getLambdas() const
 {
     return m_lambdas;
 }
@@ -618,13 +636,10 @@ const std::vector<T>& gsParametrization<T>::LocalParametrization::getLambdas() c
 template<class T>
 void gsParametrization<T>::LocalParametrization::calculateLambdas(const size_t N, VectorType& points)
 {
-    m_lambdas.reserve(N);
-    for(size_t j=1; j <= N; j++)
-    {
-        m_lambdas.push_back(0); //Lambda(m_vertexIndex, j, 0)
-    }
     Point2D p(0, 0, 0);
     size_t d = points.size();
+    m_lambdas.resize(N);
+    m_lambdas.reserve(d);
     std::vector<T> my(d, 0);
     size_t l=1;
     size_t steps = 0;
@@ -660,19 +675,16 @@ void gsParametrization<T>::LocalParametrization::calculateLambdas(const size_t N
         }
         for(size_t k = 1; k <= d; k++)
         {
-            m_lambdas[points[k-1].getVertexIndex()-1] += (my[k-1]);
+            m_lambdas.coeffRef(points[k-1].getVertexIndex()-1) += (my[k-1]);
         }
         std::fill(my.begin(), my.end(), 0);
         l++;
     }
-    for(typename std::vector<T>::iterator it=m_lambdas.begin(); it != m_lambdas.end(); it++)
-    {
-        *it /= d;
-    }
-    for(typename std::vector<T>::iterator it=m_lambdas.begin(); it != m_lambdas.end(); it++)
+    m_lambdas /= d;
+    for(typename gsSparseVector<T>::InnerIterator it(m_lambdas); it; ++it)
     {
-        if(*it < 0)
-            gsInfo << *it << "\n";
+        if(it.value() < 0)
+            gsInfo << it.value() << "\n";
     }
 }
 
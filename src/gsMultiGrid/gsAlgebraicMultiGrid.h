@@ -0,0 +1,140 @@
+/** @file gsAlgebraicMultiGrid.h
+
+    @brief Smoothed aggregation algebraic multigrid preconditioner
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsDofMapper.h>
+#include <gsMultiGrid/gsMultiGrid.h>
+
+namespace gismo
+{
+
+/** @brief Smoothed aggregation algebraic multigrid preconditioner
+ *
+ *  The grid hierarchy is built from the (symmetric positive definite)
+ *  matrix alone, so the preconditioner can be used for any
+ *  discretization, including multipatch and mapped (gsMappedBasis)
+ *  spaces, where a hierarchy of bases is awkward to build.
+ *
+ *  On every level, the dofs are grouped into aggregates of strongly
+ *  connected dofs, i.e., dofs with
+ *  \f$ |a_{ij}| \ge \theta \sqrt{|a_{ii}a_{jj}|} \f$. The tentative
+ *  prolongation interpolates the constants on the aggregates; it is
+ *  smoothed by one damped Jacobi step,
+ *  \f$ P = (I - \omega D^{-1}A) P_0 \f$ with
+ *  \f$ \omega = 4/(3\rho(D^{-1}A)) \f$. The coarse matrices are
+ *  \f$ P^T A P \f$. Coarsening stops at "CoarseSize" dofs or after
+ *  "MaxLevels" levels; the coarsest problem is solved directly.
+ *
+ *  For vector-valued problems, the dofs are split into blocks (one for
+ *  every component of the gsDofMapper); dofs of different blocks are
+ *  never aggregated together, and the constants of each block are
+ *  interpolated separately.
+ *
+ *  The strength graph and the prolongation smoothing are computed in
+ *  parallel (OpenMP). The cycles are those of gsMultiGridOp, with
+ *  Gauss-Seidel or damped Jacobi smoothing on every level.
+ *
+ *  @ingroup Solver
+**/
+template<class T>
+class gsAlgebraicMultiGridOp : public gsMultiGridOp<T>
+{
+public:
+
+    /// Shared pointer for gsAlgebraicMultiGridOp
+    typedef memory::shared_ptr<gsAlgebraicMultiGridOp> Ptr;
+
+    /// Unique pointer for gsAlgebraicMultiGridOp
+    typedef memory::unique_ptr<gsAlgebraicMultiGridOp> uPtr;
+
+    /// Direct base class
+    typedef gsMultiGridOp<T> Base;
+
+    typedef typename Base::OpPtr               OpPtr;
+    typedef typename Base::SpMatrix            SpMatrix;
+    typedef typename Base::SpMatrixPtr         SpMatrixPtr;
+    typedef typename Base::SpMatrixRowMajor    SpMatrixRowMajor;
+    typedef typename Base::SpMatrixRowMajorPtr SpMatrixRowMajorPtr;
+
+private:
+    /// Operators of the grid hierarchy, from coarse to fine
+    struct Hierarchy
+    {
+        std::vector<SpMatrixPtr> mats;
+        std::vector<OpPtr> ops, prolong, restrict;
+        std::vector<T> rho; // spectral radius of D^{-1}A
+    };
+
+public:
+
+    /// @brief Constructor for a scalar problem
+    ///
+    /// @param mat      The system matrix
+    /// @param opt      Options, see defaultOptions()
+    explicit gsAlgebraicMultiGridOp(const SpMatrix & mat,
+                                    const gsOptionList & opt = defaultOptions())
+    : gsAlgebraicMultiGridOp(mat, gsVector<index_t>::Constant(1, mat.rows()), opt) { }
+
+    /// @brief Constructor for a vector-valued problem
+    ///
+    /// @param mat      The system matrix
+    /// @param mapper   The mapper of the (free) dofs; every component is a block
+    /// @param opt      Options, see defaultOptions()
+    gsAlgebraicMultiGridOp(const SpMatrix & mat, const gsDofMapper & mapper,
+                           const gsOptionList & opt = defaultOptions())
+    : gsAlgebraicMultiGridOp(mat, blockSizes(mapper), opt) { }
+
+    /// @brief Constructor for a block system
+    ///
+    /// @param mat      The system matrix
+    /// @param blocks   The sizes of the consecutive blocks of dofs
+    /// @param opt      Options, see defaultOptions()
+    gsAlgebraicMultiGridOp(const SpMatrix & mat, const gsVector<index_t> & blocks,
+                           const gsOptionList & opt = defaultOptions())
+    : gsAlgebraicMultiGridOp(build(mat, blocks, opt), opt) { }
+
+    /// @brief Make function returning smart pointer
+    static uPtr make(const SpMatrix & mat, const gsOptionList & opt = defaultOptions())
+    { return uPtr( new gsAlgebraicMultiGridOp(mat, opt) ); }
+
+    /// @brief Make function returning smart pointer
+    static uPtr make(const SpMatrix & mat, const gsDofMapper & mapper,
+                     const gsOptionList & opt = defaultOptions())
+    { return uPtr( new gsAlgebraicMultiGridOp(mat, mapper, opt) ); }
+
+    /// @brief Make function returning smart pointer
+    static uPtr make(const SpMatrix & mat, const gsVector<index_t> & blocks,
+                     const gsOptionList & opt = defaultOptions())
+    { return uPtr( new gsAlgebraicMultiGridOp(mat, blocks, opt) ); }
+
+    /// Returns a list of default options
+    static gsOptionList defaultOptions();
+
+private:
+
+    gsAlgebraicMultiGridOp(const Hierarchy & h, const gsOptionList & opt);
+
+    /// Builds the grid hierarchy for \a mat
+    static Hierarchy build(const SpMatrix & mat, const gsVector<index_t> & blocks,
+                           const gsOptionList & opt);
+
+    /// The number of free dofs of the components of \a mapper
+    static gsVector<index_t> blockSizes(const gsDofMapper & mapper);
+};
+
+}  // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsAlgebraicMultiGrid.hpp)
+#endif
@@ -0,0 +1,205 @@
+/** @file gsAlgebraicMultiGrid.hpp
+
+    @brief Smoothed aggregation algebraic multigrid preconditioner
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsSimplePreconditioners.h>
+#include <gsParallel/gsOpenMP.h>
+
+namespace gismo
+{
+
+template<class T>
+gsAlgebraicMultiGridOp<T>::gsAlgebraicMultiGridOp(const Hierarchy & h, const gsOptionList & opt)
+: Base(h.ops, h.prolong, h.restrict)
+{
+    Base::setOptions(opt);
+    const bool jacobi = ("Jacobi" == opt.askString("Smoother", "GaussSeidel"));
+    for (size_t i = 1; i < h.mats.size(); ++i)
+    {
+        if (jacobi)
+            this->setSmoother(i, makeJacobiOp(h.mats[i], T(4) / (3 * h.rho[i])));
+        else
+            this->setSmoother(i, makeGaussSeidelOp(h.mats[i]));
+    }
+}
+
+template<class T>
+gsVector<index_t> gsAlgebraicMultiGridOp<T>::blockSizes(const gsDofMapper & mapper)
+{
+    gsVector<index_t> blocks(mapper.numComponents());
+    for (index_t c = 0; c != blocks.size(); ++c)
+        blocks[c] = mapper.freeSize(c);
+    return blocks;
+}
+
+template<class T>
+typename gsAlgebraicMultiGridOp<T>::Hierarchy
+gsAlgebraicMultiGridOp<T>::build(const SpMatrix & mat, const gsVector<index_t> & blocks,
+                                 const gsOptionList & opt)
+{
+    GISMO_ASSERT(mat.rows() == mat.cols(), "gsAlgebraicMultiGridOp needs quadratic matrices.");
+    GISMO_ENSURE(blocks.sum() == mat.rows(), "The block sizes do not match the matrix.");
+
+    const index_t maxLevels  = opt.askInt ("MaxLevels", 10);
+    const index_t coarseSize = opt.askInt ("CoarseSize", 500);
+    const T theta2 = math::pow(T(opt.askReal("StrengthThreshold", 0.08)), 2);
+
+    Hierarchy h;
+    SpMatrixPtr A(new SpMatrix(mat));
+    A->makeCompressed();
+
+    // block of every dof
+    std::vector<index_t> block;
+    block.reserve(mat.rows());
+    for (index_t b = 0; b != blocks.size(); ++b)
+        block.insert(block.end(), blocks[b], b);
+
+    while (true)
+    {
+        const index_t n = A->rows();
+        const gsVector<T> dinv = A->diagonal().cwiseInverse();
+
+        // Spectral radius of D^{-1}A by the power method
+        gsMatrix<T> x = gsMatrix<T>::Ones(n, 1), y;
+        T rho = 0;
+        for (index_t k = 0; k != 15 && n > 0; ++k)
+        {
+            y.noalias() = *A * x;
+            y.array() *= dinv.array();
+            rho = y.norm() / x.norm();
+            x.swap(y);
+        }
+        h.mats.push_back(A);
+        h.rho.push_back(rho);
+
+        if ( n <= coarseSize || static_cast<index_t>(h.mats.size()) == maxLevels )
+            break;
+
+        // Strong connections (the matrix is symmetric, so the columns are the rows)
+        std::vector<std::vector<index_t> > strong(n);
+#       pragma omp parallel for
+        for (index_t j = 0; j < n; ++j)
+            for (typename SpMatrix::InnerIterator it(*A, j); it; ++it)
+            {
+                const index_t i = it.row();
+                if (i != j && block[i] == block[j] &&
+                    it.value() * it.value() * math::abs(dinv[i] * dinv[j]) >= theta2)
+                    strong[j].push_back(i);
+            }
+
+        // Aggregation; dofs without strong connections are not aggregated
+        std::vector<index_t> agg(n, -1);
+        index_t nAgg = 0;
+        for (index_t i = 0; i != n; ++i) // 1. disjoint neighbourhoods
+        {
+            if (-1 != agg[i] || strong[i].empty()) continue;
+            bool free = true;
+            for (size_t k = 0; free && k != strong[i].size(); ++k)
+                free = (-1 == agg[strong[i][k]]);
+            if (!free) continue;
+            agg[i] = nAgg;
+            for (size_t k = 0; k != strong[i].size(); ++k)
+                agg[strong[i][k]] = nAgg;
+            ++nAgg;
+        }
+        const std::vector<index_t> agg1 = agg;
+        for (index_t i = 0; i != n; ++i) // 2. join a neighbouring aggregate
+        {
+            if (-1 != agg[i]) continue;
+            for (size_t k = 0; k != strong[i].size(); ++k)
+                if (-1 != agg1[strong[i][k]])
+                {
+                    agg[i] = agg1[strong[i][k]];
+                    break;
+                }
+        }
+        for (index_t i = 0; i != n; ++i) // 3. aggregate the remaining
+        {
+            if (-1 != agg[i] || strong[i].empty()) continue;
+            agg[i] = nAgg;
+            for (size_t k = 0; k != strong[i].size(); ++k)
+                if (-1 == agg[strong[i][k]])
+                    agg[strong[i][k]] = nAgg;
+            ++nAgg;
+        }
+        if (0 == nAgg || nAgg == n)
+            break;
+
+        // Tentative prolongation: normalized constants on the aggregates
+        gsVector<T> p0 = gsVector<T>::Zero(nAgg);
+        std::vector<index_t> cblock(nAgg);
+        for (index_t i = 0; i != n; ++i)
+            if (-1 != agg[i])
+            {
+                p0[agg[i]] += 1;
+                cblock[agg[i]] = block[i];
+            }
+        p0 = p0.cwiseSqrt().cwiseInverse();
+
+        // Smoothed prolongation P = (I - omega D^{-1} A) P0, row by row
+        const T omega = T(4) / (3 * rho);
+        std::vector<gsSparseEntries<T> > entries;
+#       pragma omp parallel
+        {
+#           pragma omp single
+            entries.resize(omp_get_num_threads());
+            gsSparseEntries<T> & e = entries[omp_get_thread_num()];
+#           pragma omp for
+            for (index_t i = 0; i < n; ++i)
+            {
+                if (-1 != agg[i])
+                    e.add(i, agg[i], p0[agg[i]]);
+                for (typename SpMatrix::InnerIterator it(*A, i); it; ++it)
+                {
+                    const index_t j = agg[it.row()];
+                    if (-1 != j)
+                        e.add(i, j, - omega * dinv[i] * it.value() * p0[j]);
+                }
+            }
+        }
+        for (size_t k = 1; k < entries.size(); ++k)
+            entries[0].insert(entries[0].end(), entries[k].begin(), entries[k].end());
+        SpMatrixRowMajorPtr P(new SpMatrixRowMajor(n, nAgg));
+        P->setFrom(entries[0]);
+
+        h.prolong.push_back(makeMatrixOp(P));
+        h.restrict.push_back(makeMatrixOp(P->transpose()));
+
+        // Galerkin coarse matrix
+        A = SpMatrixPtr(new SpMatrix(P->transpose() * ( *A * *P )));
+        A->makeCompressed();
+        block.swap(cblock);
+    }
+
+    // gsMultiGridOp numbers the levels from coarse to fine
+    std::reverse(h.mats.begin(), h.mats.end());
+    std::reverse(h.rho.begin(), h.rho.end());
+    std::reverse(h.prolong.begin(), h.prolong.end());
+    std::reverse(h.restrict.begin(), h.restrict.end());
+    for (size_t i = 0; i != h.mats.size(); ++i)
+        h.ops.push_back(makeMatrixOp(h.mats[i]));
+    return h;
+}
+
+template<class T>
+gsOptionList gsAlgebraicMultiGridOp<T>::defaultOptions()
+{
+    gsOptionList opt = Base::defaultOptions();
+    opt.addInt   ("MaxLevels"        , "Maximum number of levels", 10 );
+    opt.addInt   ("CoarseSize"       , "Number of dofs below which coarsening stops", 500 );
+    opt.addReal  ("StrengthThreshold", "Threshold theta of strong connections", 0.08 );
+    opt.addString("Smoother"         , "Smoother on every level: GaussSeidel or Jacobi", "GaussSeidel" );
+    return opt;
+}
+
+}  // namespace gismo
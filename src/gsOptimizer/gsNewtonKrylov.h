@@ -0,0 +1,235 @@
+/** @file gsNewtonKrylov.h
+
+    @brief Provides a trust-region Newton-Krylov optimizer.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsIO/gsOptionList.h>
+#include <gsOptimizer/gsOptimizer.h>
+#include <gsOptimizer/gsOptProblem.h>
+
+namespace gismo
+{
+
+/**
+ * @brief Trust-region Newton method for unconstrained minimization,
+ * with the Newton steps computed by truncated conjugate gradients
+ * (Steihaug-Toint).
+ *
+ * The Hessian is taken from gsOptProblem::hessObj_into() if the
+ * problem provides it (sparse Newton), otherwise only products of the
+ * Hessian with vectors are formed by gsOptProblem::hessVecObj_into()
+ * (matrix-free Newton). Close to the minimizer the convergence is
+ * superlinear, hence typically a few tens of iterations are needed,
+ * in contrast to first-order methods.
+ *
+ * Options:
+ * - MaxIterations, Verbose: see gsOptimizer
+ * - MinGradientLength: stop when the norm of the gradient is smaller
+ * - MinStepLength: stop when the trust region radius is smaller
+ * - InitialRadius: initial trust region radius, a negative value
+ *   takes a tenth of the norm of the initial guess
+ * - MaxKrylovIterations: maximum number of CG iterations per step
+ * - MatrixFree: do not use the Hessian matrix of the problem
+ *
+ * @tparam     T     Real type
+ *
+ * @ingroup    Optimizer
+ */
+template<typename T = real_t>
+class gsNewtonKrylov : public gsOptimizer<T>
+{
+    using Base = gsOptimizer<T>;
+
+public:
+    gsNewtonKrylov(gsOptProblem<T> * problem)
+    :
+    Base(problem)
+    {
+        this->defaultOptions();
+    }
+
+protected:
+    void defaultOptions()
+    {
+        Base::defaultOptions();
+        m_options.addReal("MinGradientLength","Minimal gradient length",1e-9);
+        m_options.addReal("MinStepLength","Minimal step length (trust region radius)",1e-12);
+        m_options.addReal("InitialRadius","Initial trust region radius (negative: automatic)",-1);
+        m_options.addInt("MaxKrylovIterations","Maximum CG iterations per Newton step",200);
+        m_options.addSwitch("MatrixFree","Use Hessian-vector products even if the Hessian is available",false);
+    }
+
+    void getOptions()
+    {
+        Base::getOptions();
+        m_minGradientLength = m_options.getReal("MinGradientLength");
+        m_minStepLength = m_options.getReal("MinStepLength");
+        m_radius = m_options.getReal("InitialRadius");
+        m_maxKrylov = m_options.getInt("MaxKrylovIterations");
+        m_matrixFree = m_options.getSwitch("MatrixFree");
+    }
+
+public:
+
+    using Base::solve;
+    void solve(const gsMatrix<T> & initialGuess)
+    {
+        this->getOptions();
+        const index_t n = initialGuess.rows();
+        m_curDesign = initialGuess;
+
+        // The current design is updated in place, x stays valid
+        gsAsConstVector<T> x(m_curDesign.data(), n);
+        T f = m_op->evalObj(x);
+        gsVector<T> g(n), gn(n), p, Hp;
+        gsAsVector<T> ag(g.data(), n);
+        m_op->gradObj_into(x, ag);
+
+        if (m_radius <= 0)
+            m_radius = math::max(T(1), m_curDesign.norm()) / 10;
+
+        gsMatrix<T> xn;
+        bool haveHessian = false, moved = true;
+        for (m_numIterations = 0; m_numIterations < m_maxIterations; ++m_numIterations)
+        {
+            const T gnorm = g.norm();
+            if (m_verbose > 0)
+                gsInfo << "NewtonKrylov it. " << m_numIterations << ": f=" << f
+                       << ", |g|=" << gnorm << ", radius=" << m_radius << "\n";
+            if (gnorm < m_minGradientLength || m_radius < m_minStepLength)
+                break;
+
+            // Second order model, the Hessian changes only with x
+            if (moved)
+                haveHessian = !m_matrixFree && m_op->hessObj_into(x, m_hessian);
+            steihaug(x, g, haveHessian, p);
+            hessVec(x, p, haveHessian, Hp);
+            const T pred = -( g.dot(p) + p.dot(Hp) / 2 );
+
+            // Trial step
+            xn = m_curDesign + p;
+            gsAsConstVector<T> xt(xn.data(), n);
+            const T fn = m_op->evalObj(xt);
+            T rho = (pred > 0 ? (f - fn) / pred : T(-1));
+
+            // Close to the minimizer the reduction is below round-off,
+            // then the step is judged by the gradient instead
+            bool newGrad = false;
+            if ( math::abs(f - fn) <= 10 * std::numeric_limits<T>::epsilon() * (1 + math::abs(f)) )
+            {
+                gsAsVector<T> agn(gn.data(), n);
+                m_op->gradObj_into(xt, agn);
+                rho = (gn.norm() < gnorm ? T(1) : T(-1));
+                newGrad = true;
+            }
+
+            if (rho < T(0.25))
+                m_radius /= 4;
+            else if (rho > T(0.75) && p.norm() > T(0.99) * m_radius)
+                m_radius *= 2;
+
+            moved = (rho > T(1e-4));
+            if (moved)
+            {
+                m_curDesign.col(0) += p;
+                f = fn;
+                if (newGrad)
+                    ag = gn;
+                else
+                    m_op->gradObj_into(x, ag);
+            }
+
+            if (!this->intermediateCallback())
+                break;
+        }
+        m_finalObjective = f;
+    }
+
+protected:
+
+    // Product of the Hessian at x with v
+    void hessVec(const gsAsConstVector<T> & x, const gsVector<T> & v,
+                 bool haveHessian, gsVector<T> & result) const
+    {
+        if (haveHessian)
+            result.noalias() = m_hessian * v;
+        else
+            m_op->hessVecObj_into(x, v, result);
+    }
+
+    // Step length tau >= 0 such that |z + tau d| = radius
+    T toBoundary(const gsVector<T> & z, const gsVector<T> & d) const
+    {
+        const T a = d.squaredNorm(), b = 2 * z.dot(d),
+            c = z.squaredNorm() - m_radius * m_radius;
+        return ( -b + math::sqrt(b * b - 4 * a * c) ) / (2 * a);
+    }
+
+    // Truncated CG (Steihaug-Toint) for the trust-region subproblem
+    void steihaug(const gsAsConstVector<T> & x, const gsVector<T> & g,
+                  bool haveHessian, gsVector<T> & z) const
+    {
+        const index_t n = g.size();
+        const T gnorm = g.norm();
+        const T tol = math::min(T(0.5), math::sqrt(gnorm)) * gnorm;
+
+        z.setZero(n);
+        gsVector<T> r = g, d = -g, Bd, zn;
+        T rr = r.squaredNorm();
+        for (index_t j = 0; j < m_maxKrylov; ++j)
+        {
+            hessVec(x, d, haveHessian, Bd);
+            const T dBd = d.dot(Bd);
+            if (dBd <= 0) // negative curvature: go to the boundary
+            {
+                z += toBoundary(z, d) * d;
+                return;
+            }
+            const T alpha = rr / dBd;
+            zn = z + alpha * d;
+            if (zn.norm() >= m_radius)
+            {
+                z += toBoundary(z, d) * d;
+                return;
+            }
+            z.swap(zn);
+            r += alpha * Bd;
+            const T rrn = r.squaredNorm();
+            if (math::sqrt(rrn) < tol)
+                return;
+            d = -r + (rrn / rr) * d;
+            rr = rrn;
+        }
+    }
+
+protected:
+    using Base::m_op;
+    using Base::m_numIterations;
+    using Base::m_finalObjective;
+    using Base::m_curDesign;
+    using Base::m_options;
+    using Base::m_verbose;
+    using Base::m_maxIterations;
+
+protected:
+    T m_minGradientLength;
+    T m_minStepLength;
+    T m_radius;
+    index_t m_maxKrylov;
+    bool m_matrixFree;
+
+    gsSparseMatrix<T> m_hessian;
+};
+
+} //namespace gismo
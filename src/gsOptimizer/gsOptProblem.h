@@ -12,6 +12,7 @@
 */
 
 #include <gsCore/gsLinearAlgebra.h>
+#include <gsParallel/gsOpenMP.h>
 
 #pragma once
 
@@ -26,11 +27,14 @@ class gsOptProblem
 
 public:
 
+    /// Unique pointer for gsOptProblem
+    typedef memory::unique_ptr<gsOptProblem> uPtr;
+
     // /** default constructor */
     // gsOptProblem();
 
-    // /** default destructor */
-    // virtual ~gsOptProblem();
+    /// Destructor
+    virtual ~gsOptProblem() { }
 
 public:
 
@@ -43,33 +47,155 @@ public:
     /// \a u
     /// By default it uses finite differences, overriding it should provide exact gradient.
     virtual void gradObj_into ( const gsAsConstVector<T> & u, gsAsVector<T> & result) const
+    {
+        gradObjFD_into(u, result);
+    }
+
+    /// \brief Returns a copy of the problem, or a null pointer if
+    /// the problem cannot be copied (default).
+    ///
+    /// The copies are used by gradObjFD_into() to evaluate the
+    /// objective on several threads, since evalObj() may modify
+    /// internal (mutable) data. Override it if the copies are
+    /// independent of each other.
+    virtual uPtr clone() const { return uPtr(); }
+
+    /// \brief Computes the gradient of the objective function at
+    /// design value \a u by 4-point central finite differences.
+    ///
+    /// The partial derivatives are distributed over the threads, each
+    /// thread evaluating the objective on its own copy of the problem
+    /// (see clone()). If the problem cannot be copied the derivatives
+    /// are computed serially.
+    void gradObjFD_into ( const gsAsConstVector<T> & u, gsAsVector<T> & result) const
     {
         const index_t n = u.rows();
         //GISMO_ASSERT((index_t)m_numDesignVars == n*m, "Wrong design.");
 
-        gsMatrix<T> uu = u;//copy
-        gsAsVector<T> tmp(uu.data(), n);
-        gsAsConstVector<T> ctmp(uu.data(), n);
-        index_t c = 0;
+        // Copies for all threads but the first one
+        std::vector<uPtr> copies(n > 1 ? omp_get_max_threads() : 1);
+        for (size_t t = 1; t < copies.size(); ++t)
+            if ( !(copies[t] = this->clone()) )
+            {
+                copies.resize(1);
+                break;
+            }
 
-        // for all partial derivatives (column-wise)
-        for ( index_t i = 0; i!=n; i++ )
+#       pragma omp parallel num_threads(copies.size())
         {
-            // to do: add m_desLowerBounds m_desUpperBounds check
-            tmp[i]  += T(0.00001);
-            const T e1 = this->evalObj(ctmp);
-            tmp[i]   = u[i] + T(0.00002);
-            const T e3 = this->evalObj(ctmp);
-            tmp[i]   = u[i] - T(0.00001);
-            const T e2 = this->evalObj(ctmp);
-            tmp[i]   = u[i] - T(0.00002);
-            const T e4 = this->evalObj(ctmp);
-            tmp[i]   = u[i];
-            result[c++]= ( 8 * (e1 - e2) + e4 - e3 ) / T(0.00012);
+            const int t = omp_get_thread_num();
+            const gsOptProblem & op = (0 == t ? *this : *copies[t]);
+
+            gsMatrix<T> uu = u;//copy
+            gsAsVector<T> tmp(uu.data(), n);
+            gsAsConstVector<T> ctmp(uu.data(), n);
+
+            // for all partial derivatives (column-wise)
+#           pragma omp for schedule(dynamic)
+            for ( index_t i = 0; i < n; i++ )
+            {
+                // to do: add m_desLowerBounds m_desUpperBounds check
+                tmp[i]  += T(0.00001);
+                const T e1 = op.evalObj(ctmp);
+                tmp[i]   = u[i] + T(0.00002);
+                const T e3 = op.evalObj(ctmp);
+                tmp[i]   = u[i] - T(0.00001);
+                const T e2 = op.evalObj(ctmp);
+                tmp[i]   = u[i] - T(0.00002);
+                const T e4 = op.evalObj(ctmp);
+                tmp[i]   = u[i];
+                result[i]= ( 8 * (e1 - e2) + e4 - e3 ) / T(0.00012);
+            }
         }
     }
 
 
+    /// \brief Computes the Hessian of the objective function at design
+    /// value \a u as a sparse matrix.
+    /// Returns false if the problem provides no Hessian (default),
+    /// see also hessObjFD_into().
+    virtual bool hessObj_into( const gsAsConstVector<T> &, gsSparseMatrix<T> &) const
+    { return false; }
+
+    /// \brief Returns the product of the Hessian of the objective
+    /// function at design value \a u with the vector \a v.
+    /// By default it uses central finite differences of the gradient.
+    virtual void hessVecObj_into( const gsAsConstVector<T> & u, const gsVector<T> & v,
+                                  gsVector<T> & result) const
+    {
+        const index_t n = u.rows();
+        const T vn = v.norm();
+        if (0 == vn) { result.setZero(n); return; }
+        const T h = math::pow(std::numeric_limits<T>::epsilon(), T(1)/3)
+            * (1 + u.norm()) / vn;
+        gsVector<T> up = u + h * v, um = u - h * v, gp(n), gm(n);
+        gsAsConstVector<T> cup(up.data(), n), cum(um.data(), n);
+        gsAsVector<T> agp(gp.data(), n), agm(gm.data(), n);
+        this->gradObj_into(cup, agp);
+        this->gradObj_into(cum, agm);
+        result = (gp - gm) / (2 * h);
+    }
+
+    /// \brief Computes the Hessian of the objective function at design
+    /// value \a u by central finite differences of the gradient,
+    /// given its sparsity \a pattern (symmetric).
+    ///
+    /// The columns are grouped such that no two columns of a group
+    /// have a non-zero in the same row (greedy coloring), and each
+    /// group is differentiated at once. The number of gradient
+    /// evaluations is twice the number of groups, which is bounded by
+    /// the number of non-zeros per column, not by the size of the problem.
+    void hessObjFD_into( const gsAsConstVector<T> & u, const gsSparseMatrix<T> & pattern,
+                         gsSparseMatrix<T> & result) const
+    {
+        const index_t n = u.rows();
+        GISMO_ASSERT(pattern.rows() == n && pattern.cols() == n, "Wrong pattern size.");
+
+        // Greedy distance-2 coloring of the columns
+        gsVector<index_t> color(n);
+        color.setConstant(-1);
+        std::vector<index_t> mark;
+        index_t numColors = 0;
+        for (index_t j = 0; j != n; ++j)
+        {
+            for (typename gsSparseMatrix<T>::InnerIterator it(pattern, j); it; ++it)
+                for (typename gsSparseMatrix<T>::InnerIterator jt(pattern, it.row()); jt; ++jt)
+                    if (color[jt.row()] >= 0)
+                        mark.push_back(color[jt.row()]);
+            std::sort(mark.begin(), mark.end());
+            index_t c = 0;
+            for (size_t k = 0; k != mark.size() && mark[k] <= c; ++k)
+                if (mark[k] == c) ++c;
+            color[j] = c;
+            numColors = std::max(numColors, c + 1);
+            mark.clear();
+        }
+
+        result = pattern;
+        result.makeCompressed();
+        const T h = math::pow(std::numeric_limits<T>::epsilon(), T(1)/3) * (1 + u.norm());
+        gsVector<T> up, um, gp(n), gm(n);
+        gsAsVector<T> agp(gp.data(), n), agm(gm.data(), n);
+        for (index_t c = 0; c != numColors; ++c)
+        {
+            up = u;
+            um = u;
+            for (index_t j = 0; j != n; ++j)
+                if (color[j] == c) { up[j] += h; um[j] -= h; }
+            gsAsConstVector<T> cup(up.data(), n), cum(um.data(), n);
+            this->gradObj_into(cup, agp);
+            this->gradObj_into(cum, agm);
+            for (index_t j = 0; j != n; ++j)
+                if (color[j] == c)
+                    for (typename gsSparseMatrix<T>::InnerIterator it(result, j); it; ++it)
+                        it.valueRef() = (gp[it.row()] - gm[it.row()]) / (2 * h);
+        }
+
+        // Symmetrize
+        gsSparseMatrix<T> tr = result.transpose();
+        result = (result + tr) / 2;
+    }
+
     /// \brief Returns values of the constraints at design value \a u
     virtual void evalCon_into ( const gsAsConstVector<T> &, gsAsVector<T> &) const
     {GISMO_NO_IMPLEMENTATION }
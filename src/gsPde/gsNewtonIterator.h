@@ -15,6 +15,9 @@
 #pragma once
 
 #include <gsAssembler/gsAssembler.h>
+#include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsGMRes.h>
+#include <gsSolver/gsConjugateGradient.h>
 
 
 namespace gismo
@@ -22,7 +25,22 @@ namespace gismo
 
 /** 
     @brief Performs Newton iterations to solve a nonlinear system of PDEs.
-    
+
+    The linear systems are solved according to the option "Method":
+    - Newton: the Jacobian is factorized in every iteration
+    - ModifiedNewton: the factorization is kept for up to "MaxReuse"
+      iterations, and it is renewed earlier if the residue decreases
+      by less than the factor "ReuseRate"
+    - InexactNewtonKrylov: the systems are solved by "Krylov" (GMRes
+      or CG) up to a relative tolerance given by the forcing terms of
+      Eisenstat and Walker (choice 2), preconditioned by a
+      factorization which is renewed as in ModifiedNewton; when the
+      factorization is renewed, the system is solved directly
+
+    The factorizations are computed by the gsSparseSolver "Solver".
+    The symbolic analysis is performed only once, as long as the
+    sparsity pattern of the Jacobian does not change.
+
     \tparam T coefficient type
     
     \ingroup Pde
@@ -30,6 +48,16 @@ namespace gismo
 template <class T> 
 class gsNewtonIterator
 {
+public:
+
+    /// Strategies for the linear systems
+    enum method
+    {
+        Newton              = 0, ///< Factorization in every iteration
+        ModifiedNewton      = 1, ///< Re-use of the factorization
+        InexactNewtonKrylov = 2  ///< Preconditioned Krylov solver
+    };
+
 public:
 
     /// Constructor giving access to the gsAssemblerBase object to
@@ -38,6 +66,7 @@ public:
                        const gsMultiPatch<T> & initialSolution)
     : m_assembler(assembler),
       m_curSolution(initialSolution),
+      m_options(defaultOptions()),
       m_numIterations(0),
       m_maxIterations(100),
       m_tolerance(1e-12),
@@ -48,6 +77,7 @@ public:
 
     gsNewtonIterator(gsAssembler<T> & assembler)
     : m_assembler(assembler),
+      m_options(defaultOptions()),
       m_numIterations(0),
       m_maxIterations(100),
       m_tolerance(1e-12),
@@ -56,6 +86,27 @@ public:
 
     }
 
+    /// \brief Returns the default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addInt   ("Method", "Linear solves: 0: Newton, 1: modified Newton, "
+                      "2: inexact Newton-Krylov", Newton);
+        opt.addString("Solver", "Sparse solver for the factorizations "
+                      "(see gsSparseSolver::get)", "LU");
+        opt.addInt   ("MaxReuse", "Maximum number of iterations with the same "
+                      "factorization (methods 1 and 2)", 5);
+        opt.addReal  ("ReuseRate", "Renew the factorization if the residue decreases "
+                      "by less than this factor (methods 1 and 2)", 0.5);
+        opt.addString("Krylov", "Krylov solver (method 2): GMRes or CG", "GMRes");
+        opt.addInt   ("KrylovMaxIterations", "Maximum number of Krylov iterations", 500);
+        opt.addReal  ("ForcingMax", "Upper bound of the forcing terms", 0.9);
+        return opt;
+    }
+
+    /// \brief Returns the options, see defaultOptions()
+    gsOptionList & options() { return m_options; }
+
 
 public:
 
@@ -94,12 +145,26 @@ public:
     /// \brief Set the tolerance for convergence
     void setTolerance(T tol) {m_tolerance = tol;}
 
+    /// \brief Returns the number of numerical factorizations performed
+    index_t numFactorizations() const { return m_numFactorizations; }
+
+    /// \brief Returns the total number of Krylov iterations performed
+    index_t numKrylovIterations() const { return m_numKrylov; }
+
 protected:
 
     virtual void solveLinearProblem(gsMatrix<T> &updateVector);
 
     virtual void solveLinearProblem(const gsMultiPatch<T> & currentSol, gsMatrix<T> &updateVector);
 
+    /// \brief Solves the assembled linear system according to the
+    /// option "Method"
+    void solveLinearSystem(gsMatrix<T> &updateVector);
+
+    /// \brief Factorizes \a mat, re-using the symbolic analysis if
+    /// the sparsity pattern is unchanged
+    void factorize(const gsSparseMatrix<T> & mat);
+
     virtual T getResidue() {return m_assembler.rhs().norm();}
 protected:
 
@@ -113,11 +178,23 @@ protected:
     /// \brief Solution of the linear system in each iteration
     gsMatrix<T>         m_updateVector;
 
-    /// Linear solver employed
-    //gsSparseSolver<>::LU  m_solver;
-    //typename gsSparseSolver<T>::BiCGSTABDiagonal m_solver;
-    //typename gsSparseSolver<>::CGDiagonal m_solver;
-    gsSparseSolver<>::LU  m_solver;
+    /// Options
+    gsOptionList m_options;
+
+    /// Linear solver employed, shared with the preconditioner
+    memory::shared_ptr<gsSparseSolver<T> > m_solver;
+
+    /// Sparsity pattern of the last analyzed matrix
+    std::vector<index_t> m_outer, m_inner;
+
+    /// Iterations since the last factorization
+    index_t m_reuse;
+
+    /// Residue at the previous linear solve, and previous forcing term
+    T m_prevResidue, m_eta;
+
+    /// Number of factorizations and of Krylov iterations
+    index_t m_numFactorizations, m_numKrylov;
 
 protected:
 
@@ -160,8 +237,7 @@ void gsNewtonIterator<T>::solveLinearProblem(gsMatrix<T>& updateVector)
     // gsDebugVar( m_assembler.rhs().transpose() );
 
     // Compute the newton update
-    m_solver.compute( m_assembler.matrix() );
-    updateVector = m_solver.solve( m_assembler.rhs() );
+    solveLinearSystem(updateVector);
     
     // gsDebugVar(updateVector);
 }
@@ -176,12 +252,101 @@ void gsNewtonIterator<T>::solveLinearProblem(const gsMultiPatch<T> & currentSol,
     // gsDebugVar( m_assembler.rhs().transpose() );
     
     // Compute the newton update
-    m_solver.compute( m_assembler.matrix() );
-    updateVector = m_solver.solve( m_assembler.rhs() );
+    solveLinearSystem(updateVector);
 
     // gsDebugVar(updateVector);
 }
 
+template <class T>
+void gsNewtonIterator<T>::factorize(const gsSparseMatrix<T> & mat)
+{
+    if (!m_solver)
+        m_solver = memory::shared_ptr<gsSparseSolver<T> >(
+            gsSparseSolver<T>::get( m_options.getString("Solver") ).release() );
+
+    const index_t nz = mat.nonZeros(), no = mat.outerSize() + 1;
+    const bool same = mat.isCompressed() &&
+        static_cast<index_t>(m_inner.size()) == nz &&
+        static_cast<index_t>(m_outer.size()) == no &&
+        std::equal(m_outer.begin(), m_outer.end(), mat.outerIndexPtr()) &&
+        std::equal(m_inner.begin(), m_inner.end(), mat.innerIndexPtr());
+    if (!same)
+    {
+        m_solver->analyzePattern(mat);
+        if (mat.isCompressed())
+        {
+            m_outer.assign(mat.outerIndexPtr(), mat.outerIndexPtr() + no);
+            m_inner.assign(mat.innerIndexPtr(), mat.innerIndexPtr() + nz);
+        }
+    }
+    m_solver->factorize(mat);
+    GISMO_ENSURE( m_solver->succeed(), "Factorization of the Jacobian failed." );
+    ++m_numFactorizations;
+    m_reuse = 0;
+}
+
+template <class T>
+void gsNewtonIterator<T>::solveLinearSystem(gsMatrix<T>& updateVector)
+{
+    const gsSparseMatrix<T> & mat = m_assembler.matrix();
+    const gsMatrix<T> & rhs = m_assembler.rhs();
+    const index_t meth = m_options.getInt("Method");
+    const T res = rhs.norm();
+
+    // Renew the factorization, if it is outdated
+    if ( Newton == meth || !m_solver ||
+         m_reuse >= m_options.getInt("MaxReuse") ||
+         res > m_options.getReal("ReuseRate") * m_prevResidue )
+        factorize(mat);
+    else
+        ++m_reuse;
+
+    if (InexactNewtonKrylov != meth || 0 == m_reuse)
+    {
+        // Solve with the (possibly outdated) factorization, the
+        // solution is exact if the factorization is fresh
+        updateVector = m_solver->solve(rhs);
+        m_eta = 0;
+    }
+    else
+    {
+        // Forcing term of Eisenstat and Walker (choice 2, gamma=0.9, alpha=2)
+        const T etaMax = m_options.getReal("ForcingMax");
+        const T etaPrev = m_eta;
+        m_eta = T(0.9) * math::pow(res / m_prevResidue, 2);
+        if ( T(0.9) * etaPrev * etaPrev > T(0.1) )
+            m_eta = math::max(m_eta, T(0.9) * etaPrev * etaPrev);
+        m_eta = math::min(m_eta, etaMax);
+
+        // The step with the outdated factorization is the initial guess
+        updateVector = m_solver->solve(rhs);
+
+        typename gsLinearOperator<T>::Ptr precond =
+            gsSparseSolverOp<T>::make(m_solver, mat.rows());
+        gsOptionList opt = gsIterativeSolver<T>::defaultOptions();
+        opt.setInt ("MaxIterations", m_options.getInt("KrylovMaxIterations"));
+
+        typename gsIterativeSolver<T>::uPtr krylov;
+        if ( "CG" == m_options.getString("Krylov") )
+        {
+            krylov = gsConjugateGradient<T>::make(mat, precond);
+            opt.setReal("Tolerance", m_eta);
+        }
+        else
+        {
+            // GMRes measures the preconditioned residual, relative
+            // to the unpreconditioned right-hand side
+            krylov = gsGMRes<T>::make(mat, precond);
+            opt.setReal("Tolerance", m_eta * updateVector.norm() / res);
+        }
+        krylov->setOptions(opt);
+
+        krylov->solve(rhs, updateVector);
+        m_numKrylov += krylov->iterations();
+    }
+    m_prevResidue = res;
+}
+
 
 template <class T> 
 void gsNewtonIterator<T>::solve()
@@ -215,6 +380,8 @@ void gsNewtonIterator<T>::firstIteration()
 {
     // ----- First iteration -----
     m_converged = false;
+    m_reuse = m_numFactorizations = m_numKrylov = 0;
+    m_prevResidue = std::numeric_limits<T>::max();
 
     // Solve 
     solveLinearProblem(m_updateVector);
@@ -0,0 +1,345 @@
+/** @file gsTimeIntegrator.h
+
+    @brief Time integration of linear semi-discrete systems M u' + K u = f(t)
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsIO/gsOptionList.h>
+
+namespace gismo
+{
+
+/**
+    @brief Integrates the linear system \f$ M u' + K u = f(t) \f$ in time.
+
+    The mass matrix \f$M\f$ and the stiffness matrix \f$K\f$ are given
+    once (e.g. by gsHeatEquation::mass() and
+    gsHeatEquation::stationaryMatrix()). All schemes lead to systems
+    with matrix \f$ a M + c K \f$; this matrix is assembled and
+    factorized only when the coefficients change, i.e. when the time
+    step changes. For constant steps every step costs only
+    back-substitutions and sparse matrix-vector products.
+
+    The scheme is chosen by the option "Method":
+    - Theta: the theta-scheme, with parameter "Theta" (0: explicit
+      Euler, 0.5: Crank-Nicolson, 1: implicit Euler)
+    - BDF2: the variable step BDF2 scheme, started by implicit Euler
+    - SDIRK2: the two-stage, L-stable SDIRK scheme of Alexander;
+      both stages use the same matrix
+
+    If "Adaptive" is set, the step size is controlled such that the
+    error indicator stays below "Tolerance" (relative to the size of
+    the solution). The indicator is the embedded first order solution
+    for SDIRK2, and the deviation from the linear extrapolation of the
+    two previous steps otherwise. Step sizes which are increased by
+    less than the factor "DeadZone" are not changed, in order to keep
+    the factorization.
+
+    \tparam T coefficient type
+
+    \ingroup Pde
+*/
+template <class T>
+class gsTimeIntegrator
+{
+public:
+
+    /// Time integration schemes
+    enum method
+    {
+        Theta  = 0, ///< theta-scheme
+        BDF2   = 1, ///< backward differentiation formula of order two
+        SDIRK2 = 2  ///< singly diagonally implicit Runge-Kutta of order two
+    };
+
+    /// Signature of a time dependent right-hand side, \a result is
+    /// set to the vector f(t)
+    typedef std::function<void(const T t, gsMatrix<T> & result)> Forcing;
+
+public:
+
+    /// Constructor by the mass matrix \a M, the stiffness matrix \a K
+    /// and the (time independent) right-hand side \a f
+    gsTimeIntegrator(const gsSparseMatrix<T> & M,
+                     const gsSparseMatrix<T> & K,
+                     const gsMatrix<T> & f)
+    : m_mass(M), m_stiff(K), m_rhs(f), m_options(defaultOptions()),
+      m_a(0), m_c(0), m_dt(0)
+    {
+        GISMO_ASSERT(M.rows() == K.rows() && M.cols() == K.cols() &&
+                     M.rows() == f.rows(), "Dimensions do not match.");
+        setInitialValue( gsMatrix<T>::Zero(f.rows(), f.cols()) );
+    }
+
+    /// Default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addInt   ("Method"  , "Scheme: 0 Theta, 1 BDF2, 2 SDIRK2", Theta);
+        opt.addReal  ("Theta"   , "Parameter of the theta-scheme [0..1]", 0.5);
+        opt.addString("Solver"  , "Sparse solver for the systems", "SimplicialLDLT");
+        opt.addSwitch("Adaptive", "Adaptive step size control", false);
+        opt.addReal  ("Tolerance", "Tolerance of the step size control", 1e-4);
+        opt.addReal  ("MinStep" , "Minimal step size of the step size control", 1e-10);
+        opt.addReal  ("MaxStep" , "Maximal step size of the step size control", 1e+10);
+        opt.addReal  ("Safety"  , "Safety factor of the step size control", 0.9);
+        opt.addReal  ("DeadZone", "Increases of the step size below this factor are ignored", 1.5);
+        return opt;
+    }
+
+    /// Returns the options, modify them before the first step
+    gsOptionList & options() { return m_options; }
+
+    /// Sets a time dependent right-hand side, replacing the constant one
+    void setForcing(const Forcing & f) { m_forcing = f; }
+
+    /// Sets the solution at time \a t0, and discards the history
+    void setInitialValue(const gsMatrix<T> & u0, const T t0 = 0)
+    {
+        GISMO_ASSERT(u0.rows() == m_mass.rows(), "Wrong size of initial value.");
+        m_sol = u0;
+        m_time = t0;
+        m_prevSol.resize(0, 0);
+        m_prevDt = 0;
+        m_numSteps = m_numRejected = m_numFactorizations = 0;
+    }
+
+    /// Sets the size of the next step
+    void setTimeStep(const T dt) { GISMO_ASSERT(dt>0, "Invalid step size."); m_dt = dt; }
+
+    /// Size of the next step (proposed by the step size control, if adaptive)
+    T timeStep() const { return m_dt; }
+
+    /// Current time
+    T time() const { return m_time; }
+
+    /// Solution at the current time
+    const gsMatrix<T> & solution() const { return m_sol; }
+
+    /// Number of accepted and of rejected steps
+    index_t numSteps() const { return m_numSteps; }
+    index_t numRejected() const { return m_numRejected; }
+
+    /// Number of factorizations performed so far
+    index_t numFactorizations() const { return m_numFactorizations; }
+
+    /// Performs one step of size timeStep(); if adaptive, the step is
+    /// repeated with smaller size until it is accepted. Returns the
+    /// size of the accepted step.
+    T step();
+
+    /// Performs steps until the time \a tEnd, the last step is
+    /// shortened to end at \a tEnd
+    void integrate(const T tEnd);
+
+private:
+
+    /// Computes the solution \a u at time m_time+dt and the error
+    /// indicator \a err, returns false if no indicator is available
+    bool attempt(const T dt, gsMatrix<T> & u, T & err);
+
+    /// Makes a factorization of a*M+c*K available
+    void factorize(const T a, const T c);
+
+    /// Right-hand side at time \a t
+    void forcing(const T t, gsMatrix<T> & result) const
+    {
+        if (m_forcing) m_forcing(t, result);
+        else result = m_rhs;
+    }
+
+private:
+
+    const gsSparseMatrix<T> & m_mass;
+    const gsSparseMatrix<T> & m_stiff;
+    gsMatrix<T> m_rhs;
+    Forcing     m_forcing;
+
+    gsOptionList m_options;
+
+    /// Factorization of m_a*M+m_c*K
+    typename gsSparseSolver<T>::uPtr m_solver;
+    T m_a, m_c;
+
+    /// Current and previous solution, current time and step sizes
+    gsMatrix<T> m_sol, m_prevSol;
+    T m_time, m_dt, m_prevDt;
+
+    index_t m_numSteps, m_numRejected, m_numFactorizations;
+
+    /// Temporaries
+    gsMatrix<T> m_f, m_f0, m_k1, m_k2, m_tmp;
+};
+
+} // namespace gismo
+
+
+namespace gismo
+{
+
+template <class T>
+void gsTimeIntegrator<T>::factorize(const T a, const T c)
+{
+    if (m_solver && a == m_a && c == m_c)
+        return;
+
+    const gsSparseMatrix<T> A = a * m_mass + c * m_stiff;
+    if (!m_solver)
+    {
+        // the sum has the union pattern, whatever the coefficients
+        m_solver = gsSparseSolver<T>::get( m_options.getString("Solver") );
+        m_solver->analyzePattern(A);
+    }
+    m_solver->factorize(A);
+    GISMO_ENSURE( m_solver->succeed(), "Factorization failed.");
+    m_a = a;
+    m_c = c;
+    ++m_numFactorizations;
+}
+
+template <class T>
+bool gsTimeIntegrator<T>::attempt(const T dt, gsMatrix<T> & u, T & err)
+{
+    const index_t meth = m_options.getInt("Method");
+    const bool history = 0 != m_prevSol.size();
+    switch (meth)
+    {
+    case Theta:
+    {
+        // (M + theta dt K) u1 = (M - (1-theta) dt K) u0 + dt f_theta
+        const T th = m_options.getReal("Theta");
+        forcing(m_time + dt, m_f);
+        if (th != 1)
+        {
+            forcing(m_time, m_f0);
+            m_f = th * m_f + (1-th) * m_f0;
+        }
+        factorize(1, th * dt);
+        m_tmp.noalias() = m_mass * m_sol;
+        if (th != 1)
+            m_tmp.noalias() -= ((1-th) * dt) * (m_stiff * m_sol);
+        m_tmp += dt * m_f;
+        u = m_solver->solve(m_tmp);
+        break;
+    }
+    case BDF2:
+    {
+        forcing(m_time + dt, m_f);
+        if (history)
+        {
+            // variable step BDF2 with w = dt / dt_prev
+            const T w = dt / m_prevDt;
+            factorize( (1+2*w) / (1+w), dt );
+            m_tmp.noalias() = m_mass * ( (1+w) * m_sol - (w*w/(1+w)) * m_prevSol );
+        }
+        else // implicit Euler start
+        {
+            factorize(1, dt);
+            m_tmp.noalias() = m_mass * m_sol;
+        }
+        m_tmp += dt * m_f;
+        u = m_solver->solve(m_tmp);
+        break;
+    }
+    case SDIRK2:
+    {
+        // Alexander's scheme, stiffly accurate with gamma = 1-1/sqrt(2)
+        const T g = 1 - 1 / math::sqrt(T(2));
+        factorize(1, g * dt);
+        forcing(m_time + g * dt, m_f);
+        m_tmp.noalias() = m_f - m_stiff * m_sol;
+        m_k1 = m_solver->solve(m_tmp);
+        u = m_sol + ((1-g) * dt) * m_k1;
+        forcing(m_time + dt, m_f);
+        m_tmp.noalias() = m_f - m_stiff * u;
+        m_k2 = m_solver->solve(m_tmp);
+        u += (g * dt) * m_k2;
+        // difference to the embedded solution u0 + dt k1
+        err = (g * dt) * (m_k2 - m_k1).norm();
+        return true;
+    }
+    default:
+        GISMO_ERROR("Unknown method "<< meth);
+    }
+
+    if (!history)
+        return false;
+    // deviation from the linear extrapolation of the last two steps
+    m_tmp = u - m_sol - (dt / m_prevDt) * (m_sol - m_prevSol);
+    err = m_tmp.norm();
+    return true;
+}
+
+template <class T>
+T gsTimeIntegrator<T>::step()
+{
+    const bool adaptive = m_options.getSwitch("Adaptive");
+    const T tol     = m_options.getReal("Tolerance");
+    const T minStep = m_options.getReal("MinStep");
+    const T maxStep = m_options.getReal("MaxStep");
+    const T safety  = m_options.getReal("Safety");
+    const T dead    = m_options.getReal("DeadZone");
+
+    GISMO_ASSERT(m_dt > 0, "The step size is not set.");
+    gsMatrix<T> u;
+    T err = 0, dt = m_dt;
+    for (;;)
+    {
+        const bool estimated = attempt(dt, u, err);
+        if (!adaptive || !estimated)
+            break;
+
+        // both indicators are of second order in dt
+        err /= tol * math::max(T(1), u.norm());
+        if (err <= 1 || dt <= minStep)
+        {
+            T fac = safety / math::sqrt(math::max(err, T(1e-10)));
+            fac = math::min(fac, T(5));
+            if (fac > 1 && fac < dead) fac = 1; // keep the factorization
+            m_dt = math::max(math::min(fac * dt, maxStep), minStep);
+            break;
+        }
+        ++m_numRejected;
+        dt = math::max(math::max(safety / math::sqrt(err), T(0.2)) * dt, minStep);
+    }
+
+    m_prevSol.swap(m_sol);
+    m_sol.swap(u);
+    m_prevDt = dt;
+    m_time += dt;
+    ++m_numSteps;
+    return dt;
+}
+
+template <class T>
+void gsTimeIntegrator<T>::integrate(const T tEnd)
+{
+    const T eps = 1e-12 * math::max(T(1), math::abs(tEnd));
+    while (m_time < tEnd - eps)
+    {
+        if (m_time + m_dt > tEnd + eps)
+        {
+            // shortened last step, a constant step size is kept
+            const T dt = m_dt;
+            m_dt = tEnd - m_time;
+            step();
+            if (!m_options.getSwitch("Adaptive"))
+                m_dt = dt;
+        }
+        else
+            step();
+    }
+    m_time = tEnd; // remove round-off of the accumulated steps
+}
+
+} // namespace gismo
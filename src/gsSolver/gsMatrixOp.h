@@ -223,6 +223,48 @@ private:
     index_t m_size;
 };
 
+/** @brief Adapter class to use a gsSparseSolver, which has already
+ * been computed, as a linear operator.
+ *
+ * The solver is shared, hence it can be re-computed by its owner
+ * (e.g. with a new factorization) while the operator is in use.
+ *
+ * \ingroup Solver
+ */
+template <class T>
+class gsSparseSolverOp GISMO_FINAL : public gsLinearOperator<T>
+{
+public:
+    typedef memory::shared_ptr<gsSparseSolver<T> > SolverPtr;
+
+    /// Shared pointer for gsSparseSolverOp
+    typedef memory::shared_ptr<gsSparseSolverOp> Ptr;
+
+    /// Unique pointer for gsSparseSolverOp
+    typedef memory::unique_ptr<gsSparseSolverOp> uPtr;
+
+    /// Constructor taking the solver and the size of the system
+    gsSparseSolverOp(const SolverPtr & solver, index_t size)
+    : m_solver(solver), m_size(size) { }
+
+    /// Make function taking the solver and the size of the system
+    static uPtr make(const SolverPtr & solver, index_t size)
+    { return memory::make_unique( new gsSparseSolverOp(solver, size) ); }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        x = m_solver->solve(input);
+    }
+
+    index_t rows() const { return m_size; }
+
+    index_t cols() const { return m_size; }
+
+private:
+    SolverPtr m_solver;
+    index_t m_size;
+};
+
 
 /// @brief Convenience function to create an LU solver with partial
 /// pivoting (for dense matrices) as a gsLinearOperator.
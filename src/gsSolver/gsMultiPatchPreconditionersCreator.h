@@ -0,0 +1,114 @@
+/** @file gsMultiPatchPreconditionersCreator.h
+
+    @brief Provides additive Schwarz preconditioners for multipatch geometries.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+#pragma once
+
+#include <gsAssembler/gsAssembler.h>
+#include <gsSolver/gsLinearOperator.h>
+
+
+namespace gismo
+{
+
+/// @brief Provides additive Schwarz preconditioners for multipatch geometries.
+///
+/// The subdomains are the patches, including the degrees of freedom on
+/// their interfaces, such that neighbouring subdomains overlap. On
+/// every patch, the problem is solved by the fast diagonalization
+/// method of \a gsPatchPreconditionersCreator (without any sparse
+/// factorization). The coarse space contains one function per patch
+/// (and component), which is a partition of unity; it takes care of the
+/// patches which do not touch the Dirichlet boundary.
+///
+/// The dof numbering is the one of \a gsAssembler for the same
+/// options, i.e., the mapper is obtained by \a gsMultiBasis::getMapper
+/// and \a gsDofMapper::reorder. Only the elimination of Dirichlet
+/// dofs is supported. A system with several components (like linear
+/// elasticity) is expected to be blocked by components, all of them
+/// discretized by the given basis.
+///
+/// \code{.cpp}
+///    gsMultiPatchPreconditionersCreator<> mpc(mb, bc);
+///    gsConjugateGradient<> cg(A, mpc.additiveSchwarzOp(A));
+/// \endcode
+///
+/// @ingroup Solver
+template<typename T>
+class gsMultiPatchPreconditionersCreator
+{
+    typedef typename gsLinearOperator<T>::uPtr OpUPtr;
+    typedef typename gsLinearOperator<T>::Ptr  OpPtr;
+public:
+    typedef gsSparseMatrix<T,RowMajor> Transfer;
+
+    /// Constructor
+    ///
+    /// \param mb     A multi basis consisting of tensor bases
+    /// \param bc     Boundary conditions
+    /// \param opt    Assembler options
+    gsMultiPatchPreconditionersCreator(
+        const gsMultiBasis<T>& mb,
+        const gsBoundaryConditions<T>& bc,
+        const gsOptionList& opt = gsAssembler<T>::defaultOptions()
+    );
+
+    /// The dof mapper of the global system
+    const gsDofMapper& dofMapper() const { return m_mapper; }
+
+    /// The number of patches
+    index_t nPatches() const { return m_mb.nBases(); }
+
+    /// The boundary conditions of the patch \a k, as a single patch
+    gsBoundaryConditions<T> localBoundaryConditions(index_t k) const;
+
+    /// The transfer matrices from the dofs of the patches (in the
+    /// numbering of \a gsPatchPreconditionersCreator) to the global dofs
+    const std::vector<Transfer>& localTransfers() const { return m_transfers; }
+
+    /// Provides the fast diagonalization operators of all patches, see
+    /// \a gsPatchPreconditionersCreator::fastDiagonalizationOp
+    ///
+    /// For \a alpha == 0, the mean value is added on the patches without
+    /// Dirichlet sides, which makes the local problems regular.
+    ///
+    /// \param alpha  Scaling parameter of the mass
+    /// \param beta   Scaling parameter of the stiffness
+    std::vector<OpPtr> fastDiagonalizationOps(T alpha = 0, T beta = 1) const;
+
+    /// The transfer matrix from the coarse space to the global dofs: the
+    /// column (c,k) is the indicator function of patch k in component
+    /// c, divided by the number of patches sharing the dof
+    ///
+    /// \param nComp  The number of components
+    Transfer coarseTransfer(index_t nComp = 1) const;
+
+    /// Provides the two level additive Schwarz preconditioner for the
+    /// operator \f$ - \beta \Delta u + \alpha u \f$ on every component
+    ///
+    /// \param A      The system matrix, which is used for the coarse problem
+    /// \param alpha  Scaling parameter of the mass on the patches
+    /// \param beta   Scaling parameter of the stiffness on the patches
+    OpUPtr additiveSchwarzOp(const gsSparseMatrix<T>& A, T alpha = 0, T beta = 1) const;
+
+private:
+    gsMultiBasis<T>         m_mb;
+    gsBoundaryConditions<T> m_bc;
+    gsOptionList            m_opt;
+    gsDofMapper             m_mapper;
+    std::vector<Transfer>   m_transfers;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsMultiPatchPreconditionersCreator.hpp)
+#endif
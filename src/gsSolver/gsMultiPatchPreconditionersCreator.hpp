@@ -0,0 +1,180 @@
+/** @file gsMultiPatchPreconditionersCreator.hpp
+
+    @brief Provides additive Schwarz preconditioners for multipatch geometries.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+#pragma once
+
+#include <gsSolver/gsAdditiveOp.h>
+#include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsPatchPreconditionersCreator.h>
+#include <gsUtils/gsCombinatorics.h>
+
+namespace gismo
+{
+
+template<typename T>
+gsMultiPatchPreconditionersCreator<T>::gsMultiPatchPreconditionersCreator(
+    const gsMultiBasis<T>& mb,
+    const gsBoundaryConditions<T>& bc,
+    const gsOptionList& opt
+    )
+: m_mb(mb), m_bc(bc), m_opt(opt)
+{
+    GISMO_ENSURE( dirichlet::elimination == m_opt.askInt("DirichletStrategy", dirichlet::elimination),
+                  "gsMultiPatchPreconditionersCreator: Only the elimination of Dirichlet dofs is supported." );
+
+    // The same numbering as the one of gsAssembler
+    m_mb.getMapper(
+        dirichlet::elimination,
+        static_cast<iFace::strategy>(m_opt.askInt("InterfaceStrategy", iFace::glue)),
+        m_bc, m_mapper, 0);
+    m_mapper.reorder(m_mb, static_cast<dofOrdering::type>(
+                         m_opt.askInt("DofOrdering", dofOrdering::natural)));
+
+    const index_t nP = m_mb.nBases();
+    m_transfers.resize(nP);
+    for (index_t k = 0; k < nP; ++k)
+    {
+        const gsBasis<T> & basis = m_mb[k];
+        const index_t d = basis.dim();
+
+        // The patch dofs remaining after eliminating the Dirichlet sides,
+        // cf. gsPatchPreconditionersCreator
+        gsVector<index_t> n(d), lo(d), hi(d);
+        index_t sz = 1;
+        for (index_t c = 0; c < d; ++c)
+        {
+            n[c] = basis.component(c).size();
+            const boundary_condition<T> * lower = m_bc.getConditionFromSide(patchSide(k, 2*c+1));
+            const boundary_condition<T> * upper = m_bc.getConditionFromSide(patchSide(k, 2*c+2));
+            lo[c] = ( lower && lower->type() == condition_type::dirichlet ) ? 1 : 0;
+            hi[c] = n[c] - 1 - (( upper && upper->type() == condition_type::dirichlet ) ? 1 : 0);
+            sz *= math::max(hi[c] - lo[c] + 1, (index_t)0);
+        }
+
+        gsSparseEntries<T> se;
+        se.reserve(sz);
+        if (sz > 0)
+        {
+            gsVector<index_t> i = lo;
+            index_t l = 0;
+            do
+            {
+                index_t b = 0;
+                for (index_t c = d-1; c >= 0; --c)
+                    b = b * n[c] + i[c];
+                // Dofs on interfaces to eliminated sides of neighbours are
+                // not free
+                if ( m_mapper.is_free(b, k) )
+                    se.add(m_mapper.index(b, k), l, (T)1);
+                ++l;
+            }
+            while ( nextCubePoint(i, lo, hi) );
+        }
+        m_transfers[k].resize(m_mapper.freeSize(), sz);
+        m_transfers[k].setFrom(se);
+        m_transfers[k].makeCompressed();
+    }
+}
+
+template<typename T>
+gsBoundaryConditions<T> gsMultiPatchPreconditionersCreator<T>::localBoundaryConditions(index_t k) const
+{
+    gsBoundaryConditions<T> result;
+    for (index_t s = 1; s <= 2*m_mb.dim(); ++s)
+    {
+        const boundary_condition<T> * cond = m_bc.getConditionFromSide(patchSide(k, s));
+        if (cond)
+            result.addCondition(0, boxSide(s), cond->type(), cond->function());
+    }
+    return result;
+}
+
+template<typename T>
+std::vector<typename gsMultiPatchPreconditionersCreator<T>::OpPtr>
+gsMultiPatchPreconditionersCreator<T>::fastDiagonalizationOps(T alpha, T beta) const
+{
+    const index_t nP = m_mb.nBases();
+    std::vector<OpPtr> result(nP);
+    for (index_t k = 0; k < nP; ++k)
+    {
+        const gsBoundaryConditions<T> bc = localBoundaryConditions(k);
+        // Pure Neumann patches: add the mean value to fix the constants
+        const T gamma = ( 0 == alpha && 0 == bc.dirichletSides().size() ) ? beta : (T)0;
+        result[k] = gsPatchPreconditionersCreator<T>::fastDiagonalizationOp(
+            m_mb[k], bc, m_opt, alpha, beta, gamma);
+    }
+    return result;
+}
+
+template<typename T>
+typename gsMultiPatchPreconditionersCreator<T>::Transfer
+gsMultiPatchPreconditionersCreator<T>::coarseTransfer(index_t nComp) const
+{
+    const index_t nP = m_mb.nBases();
+    const index_t N  = m_mapper.freeSize();
+
+    // Number of patches sharing a dof
+    gsVector<index_t> mult;
+    mult.setZero(N);
+    for (index_t k = 0; k < nP; ++k)
+        for (index_t i = 0; i < N; ++i)
+            for (typename Transfer::InnerIterator it(m_transfers[k], i); it; ++it)
+                ++mult[i];
+
+    gsSparseEntries<T> se;
+    se.reserve(nComp * mult.sum());
+    for (index_t k = 0; k < nP; ++k)
+        for (index_t i = 0; i < N; ++i)
+            for (typename Transfer::InnerIterator it(m_transfers[k], i); it; ++it)
+                for (index_t c = 0; c < nComp; ++c)
+                    se.add(c * N + i, c * nP + k, (T)1 / mult[i]);
+
+    Transfer result(nComp * N, nComp * nP);
+    result.setFrom(se);
+    result.makeCompressed();
+    return result;
+}
+
+template<typename T>
+typename gsMultiPatchPreconditionersCreator<T>::OpUPtr
+gsMultiPatchPreconditionersCreator<T>::additiveSchwarzOp(const gsSparseMatrix<T>& A, T alpha, T beta) const
+{
+    const index_t nP = m_mb.nBases();
+    const index_t N  = m_mapper.freeSize();
+    GISMO_ENSURE( N > 0 && A.rows() == A.cols() && 0 == A.rows() % N,
+                  "gsMultiPatchPreconditionersCreator: The matrix does not fit the dof mapper." );
+    const index_t nComp = A.rows() / N;
+
+    // Subdomain solvers, shared by the components
+    const std::vector<OpPtr> local = fastDiagonalizationOps(alpha, beta);
+
+    typename gsAdditiveOp<T>::uPtr result = gsAdditiveOp<T>::make();
+    for (index_t c = 0; c < nComp; ++c)
+        for (index_t k = 0; k < nP; ++k)
+        {
+            if (0 == m_transfers[k].cols()) continue;
+            // Move the rows to the block of the component
+            Transfer tr(nComp * N, m_transfers[k].cols());
+            tr.middleRows(c * N, N) = m_transfers[k];
+            result->addOperator(give(tr), local[k]);
+        }
+
+    // Coarse problem
+    Transfer coarse = coarseTransfer(nComp);
+    const gsSparseMatrix<T> P = coarse;
+    const gsSparseMatrix<T> A0 = P.transpose() * (A * P);
+    result->addOperator(give(coarse), makeSparseCholeskySolver(A0));
+
+    return give(result);
+}
+
+} // namespace gismo
@@ -0,0 +1,9 @@
+#include <gsSolver/gsMultiPatchPreconditionersCreator.h>
+#include <gsSolver/gsMultiPatchPreconditionersCreator.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsMultiPatchPreconditionersCreator<real_t>;
+
+} // namespace gismo
@@ -0,0 +1,122 @@
+/** @file gsPipelinedCG.h
+
+    @brief Pipelined conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+
+namespace gismo
+{
+
+/// @brief The pipelined (preconditioned) conjugate gradient method.
+///
+/// This is the variant of Ghysels and Vanroose, which is
+/// mathematically equivalent to gsConjugateGradient. All inner
+/// products of an iteration are computed by a single reduction, which
+/// is fused with the vector updates, i.e., every iteration consists
+/// of one application of the preconditioner, one application of the
+/// matrix and one sweep over the vectors.
+///
+/// The recurrences accumulate rounding errors in the residual; every
+/// "ReplacementPeriod" iterations, the residual is recomputed from
+/// its definition.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsPipelinedCG : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef memory::shared_ptr<gsPipelinedCG> Ptr;
+    typedef memory::unique_ptr<gsPipelinedCG> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsPipelinedCG( const OperatorType& mat,
+                            const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond), m_replace(50) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsPipelinedCG(mat, precond) ); }
+
+    /// @brief Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt("ReplacementPeriod", "Number of iterations after which the"
+                   " residual is recomputed (0: never)", 50 );
+        return opt;
+    }
+
+    /// @brief Set the options based on a gsOptionList
+    gsPipelinedCG& setOptions(const gsOptionList& opt)
+    {
+        Base::setOptions(opt);
+        m_replace = opt.askInt("ReplacementPeriod", m_replace);
+        return *this;
+    }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsPipelinedCG\n";
+        return os;
+    }
+
+private:
+    /// Computes r = b - A x, u = P r, w = A u and the inner products
+    void residual( const VectorType& x );
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+
+    const VectorType * m_rhs;
+    index_t m_replace;
+
+    // residual, preconditioned residual and A applied to it
+    VectorType m_r, m_u, m_w;
+    // search direction p and its images s = A p, q = P s, z = A q
+    VectorType m_p, m_s, m_q, m_z;
+    // m = P w, n = A m
+    VectorType m_m, m_n;
+
+    T m_gamma, m_delta, m_alpha, m_gammaOld;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsPipelinedCG.hpp)
+#endif
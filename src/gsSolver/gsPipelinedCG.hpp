@@ -0,0 +1,116 @@
+/** @file gsPipelinedCG.hpp
+
+    @brief Pipelined conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+namespace gismo
+{
+
+template<class T>
+void gsPipelinedCG<T>::residual( const typename gsPipelinedCG<T>::VectorType& x )
+{
+    m_mat->apply(x, m_r);
+    m_r = *m_rhs - m_r;
+    m_precond->apply(m_r, m_u);
+    m_mat->apply(m_u, m_w);
+
+    const index_t n = m_r.rows();
+    const T * r = m_r.data(), * u = m_u.data(), * w = m_w.data();
+    T g = 0, d = 0, rr = 0;
+#   pragma omp parallel for reduction(+:g,d,rr)
+    for (index_t i = 0; i < n; ++i)
+    {
+        g  += r[i] * u[i];
+        d  += w[i] * u[i];
+        rr += r[i] * r[i];
+    }
+    m_gamma = g;
+    m_delta = d;
+    m_error = math::sqrt(rr) / m_rhs_norm;
+}
+
+template<class T>
+bool gsPipelinedCG<T>::initIteration( const typename gsPipelinedCG<T>::VectorType& rhs,
+                                      typename gsPipelinedCG<T>::VectorType& x )
+{
+    if (Base::initIteration(rhs,x))
+        return true;
+
+    m_rhs = &rhs;
+    residual(x);
+    if (m_error < m_tol)
+        return true;
+
+    const index_t n = rhs.rows();
+    m_p.setZero(n,1);
+    m_s.setZero(n,1);
+    m_q.setZero(n,1);
+    m_z.setZero(n,1);
+    m_alpha = 1;
+    m_gammaOld = 0;
+    return false;
+}
+
+template<class T>
+bool gsPipelinedCG<T>::step( typename gsPipelinedCG<T>::VectorType& x )
+{
+    // These applications overlap with the reduction in a
+    // distributed setting
+    m_precond->apply(m_w, m_m);
+    m_mat->apply(m_m, m_n);
+
+    const T beta  = (1 == m_num_iter ? 0 : m_gamma / m_gammaOld);
+    const T alpha = m_gamma / (m_delta - beta * m_gamma / m_alpha);
+    m_alpha    = alpha;
+    m_gammaOld = m_gamma;
+
+    // Fused vector updates and inner products
+    const index_t n = x.rows();
+    T * xx = x.data(), * r = m_r.data(), * u = m_u.data(), * w = m_w.data();
+    T * p  = m_p.data(), * s = m_s.data(), * q = m_q.data(), * z = m_z.data();
+    const T * mm = m_m.data(), * nn = m_n.data();
+    T g = 0, d = 0, rr = 0;
+#   pragma omp parallel for reduction(+:g,d,rr)
+    for (index_t i = 0; i < n; ++i)
+    {
+        z[i] = nn[i] + beta * z[i];
+        q[i] = mm[i] + beta * q[i];
+        s[i] = w[i]  + beta * s[i];
+        p[i] = u[i]  + beta * p[i];
+        xx[i] += alpha * p[i];
+        r[i]  -= alpha * s[i];
+        u[i]  -= alpha * q[i];
+        w[i]  -= alpha * z[i];
+        g  += r[i] * u[i];
+        d  += w[i] * u[i];
+        rr += r[i] * r[i];
+    }
+    m_gamma = g;
+    m_delta = d;
+    m_error = math::sqrt(rr) / m_rhs_norm;
+
+    if (m_error < m_tol)
+        return true;
+
+    if (0 != m_replace && 0 == m_num_iter % m_replace)
+    {
+        // Residual replacement: recompute the recurrences from their definitions
+        residual(x);
+        m_mat->apply(m_p, m_s);
+        m_precond->apply(m_s, m_q);
+        m_mat->apply(m_q, m_z);
+        if (m_error < m_tol)
+            return true;
+    }
+    return false;
+}
+
+} // namespace gismo
@@ -0,0 +1,127 @@
+/** @file gsSStepGMRes.h
+
+    @brief Communication avoiding (s-step) GMRES solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+
+namespace gismo
+{
+
+/// @brief The s-step (communication avoiding) GMRES method.
+///
+/// The method is restarted after "Blocks" times "Steps" iterations.
+/// The Krylov basis is extended in blocks of s vectors, which are
+/// computed by s applications of the right-preconditioned operator
+/// to the last basis vector (scaled monomials). Every block is
+/// orthogonalized against the previous basis by block Gram-Schmidt,
+/// and internally by the Cholesky QR factorization of its Gram
+/// matrix. This needs two reductions per block, whereas gsGMRes needs
+/// k+1 reductions in iteration k. The Hessenberg matrix of the
+/// Arnoldi relation is recovered from the coefficients of the
+/// orthogonalization.
+///
+/// The scaling factors of the monomials are the norms measured in the
+/// first block. If the Gram matrix of a block is numerically singular
+/// (e.g. when the Krylov space is exhausted), a smaller block is
+/// used.
+///
+/// The error is the relative norm of the unpreconditioned residual,
+/// which is recomputed at every restart.
+/// The number of iterations counts the applications of the operator.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsSStepGMRes : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef memory::shared_ptr<gsSStepGMRes> Ptr;
+    typedef memory::unique_ptr<gsSStepGMRes> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsSStepGMRes( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond), m_s(5), m_t(4) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsSStepGMRes(mat, precond) ); }
+
+    /// @brief Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt("Steps" , "Number of basis vectors per block (s)", 5 );
+        opt.addInt("Blocks", "Number of blocks before restart", 4 );
+        return opt;
+    }
+
+    /// @brief Set the options based on a gsOptionList
+    gsSStepGMRes& setOptions(const gsOptionList& opt)
+    {
+        Base::setOptions(opt);
+        m_s = opt.askInt("Steps" , m_s);
+        m_t = opt.askInt("Blocks", m_t);
+        return *this;
+    }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsSStepGMRes\n";
+        return os;
+    }
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+
+    index_t m_s, m_t;
+
+    const VectorType * m_rhs;
+
+    // Residual and its norm
+    VectorType m_r;
+    T m_beta;
+
+    // Orthonormal basis, Hessenberg matrix, current block and scaling factors
+    gsMatrix<T> m_U, m_H, m_W;
+    gsVector<T> m_sigma;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsSStepGMRes.hpp)
+#endif
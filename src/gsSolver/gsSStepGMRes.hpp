@@ -0,0 +1,148 @@
+/** @file gsSStepGMRes.hpp
+
+    @brief Communication avoiding (s-step) GMRES solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+namespace gismo
+{
+
+template<class T>
+bool gsSStepGMRes<T>::initIteration( const typename gsSStepGMRes<T>::VectorType& rhs,
+                                     typename gsSStepGMRes<T>::VectorType& x )
+{
+    if (Base::initIteration(rhs,x))
+        return true;
+
+    GISMO_ASSERT(m_s > 0, "The number of steps must be positive.");
+    m_sigma.resize(0);
+
+    m_rhs = &rhs;
+    m_mat->apply(x, m_r);
+    m_r = rhs - m_r;
+    m_beta = m_r.norm();
+    m_error = m_beta / m_rhs_norm;
+    return m_error < m_tol;
+}
+
+template<class T>
+bool gsSStepGMRes<T>::step( typename gsSStepGMRes<T>::VectorType& x )
+{
+    typedef typename gsMatrix<T>::Base Base_t;
+    const index_t n = m_r.rows();
+    const index_t m = m_s * m_t;
+    const bool first = 0 == m_sigma.size();
+    if (first)
+        m_sigma.resize(m_s);
+
+    m_U.resize(n, m + 1);
+    m_U.col(0) = m_r / m_beta;
+    m_H.setZero(m + 1, m);
+
+    VectorType v, z, az;
+    gsMatrix<T> C, G, R, T_, M_;
+    gsVector<T> e, y;
+    gsEigen::LLT<Base_t> llt;
+    index_t j = 0; // index of the last basis vector
+    while (j < m)
+    {
+        // Monomial basis of the block, no reductions
+        const index_t sb = math::min(m_s, m - j);
+        m_W.resize(n, sb);
+        v = m_U.col(j);
+        for (index_t k = 0; k != sb; ++k)
+        {
+            m_precond->apply(v, z);
+            m_mat->apply(z, az);
+            if (first && 0 == j)
+            {
+                m_sigma[k] = az.norm();
+                if (0 == m_sigma[k]) m_sigma[k] = 1;
+            }
+            m_W.col(k) = az / m_sigma[k];
+            v = m_W.col(k);
+        }
+
+        // Block Gram-Schmidt against U_{0..j}, one reduction
+        C.noalias() = m_U.leftCols(j + 1).transpose() * m_W;
+        m_W.noalias() -= m_U.leftCols(j + 1) * C;
+
+        // Cholesky QR of the largest well conditioned leading block,
+        // one reduction
+        G.noalias() = m_W.transpose() * m_W;
+        index_t k = sb;
+        for (; k > 0; --k)
+        {
+            llt.compute( G.topLeftCorner(k, k) );
+            if (gsEigen::Success != llt.info()) continue;
+            const gsVector<T> d = llt.matrixL().toDenseMatrix().diagonal();
+            if (d.minCoeff() > T(1e-7) * math::max(d.maxCoeff(), T(1))) break;
+        }
+
+        if (0 == k) // the Krylov space is exhausted: A P q_j = sigma_0 U c_0
+        {
+            m_H.col(j).head(j + 1) = m_sigma[0] * C.col(0);
+            ++j;
+            break;
+        }
+
+        R = llt.matrixU();
+        m_U.middleCols(j + 1, k) = R.template triangularView<gsEigen::Upper>()
+            .template solve<gsEigen::OnTheRight>( m_W.leftCols(k) );
+
+        // The block vectors w_i have the coordinates a_i = [C_i; R_i]
+        // in U. With X = [q_j, w_1..w_{k-1}] = U T and A P X = U M,
+        // the Arnoldi relation A P U = U H holds for H = M T^{-1}.
+        T_.setIdentity(j + k, j + k);
+        M_.setZero(j + k + 1, j + k);
+        M_.topLeftCorner(j + 1, j) = m_H.topLeftCorner(j + 1, j);
+        for (index_t i = 0; i != k; ++i)
+        {
+            M_.col(j + i).head(j + 1) = m_sigma[i] * C.col(i);
+            M_.col(j + i).segment(j + 1, i + 1) = m_sigma[i] * R.col(i).head(i + 1);
+            if (i + 1 < k)
+            {
+                T_.col(j + i + 1).head(j + 1) = C.col(i);
+                T_.col(j + i + 1).segment(j + 1, i + 1) = R.col(i).head(i + 1);
+            }
+        }
+        m_H.topLeftCorner(j + k + 1, j + k) = T_.template triangularView<gsEigen::Upper>()
+            .template solve<gsEigen::OnTheRight>(M_);
+        j += k;
+
+        // Least squares problem min |beta e_1 - H y|
+        e.setZero(j + 1);
+        e[0] = m_beta;
+        y = m_H.topLeftCorner(j + 1, j).colPivHouseholderQr().solve(e);
+        if ( (e - m_H.topLeftCorner(j + 1, j) * y).norm() < m_tol * m_rhs_norm )
+            break;
+    }
+
+    if (y.size() != j) // after a breakdown
+    {
+        e.setZero(j + 1);
+        e[0] = m_beta;
+        y = m_H.topLeftCorner(j + 1, j).colPivHouseholderQr().solve(e);
+    }
+
+    // Update the solution and restart with the true residual
+    v.noalias() = m_U.leftCols(j) * y;
+    m_precond->apply(v, z);
+    x += z;
+    m_mat->apply(x, m_r);
+    m_r = *m_rhs - m_r;
+
+    m_beta  = m_r.norm();
+    m_error = m_beta / m_rhs_norm;
+    m_num_iter += j - 1;
+    return m_error < m_tol;
+}
+
+} // namespace gismo
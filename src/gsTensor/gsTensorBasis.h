@@ -308,6 +308,19 @@ public:
     typename gsGeometry<T>::uPtr interpolateGrid(gsMatrix<T> const& vals,
                                     std::vector<gsMatrix<T> >const& grid) const;
 
+    /// @brief Evaluates the function with coefficients \a coefs on a
+    /// tensor-grid of points, given in tensor form (d coordinate-wise
+    /// vectors).
+    ///
+    /// The univariate basis functions are tabulated once per
+    /// direction and contracted with the coefficient tensor, see
+    /// tensorKroneckerApply. The result has the layout of eval_into
+    /// (\a deriv = 0) or deriv_into (\a deriv = 1) of the function,
+    /// with the points ordered lexicographically, as in gsPointGrid.
+    void evalGrid_into(std::vector<gsMatrix<T> > const& grid,
+                       gsMatrix<T> const& coefs, gsMatrix<T>& result,
+                       int deriv = 0) const;
+
     /// Prints the object as a string, pure virtual function of gsTensorBasis.
     virtual std::ostream &print(std::ostream &os) const = 0;
 
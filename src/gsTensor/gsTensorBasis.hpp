@@ -968,6 +968,53 @@ gsTensorBasis<d,T>::interpolateGrid(gsMatrix<T> const& vals,
     return this->makeGeometry( give(q0) );
 }
 
+template<short_t d, class T>
+void gsTensorBasis<d,T>::evalGrid_into(std::vector<gsMatrix<T> > const& grid,
+                                       gsMatrix<T> const& coefs,
+                                       gsMatrix<T>& result, int deriv) const
+{
+    GISMO_ASSERT( static_cast<short_t>(grid.size()) == d, "Expecting one point vector per direction." );
+    GISMO_ASSERT( this->size() == coefs.rows(), "Invalid number of coefficients." );
+    GISMO_ENSURE( 0 == deriv || 1 == deriv, "Only values and first derivatives are supported." );
+
+    // Per-direction tables of values (and derivatives)
+    std::vector<std::vector<gsSparseMatrix<T> > > tab(d);
+    for (short_t i = 0; i < d; ++i)
+    {
+        if (0 == deriv)
+            tab[i].push_back( m_bases[i]->collocationMatrix(grid[i]) );
+        else
+            tab[i] = gsBasis<T>::collocationMatrixWithDeriv(*m_bases[i], grid[i]);
+    }
+
+    const index_t n = coefs.cols();
+    std::vector<const gsSparseMatrix<T>*> B(d);
+    for (short_t i = 0; i < d; ++i)
+        B[i] = &tab[i][0];
+
+    gsMatrix<T> q;
+    if (0 == deriv)
+    {
+        q = coefs;
+        tensorKroneckerApply(B, q);
+        result = q.transpose();
+        return;
+    }
+
+    // The j-th partial derivative uses the derivative table in direction j
+    for (short_t j = 0; j < d; ++j)
+    {
+        B[j] = &tab[j][1];
+        q = coefs;
+        tensorKroneckerApply(B, q);
+        B[j] = &tab[j][0];
+        if (0 == j)
+            result.resize(d * n, q.rows());
+        for (index_t c = 0; c != n; ++c)
+            result.row(c * d + j) = q.col(c).transpose();
+    }
+}
+
 
 template<short_t d, class T>
 void gsTensorBasis<d,T>::matchWith(const boundaryInterface & bi,
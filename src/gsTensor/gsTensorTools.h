@@ -120,6 +120,37 @@ void tensorStrides(const VectIn & sz, VectOut & strides)
         strides[i] = strides[i-1] * sz[i-1];
 }
 
+/// \brief Applies (inplace) the Kronecker product \f$B_{d-1}\otimes
+/// \cdots \otimes B_0\f$ of the matrices \a B to every column of \a
+/// coefs, each column being a flattened tensor of sizes
+/// B[0]->cols(),..,B[d-1]->cols(). The product is computed one
+/// direction at a time, without forming the Kronecker matrix.
+/// \ingroup Tensor
+template <typename T, typename MatrixType>
+void tensorKroneckerApply(const std::vector<const MatrixType*> & B,
+                          gsMatrix<T> & coefs)
+{
+    // Note: algorithm relies on col-major matrices
+    const index_t n = coefs.cols();
+    index_t sz = coefs.rows();
+    gsMatrix<T> tmp;
+    for (size_t i = 0; i != B.size(); ++i)
+    {
+        const index_t sz_i = B[i]->cols(), m_i = B[i]->rows(), r_i = sz / sz_i;
+        GISMO_ASSERT( r_i * sz_i == sz, "Sizes do not match: "<< sz_i <<" does not divide "<< sz );
+
+        // Apply B[i] to the first direction, which becomes the last one
+        coefs.resize(sz_i, n * r_i);
+        tmp.resize(r_i, n * m_i);
+        for (index_t k = 0; k != n; ++k)
+            tmp.middleCols(k * m_i, m_i).noalias() =
+                (*B[i] * coefs.middleCols(k * r_i, r_i)).transpose();
+        coefs.swap(tmp);
+        sz = r_i * m_i;
+    }
+    coefs.resize(sz, n);
+}
+
 /// Reorders (inplace) the given tensor \a coefs vector (regarded as a
 /// \a sz.prod() x \a d matrix arranged as a flattened \a sz tensor,
 /// so that the rows are re-arranged so that \a k1 and \a k2 are swapped
@@ -369,6 +369,67 @@ public:
 
 }; //struct
 
+/** \brief Patch-wise L2 projection onto a fixed basis, which keeps
+    the factorized mass matrices.
+
+    The mass matrix of every patch is assembled and factorized once,
+    in parallel over the patches, at construction. Every call of
+    project() assembles the right-hand side of the source and performs
+    a back-substitution per patch, hence projecting many functions onto
+    the same basis is cheap. The result is the projection of
+    gsL2Projection with "Continuity" equal to -1.
+
+    The basis and the geometry are kept by reference.
+
+    \tparam T coefficient type
+ */
+template <class T>
+class gsL2Projector
+{
+public:
+
+    /// Factorizes the mass matrices of \a basis on \a geometry
+    gsL2Projector(const gsMultiBasis<T> & basis,
+                  const gsMultiPatch<T> & geometry,
+                  const gsOptionList    & options = defaultOptions());
+
+    /// Returns the options: "LinearSolver" (see gsSparseSolver::get),
+    /// "quA" and "quB" (see gsQuadrature)
+    static gsOptionList defaultOptions();
+
+    /**
+     * @brief      Projects \a source, evaluated at the parameters of
+     *             the patches
+     *
+     * @param[in]  source  The source function (set)
+     * @param      coefs   The coefficients on all patches, stacked
+     *                     patch-wise as in gsMultiPatch::coefs()
+     */
+    void project(const gsFunctionSet<T> & source, gsMatrix<T> & coefs) const;
+
+    /// Projects \a source and returns the projection as a multipatch
+    void project(const gsFunctionSet<T> & source, gsMultiPatch<T> & result) const;
+
+    /// Returns the offset of the coefficients of patch \a p in the
+    /// result of project()
+    index_t offset(index_t p) const { return m_offsets[p]; }
+
+private:
+
+    // Assembles the mass matrix (if \a mass is not NULL) and the
+    // right-hand side of \a source (if \a rhs is not NULL) on patch p
+    void assemble(index_t p, const gsFunctionSet<T> * source,
+                  gsSparseMatrix<T> * mass, gsMatrix<T> * rhs) const;
+
+private:
+    const gsMultiBasis<T> & m_basis;
+    const gsMultiPatch<T> & m_geometry;
+    gsOptionList m_options;
+
+    std::vector<typename gsSparseSolver<T>::uPtr> m_solvers;
+    std::vector<index_t> m_offsets;
+};
+
 } // gismo
 
 #ifndef GISMO_BUILD_LIB
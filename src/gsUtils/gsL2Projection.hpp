@@ -93,7 +93,7 @@ T gsL2Projection<T>::projectGeometry(   const gsBasis<T> & basis,
     // assemble system
     A.assemble(u*u.tr() * meas(G),u * f * meas(G));
 
-    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<T>::get( "SimplicialLDLT" );
+    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<T>::get( "CachedSimplicialLDLT" );
     solver->compute(A.matrix());
     result = solver->solve(A.rhs());
 
@@ -125,7 +125,7 @@ T gsL2Projection<T>::projectGeometry(   const gsMultiBasis<T> & basis,
     // assemble system
     A.assemble(u*u.tr() * meas(G),u * f * meas(G));
 
-    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "SimplicialLDLT" );
+    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "CachedSimplicialLDLT" );
     solver->compute(A.matrix());
     solVector = solver->solve(A.rhs());
 
@@ -154,7 +154,7 @@ T gsL2Projection<T>::projectGeometry(   const gsMultiBasis<T> & basis,
     // assemble system
     A.assemble(u*u.tr() * meas(G),u * f * meas(G));
 
-    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<T>::get( "SimplicialLDLT" );
+    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<T>::get( "CachedSimplicialLDLT" );
     solver->compute(A.matrix());
     result = solver->solve(A.rhs());
 
@@ -182,7 +182,7 @@ T gsL2Projection<T>::projectGeometry(   const gsMultiBasis<T> & intbasis,
     // assemble system
     A.assemble(u*u.tr()*meas(G),u * f*meas(G));
 
-    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "SimplicialLDLT" );
+    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "CachedSimplicialLDLT" );
     solver->compute(A.matrix());
     result = solver->solve(A.rhs());
 
@@ -214,7 +214,7 @@ T gsL2Projection<T>::projectFunction(    const gsMultiBasis<T> & basis,
     // assemble system
     A.assemble(u*u.tr() * meas(G),u * f * meas(G));
 
-    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "SimplicialLDLT" );
+    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "CachedSimplicialLDLT" );
     solver->compute(A.matrix());
     solVector = solver->solve(A.rhs());
 
@@ -245,7 +245,7 @@ T gsL2Projection<T>::projectFunction(    const gsMultiBasis<T> & basis,
     // assemble system
     A.assemble(u*u.tr() * meas(G),u * f * meas(G));
 
-    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "SimplicialLDLT" );
+    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "CachedSimplicialLDLT" );
     solver->compute(A.matrix());
     result = solver->solve(A.rhs());
     gsExprEvaluator<> ev(A);
@@ -273,7 +273,7 @@ T gsL2Projection<T>::projectFunction(    const gsMultiBasis<T>   & intbasis,
     // assemble system
     A.assemble(u*u.tr()*meas(G),u * f *meas(G));
 
-    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "SimplicialLDLT" );
+    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "CachedSimplicialLDLT" );
     solver->compute(A.matrix());
     result = solver->solve(A.rhs());
 
@@ -314,7 +314,7 @@ T gsL2Projection<T>::projectGeometryBoundaries(const gsMultiBasis<T> & basis,
     // assemble system
     A.assemble(u*u.tr()*meas(G),u * G*meas(G));
 
-    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "SimplicialLDLT" );
+    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "CachedSimplicialLDLT" );
     solver->compute(A.matrix());
     solVector = solver->solve(A.rhs());
 
@@ -381,7 +381,7 @@ T gsL2Projection<T>::projectGeometryPenalty(const gsMultiBasis<T> & basis,
                     penalty / el.area(G) * u.right()* u.right().tr() * tv(G).norm()
                      );
 
-    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "SimplicialLDLT" );
+    typename gsSparseSolver<T>::uPtr solver = gsSparseSolver<real_t>::get( "CachedSimplicialLDLT" );
     solver->compute(A.matrix());
     solVector = solver->solve(A.rhs());
 
@@ -394,4 +394,131 @@ T gsL2Projection<T>::projectGeometryPenalty(const gsMultiBasis<T> & basis,
 
 
 
+template<typename T>
+gsL2Projector<T>::gsL2Projector(const gsMultiBasis<T> & basis,
+                                const gsMultiPatch<T> & geometry,
+                                const gsOptionList    & options)
+:
+m_basis(basis), m_geometry(geometry), m_options(defaultOptions())
+{
+    GISMO_ASSERT( basis.nBases() == geometry.nPatches(), "Expecting one basis per patch." );
+    m_options.update(options, gsOptionList::addIfUnknown);
+
+    const index_t np = m_basis.nBases();
+    m_offsets.resize(np + 1);
+    m_offsets[0] = 0;
+    for (index_t p = 0; p != np; ++p)
+        m_offsets[p + 1] = m_offsets[p] + m_basis.basis(p).size();
+
+    const std::string slv = m_options.getString("LinearSolver");
+    m_solvers.resize(np);
+#   pragma omp parallel
+    {
+        gsSparseMatrix<T> mass;
+#       pragma omp for schedule(dynamic)
+        for (index_t p = 0; p < np; ++p)
+        {
+            assemble(p, NULL, &mass, NULL);
+            m_solvers[p] = gsSparseSolver<T>::get(slv);
+            m_solvers[p]->compute(mass);
+        }
+    }//omp parallel
+}
+
+template<typename T>
+gsOptionList gsL2Projector<T>::defaultOptions()
+{
+    gsOptionList opt;
+    opt.addString("LinearSolver", "Sparse solver for the patch-wise mass matrices", "SimplicialLDLT");
+    opt.addReal("quA", "Number of quadrature points: quA*deg + quB", 1.0);
+    opt.addInt ("quB", "Number of quadrature points: quA*deg + quB", 1);
+    return opt;
+}
+
+template<typename T>
+void gsL2Projector<T>::project(const gsFunctionSet<T> & source,
+                               gsMatrix<T> & coefs) const
+{
+    const index_t np = m_basis.nBases();
+    coefs.resize(m_offsets.back(), source.targetDim());
+#   pragma omp parallel
+    {
+        gsMatrix<T> rhs;
+#       pragma omp for schedule(dynamic)
+        for (index_t p = 0; p < np; ++p)
+        {
+            assemble(p, &source, NULL, &rhs);
+            coefs.middleRows(m_offsets[p], rhs.rows()) = m_solvers[p]->solve(rhs);
+        }
+    }//omp parallel
+}
+
+template<typename T>
+void gsL2Projector<T>::project(const gsFunctionSet<T> & source,
+                               gsMultiPatch<T> & result) const
+{
+    gsMatrix<T> coefs;
+    project(source, coefs);
+    result.clear();
+    for (size_t p = 0; p != m_basis.nBases(); ++p)
+        result.addPatch( m_basis.basis(p).makeGeometry(
+                             coefs.middleRows(m_offsets[p], m_offsets[p + 1] - m_offsets[p])) );
+    result.computeTopology();
+}
+
+template<typename T>
+void gsL2Projector<T>::assemble(index_t p, const gsFunctionSet<T> * source,
+                                gsSparseMatrix<T> * mass, gsMatrix<T> * rhs) const
+{
+    const gsBasis<T> & basis = m_basis.basis(p);
+    const index_t n = basis.size();
+    gsQuadRule<T> quRule = gsQuadrature::get(basis, m_options);
+
+    gsSparseEntries<T> entries;
+    if (mass)
+        entries.reserve(n * math::ipow(2 * basis.maxDegree() + 1, basis.domainDim()));
+    if (rhs)
+        rhs->setZero(n, source->targetDim());
+
+    gsVector<T> quWeights;
+    gsMatrix<T> bVals, fVals;
+    gsMatrix<index_t> actives;
+    gsMapData<T> md(NEED_MEASURE);
+
+    typename gsBasis<T>::domainIter domIt = basis.makeDomainIterator();
+    for (; domIt->good(); domIt->next())
+    {
+        quRule.mapTo(domIt->lowerCorner(), domIt->upperCorner(), md.points, quWeights);
+        m_geometry.patch(p).computeMap(md);
+        for (index_t k = 0; k != quWeights.size(); ++k)
+            quWeights[k] *= md.measure(k);
+
+        basis.eval_into(md.points, bVals);
+        basis.active_into(md.points.col(0), actives);
+
+        if (mass)
+        {
+            const gsMatrix<T> locMass = bVals * quWeights.asDiagonal() * bVals.transpose();
+            for (index_t i = 0; i != actives.rows(); ++i)
+                for (index_t j = 0; j != actives.rows(); ++j)
+                    entries.add(actives(i), actives(j), locMass(i, j));
+        }
+
+        if (rhs)
+        {
+            source->piece(p).eval_into(md.points, fVals);
+            const gsMatrix<T> locRhs = bVals * quWeights.asDiagonal() * fVals.transpose();
+            for (index_t i = 0; i != actives.rows(); ++i)
+                rhs->row(actives(i)) += locRhs.row(i);
+        }
+    }
+
+    if (mass)
+    {
+        mass->resize(n, n);
+        mass->setFrom(entries);
+        mass->makeCompressed();
+    }
+}
+
 } // gismo
@@ -9,4 +9,6 @@ namespace gismo
 
 STRUCT_TEMPLATE_INST gsL2Projection<real_t>;
 
+CLASS_TEMPLATE_INST gsL2Projector<real_t>;
+
 }
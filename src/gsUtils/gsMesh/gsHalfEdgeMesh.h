@@ -782,6 +782,8 @@ private:
 
     std::vector<index_t> m_inverseSorting; ///< vector of indices s. t. m_inverseSorting[internVertexIndex] = vertexIndex
     std::vector<index_t> m_sorting; ///< vector that stores the internVertexIndices s. t. m_sorting[vertexIndex-1] = internVertexIndex
+    std::vector<size_t> m_triangleOffsets; ///< the triangles around vertex i are m_vertexTriangles[m_triangleOffsets[i-1]..m_triangleOffsets[i]-1]
+    std::vector<size_t> m_vertexTriangles; ///< triangle indices sorted by vertex index
     T m_precision;
 
 
@@ -41,17 +41,32 @@ gsHalfEdgeMesh<T>::gsHalfEdgeMesh(const gsMesh<T> &mesh, T precision, bool perio
     //typename std::vector<gsVertex<T> *, std::allocator<gsVertex<T> *> >::iterator
     //last = std::unique(this->m_vertex.begin(), this->m_vertex.end(), equal_ptr());
 
-    m_halfedges.reserve(3*this->m_face.size());
-    for (size_t i = 0; i < this->m_face.size(); i++)
+    const index_t numFaces = this->m_face.size();
+    m_halfedges.resize(3*numFaces);
+#pragma omp parallel for
+    for (index_t i = 0; i < numFaces; i++)
     {
-        m_halfedges.push_back(getInternHalfedge(this->m_face[i], 1));
-        m_halfedges.push_back(getInternHalfedge(this->m_face[i], 2));
-        m_halfedges.push_back(getInternHalfedge(this->m_face[i], 3));
+        m_halfedges[3*i  ] = getInternHalfedge(this->m_face[i], 1);
+        m_halfedges[3*i+1] = getInternHalfedge(this->m_face[i], 2);
+        m_halfedges[3*i+2] = getInternHalfedge(this->m_face[i], 3);
     }
 
     m_boundary = Boundary(m_halfedges);
     m_n = this->m_vertex.size() - m_boundary.getNumberOfVertices();
     sortVertices();
+
+    // Triangles around each vertex, in increasing order
+    m_triangleOffsets.assign(this->m_vertex.size() + 1, 0);
+    for (size_t i = 0; i < this->m_face.size(); i++)
+        for (size_t j = 1; j <= 3; ++j)
+            ++m_triangleOffsets[getGlobalVertexIndex(j, i)];
+    for (size_t k = 1; k < m_triangleOffsets.size(); ++k)
+        m_triangleOffsets[k] += m_triangleOffsets[k-1];
+    m_vertexTriangles.resize(3*this->m_face.size());
+    std::vector<size_t> pos(m_triangleOffsets.begin(), m_triangleOffsets.end() - 1);
+    for (size_t i = 0; i < this->m_face.size(); i++)
+        for (size_t j = 1; j <= 3; ++j)
+            m_vertexTriangles[pos[getGlobalVertexIndex(j, i) - 1]++] = i;
 }
 
 template<class T>
@@ -203,8 +218,9 @@ gsHalfEdgeMesh<T>::getOppositeHalfedges(const size_t vertexIndex, const bool inn
     }
 
     size_t v1, v2, v3;
-    for (size_t i = 0; i < getNumberOfTriangles(); i++)
+    for (size_t k = m_triangleOffsets[vertexIndex - 1]; k < m_triangleOffsets[vertexIndex]; k++)
     {
+        const size_t i = m_vertexTriangles[k];
         switch (isTriangleVertex(vertexIndex, i))
         {
             case 1:
@@ -309,9 +325,14 @@ void gsHalfEdgeMesh<T>::sortVertices()
     m_sorting.resize(this->m_vertex.size(), 0);
     m_inverseSorting.resize(this->m_vertex.size(), 0);
 
+    std::list<size_t> boundaryVertices = m_boundary.getVertexIndices();
+    std::vector<bool> isBoundary(this->m_vertex.size(), false);
+    for (std::list<size_t>::const_iterator it = boundaryVertices.begin(); it != boundaryVertices.end(); ++it)
+        isBoundary[*it] = true;
+
     for (size_t i = 0; i != this->m_vertex.size(); ++i)
     {
-        if (!isBoundaryVertex(i))
+        if (!isBoundary[i])
         {
             numberOfInnerVerticesFound++;
             m_sorting[numberOfInnerVerticesFound - 1] = i;
@@ -319,7 +340,6 @@ void gsHalfEdgeMesh<T>::sortVertices()
         }
     }
 
-    std::list<size_t> boundaryVertices = m_boundary.getVertexIndices();
     for (size_t i = 0; i < getNumberOfBoundaryVertices(); i++)
     {
         m_sorting[m_n + i] = boundaryVertices.front();
@@ -387,64 +407,19 @@ gsHalfEdgeMesh<T>::Boundary::Boundary(const std::vector<typename gsHalfEdgeMesh<
 template<class T>
 const std::list<typename gsHalfEdgeMesh<T>::Halfedge> gsHalfEdgeMesh<T>::Boundary::findNonTwinHalfedges(const std::vector<typename gsHalfEdgeMesh<T>::Halfedge> &allHalfedges)
 {
-    std::queue<Halfedge> queue0;
-    std::queue<Halfedge> queue1;
-    bool actualQueue = 0;
+    // A halfedge has a twin if the reversed pair of vertices is
+    // found among the sorted pairs of all halfedges
+    std::vector<std::pair<size_t, size_t> > pairs(allHalfedges.size());
+    for (size_t i = 0; i < allHalfedges.size(); ++i)
+        pairs[i] = std::make_pair(allHalfedges[i].getOrigin(), allHalfedges[i].getEnd());
+    std::sort(pairs.begin(), pairs.end());
+
     std::list<Halfedge> nonTwinHalfedges;
     for (size_t i = 0; i < allHalfedges.size(); ++i)
     {
-        queue0.push(allHalfedges[i]);
-    }
-    while (!(queue0.empty() && queue1.empty()))
-    {
-        if (actualQueue == 0)
-        {
-            nonTwinHalfedges.push_back(queue0.front());
-            queue0.pop();
-            while (!queue0.empty())
-            {
-                if (nonTwinHalfedges.back().isTwin(queue0.front()))
-                {
-                    queue0.pop();
-                    nonTwinHalfedges.pop_back();
-                    while (!queue0.empty())
-                    {
-                        queue1.push(queue0.front());
-                        queue0.pop();
-                    }
-                }
-                else
-                {
-                    queue1.push(queue0.front());
-                    queue0.pop();
-                }
-            }
-            actualQueue = 1;
-        }
-        else if (actualQueue == 1)
-        {
-            nonTwinHalfedges.push_back(queue1.front());
-            queue1.pop();
-            while (!queue1.empty())
-            {
-                if (nonTwinHalfedges.back().isTwin(queue1.front()))
-                {
-                    queue1.pop();
-                    nonTwinHalfedges.pop_back();
-                    while (!queue1.empty())
-                    {
-                        queue0.push(queue1.front());
-                        queue1.pop();
-                    }
-                }
-                else
-                {
-                    queue0.push(queue1.front());
-                    queue1.pop();
-                }
-            }
-            actualQueue = 0;
-        }
+        if (!std::binary_search(pairs.begin(), pairs.end(),
+                                std::make_pair(allHalfedges[i].getEnd(), allHalfedges[i].getOrigin())))
+            nonTwinHalfedges.push_back(allHalfedges[i]);
     }
     return nonTwinHalfedges;
 }
@@ -119,6 +119,7 @@ void gsQuasiInterpolate<T>::Taylor(const gsBasis<T> &bb, const gsFunction<T> &fu
 
     gsMatrix<T> val;
     std::vector<T> knots;
+#   pragma omp parallel for private(val, knots)
     for(int j=0; j<n; j++)
     {
         val.setZero(1,dim);
@@ -252,6 +253,7 @@ void gsQuasiInterpolate<T>::EvalBased(const gsBasis<T> &bb, const gsFunction<T>
     }
     default: //if none of the special cases, (Theorem 8.7 and Lemma 9.7 of "Spline methods (Lyche Morken)")
         gsMatrix<T> xik, weights;
+#       pragma omp parallel for private(xik, weights)
         for(int i=0; i<n; i++)
         {
             //look for the greatest subinterval to chose the interpolation points from
@@ -403,7 +405,9 @@ void gsQuasiInterpolate<T>::localIntpl(const gsBasis<T> &b,
     index_t dim = fun.targetDim();
     result.resize(n,dim);
 
-    for (index_t i = 0; i!=n; ++i)
+    // Every coefficient is computed independently
+#   pragma omp parallel for schedule(dynamic,16) private(cf)
+    for (index_t i = 0; i<n; ++i)
     {
         cf = localIntpl(b,fun,i);
         result.row(i) = cf;
@@ -421,7 +425,8 @@ void gsQuasiInterpolate<T>::Schoenberg(const gsBasis<T> &b,
     index_t dim = fun.targetDim();
     result.resize(n,dim);
 
-    for (index_t i = 0; i!=n; ++i)
+#   pragma omp parallel for private(cf)
+    for (index_t i = 0; i<n; ++i)
     {
         cf = Schoenberg(b,fun,i);
         result.row(i) = cf;
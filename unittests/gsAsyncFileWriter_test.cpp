@@ -0,0 +1,96 @@
+/** @file gsAsyncFileWriter_test.cpp
+
+    @brief Tests for gsAsyncFileWriter
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include "gismo_unittest.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+
+SUITE(gsAsyncFileWriter_test)
+{
+TEST(fifo_order)
+{
+    gsAsyncFileWriter writer(3);
+    std::vector<int> order; // only touched by the writer thread
+    for (int i = 0; i != 100; ++i)
+        writer.push([&order, i]() { order.push_back(i); });
+    writer.wait();
+
+    CHECK_EQUAL(100u, order.size());
+    for (int i = 0; i != 100; ++i)
+        CHECK_EQUAL(i, order[i]);
+}
+
+TEST(full_queue_blocks)
+{
+    gsAsyncFileWriter writer(2);
+    std::promise<void> started, release;
+    std::shared_future<void> gate = release.get_future().share();
+
+    // The first job occupies the writer thread until released
+    writer.push([&started, gate]() { started.set_value(); gate.wait(); });
+    started.get_future().wait();
+
+    // Fill the queue
+    writer.push([]() {});
+    writer.push([]() {});
+
+    std::atomic<bool> pushed(false);
+    std::thread producer([&writer, &pushed]()
+                         {
+                             writer.push([]() {});
+                             pushed = true;
+                         });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(!pushed);
+
+    release.set_value();
+    producer.join();
+    CHECK(pushed);
+    writer.wait();
+}
+
+TEST(exception_in_job)
+{
+    gsAsyncFileWriter writer;
+    bool before(false), after(false);
+    writer.push([&before]() { before = true; });
+    writer.push([]() { throw std::runtime_error("cannot write"); });
+    CHECK_THROW(writer.wait(), std::runtime_error);
+    CHECK(before);
+
+    // The error is reported once, and the writer is still usable
+    writer.push([&after]() { after = true; });
+    writer.wait();
+    CHECK(after);
+}
+
+TEST(destructor_completes_jobs)
+{
+    std::atomic<int> count(0);
+    {
+        gsAsyncFileWriter writer(2);
+        for (int i = 0; i != 10; ++i)
+            writer.push([&count]()
+                        {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                            ++count;
+                        });
+    }
+    CHECK_EQUAL(10, count.load());
+}
+
+}
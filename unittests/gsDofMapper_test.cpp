@@ -0,0 +1,130 @@
+/** @file gsDofMapper_test.cpp
+
+    @brief Tests for the reordering of the dofs in gsDofMapper
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include "gismo_unittest.h"
+
+namespace
+{
+index_t bandwidth(const gsSparseMatrix<real_t> & A)
+{
+    index_t bw = 0;
+    for (index_t k = 0; k != A.outerSize(); ++k)
+        for (gsSparseMatrix<real_t>::InnerIterator it(A, k); it; ++it)
+            bw = math::max(bw, math::abs(it.row() - it.col()));
+    return bw;
+}
+
+bool isPermutation(const gsVector<index_t> & perm)
+{
+    std::vector<index_t> p(perm.data(), perm.data() + perm.size());
+    std::sort(p.begin(), p.end());
+    for (size_t i = 0; i != p.size(); ++i)
+        if (p[i] != static_cast<index_t>(i)) return false;
+    return true;
+}
+}
+
+SUITE(gsDofMapper_test)
+{
+    TEST(computeOrdering)
+    {
+        // N x N bilinear elements, the nodes numbered column by column
+        // in the lower half and row by row in the upper half
+        const index_t N = 20, n = (N + 1) * (N + 1);
+        std::vector<index_t> num(n), elPtr(1, 0), elInd;
+        index_t c = 0;
+        for (index_t i = 0; i <= N; ++i)
+            for (index_t j = 0; j <= N / 2; ++j)
+                num[j * (N + 1) + i] = c++;
+        for (index_t j = N / 2 + 1; j <= N; ++j)
+            for (index_t i = 0; i <= N; ++i)
+                num[j * (N + 1) + i] = c++;
+        for (index_t j = 0; j != N; ++j)
+            for (index_t i = 0; i != N; ++i)
+            {
+                const index_t v = j * (N + 1) + i;
+                elInd.push_back(num[v]);
+                elInd.push_back(num[v + 1]);
+                elInd.push_back(num[v + N + 1]);
+                elInd.push_back(num[v + N + 2]);
+                elPtr.push_back(elInd.size());
+            }
+
+        const dofOrdering::type ords[] = {dofOrdering::natural, dofOrdering::rcm,
+                                          dofOrdering::nestedDissection, dofOrdering::element};
+        for (index_t o = 0; o != 4; ++o)
+        {
+            const gsVector<index_t> perm =
+                gsDofMapper::computeOrdering(ords[o], n + 1, elPtr, elInd);
+            CHECK( isPermutation(perm) );
+            CHECK_EQUAL( n, perm[n] ); // isolated dof
+        }
+
+        // Bandwidth of the mesh graph
+        index_t bwNat = 0, bwRcm = 0;
+        const gsVector<index_t> perm = gsDofMapper::computeOrdering(dofOrdering::rcm, n, elPtr, elInd);
+        for (size_t e = 0; e + 1 < elPtr.size(); ++e)
+            for (index_t i = elPtr[e]; i != elPtr[e+1]; ++i)
+                for (index_t j = elPtr[e]; j != elPtr[e+1]; ++j)
+                {
+                    bwNat = math::max(bwNat, math::abs(elInd[i] - elInd[j]));
+                    bwRcm = math::max(bwRcm, math::abs(perm[elInd[i]] - perm[elInd[j]]));
+                }
+        CHECK( bwRcm < bwNat );
+    }
+
+    TEST(reorderPoisson)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+        gsMultiBasis<> mb(mp);
+        mb.degreeElevate();
+        mb.uniformRefine();
+        mb.uniformRefine();
+
+        gsFunctionExpr<> f("2*pi^2*sin(pi*x)*sin(pi*y)", 2);
+        gsFunctionExpr<> g("sin(pi*x)*sin(pi*y)", 2);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator it = mp.bBegin(); it != mp.bEnd(); ++it)
+            bc.addCondition(*it, condition_type::dirichlet, &g);
+
+        gsSparseSolver<>::SimplicialLDLT solver;
+        gsMatrix<> pts = gsMatrix<>::Random(2, 10).array() * 0.5 + 0.5;
+        gsMatrix<> ref;
+        index_t bwNat = 0;
+        for (index_t o = 0; o != 4; ++o)
+        {
+            gsPoissonAssembler<real_t> poisson(mp, mb, bc, f);
+            poisson.options().setInt("DofOrdering", o);
+            poisson.refresh();
+            poisson.assemble();
+
+            const gsSparseMatrix<> & A = poisson.matrix();
+            const gsMatrix<> x = solver.compute(A).solve(poisson.rhs());
+            gsMultiPatch<> sol;
+            poisson.constructSolution(x, sol);
+            const gsMatrix<> val = sol.patch(3).eval(pts);
+
+            if (0 == o)
+            {
+                ref = val;
+                bwNat = bandwidth(A);
+            }
+            else
+            {
+                CHECK( (val - ref).norm() < 1e-10 );
+                if (dofOrdering::rcm == o)
+                    CHECK( bandwidth(A) < bwNat );
+            }
+        }
+    }
+}
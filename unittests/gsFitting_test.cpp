@@ -0,0 +1,142 @@
+/** @file gsFitting_test.cpp
+
+    @brief Tests least squares fitting with gsFitting
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+ **/
+
+#include "gismo_unittest.h"
+
+SUITE(gsFitting_test)
+{
+    // Samples a smooth surface at random parameters
+    void samplePoints(index_t n, gsMatrix<> & uv, gsMatrix<> & xyz)
+    {
+        uv.setRandom(2, n);
+        uv.array() = (uv.array() + 1) / 2;
+        xyz.resize(3, n);
+        xyz.row(0) = uv.row(0);
+        xyz.row(1) = uv.row(1);
+        xyz.row(2) = (uv.row(0).array() * 3).sin() * uv.row(1).array();
+    }
+
+    TEST(streamed)
+    {
+        gsKnotVector<> kv(0, 1, 4, 3);
+        gsTensorBSplineBasis<2> basis(kv, kv);
+        gsMatrix<> uv, xyz;
+        samplePoints(2000, uv, xyz);
+
+        gsFitting<> fit(uv, xyz, basis);
+        fit.compute(1e-6);
+
+        // The same points, in chunks and through a file
+        gsFitting<> sfit(basis);
+        sfit.streamPoints(uv.leftCols(700), xyz.leftCols(700));
+        const std::string fn = gsFileManager::getTempPath() + "fitting_stream.csv";
+        gsMatrix<> rows(uv.cols() - 700, 5);
+        rows.leftCols(2)  = uv.rightCols(rows.rows()).transpose();
+        rows.rightCols(3) = xyz.rightCols(rows.rows()).transpose();
+        gsWriteCsv(fn, rows);
+        sfit.streamCsv(fn, 500);
+        std::remove(fn.c_str());
+        CHECK_EQUAL(2000, sfit.numStreamedPoints());
+
+        sfit.computeStreamed(1e-6);
+        CHECK( (fit.result()->coefs() - sfit.result()->coefs()).norm() < 1e-6 );
+    }
+
+    TEST(gridded)
+    {
+        gsKnotVector<> ku(0, 1, 5, 4), kv(0, 1, 3, 3);
+        gsTensorBSplineBasis<2> basis(ku, kv);
+        gsVector<> a(2), b(2);
+        a << 0, 0; b << 1, 1;
+        gsVector<unsigned> np(2);
+        np << 23, 17;
+        gsMatrix<> uv = gsPointGrid<>(a, b, np), xyz;
+        xyz.resize(3, uv.cols());
+        xyz.topRows(2) = uv;
+        xyz.row(2) = (uv.row(0).array() * 3).sin() * uv.row(1).array();
+
+        // Kronecker solver, detected from the parameters
+        gsFitting<> fit(uv, xyz, basis);
+        fit.compute();
+
+        // Kronecker solver, with the grid given explicitly
+        std::vector<gsVector<> > grid(2);
+        grid[0] = gsVector<>::LinSpaced(23, 0, 1);
+        grid[1] = gsVector<>::LinSpaced(17, 0, 1);
+        gsFitting<> gfit(basis);
+        gfit.computeGridded(grid, xyz);
+        CHECK( (fit.result()->coefs() - gfit.result()->coefs()).norm() < 1e-10 );
+
+        // The full system, shuffled points are not a grid
+        std::swap_ranges(uv.col(3).data(), uv.col(3).data() + 2, uv.col(40).data());
+        std::swap_ranges(xyz.col(3).data(), xyz.col(3).data() + 3, xyz.col(40).data());
+        gsFitting<> afit(uv, xyz, basis);
+        afit.compute();
+        CHECK( (fit.result()->coefs() - afit.result()->coefs()).norm() < 1e-6 );
+    }
+
+    TEST(solvers)
+    {
+        gsKnotVector<> kv(0, 1, 4, 3);
+        gsTensorBSplineBasis<2> basis(kv, kv);
+        gsMatrix<> uv, xyz;
+        samplePoints(1500, uv, xyz);
+
+        gsFitting<> fit(uv, xyz, basis);
+        fit.options().setString("Solver", "BiCGSTABILUT");
+        fit.compute(1e-6);
+        const gsMatrix<> coefs = fit.result()->coefs();
+
+        const char * slv[] = {"SimplicialLDLT", "SimplicialLLT",
+                              "CGDiagonal", "CGIncompleteCholesky"};
+        for (int i = 0; i != 4; ++i)
+        {
+            fit.options().setString("Solver", slv[i]);
+            fit.compute(1e-6);
+            CHECK( (coefs - fit.result()->coefs()).norm() < 1e-6 );
+        }
+    }
+
+    TEST(parameterCorrection)
+    {
+        gsKnotVector<> kv(0, 1, 4, 3);
+        gsTensorBSplineBasis<2> basis(kv, kv);
+        gsMatrix<> uv, xyz;
+        samplePoints(1000, uv, xyz);
+
+        // Perturbed parameters
+        gsMatrix<> uv0 = uv;
+        uv0.array() = 0.9 * uv0.array() + 0.05;
+
+        gsFitting<> fit(uv0, xyz, basis);
+        fit.compute();
+        const gsMatrix<> coefs = fit.result()->coefs();
+        real_t err0, err1;
+        fit.computeApproxError(err0, 0);
+
+        // Repeated assembly reuses the sparsity pattern
+        fit.compute();
+        CHECK( (coefs - fit.result()->coefs()).norm() == 0 );
+
+        // The sum of squared errors does not increase
+        fit.parameterCorrection(1e-8, 3);
+        fit.computeApproxError(err1, 0);
+        CHECK( err1 <= err0 );
+
+        std::vector<real_t> errors;
+        fit.get_Error(errors, 0);
+        CHECK_EQUAL(1000u, errors.size());
+        fit.computeMaxNormErrors();
+        CHECK( fit.maxPointError() >= fit.minPointError() );
+    }
+}
@@ -352,4 +352,63 @@ SUITE(gsIterativeSolvers_test)
         CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
     }
 
+    TEST(PipelinedCG_Jacobi_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x, y;
+
+        poissonDiscretization(mat, rhs, N);
+
+        gsOptionList opt = gsPipelinedCG<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+        opt.setInt ("ReplacementPeriod", 20);
+
+        gsLinearOperator<>::Ptr preConMat = makeJacobiOp(mat);
+        gsPipelinedCG<> solver(mat,preConMat);
+        solver.setOptions(opt);
+
+        x.setZero(N,1);
+        solver.solve(rhs,x);
+
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+
+        // same iterates as the standard method
+        gsConjugateGradient<> cg(mat,preConMat);
+        cg.setOptions(opt);
+        y.setZero(N,1);
+        cg.solve(rhs,y);
+        CHECK( math::abs(cg.iterations() - solver.iterations()) <= 1 );
+    }
+
+    TEST(SStepGMRes_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        gsOptionList opt = gsSStepGMRes<>::defaultOptions();
+        opt.setInt ("MaxIterations", 10*N);
+        opt.setReal("Tolerance"    , tol );
+        opt.setInt ("Steps"        , 6   );
+
+        gsLinearOperator<>::Ptr precon = makeSymmetricGaussSeidelOp(mat);
+        gsSStepGMRes<> solver(mat,precon);
+        solver.setOptions(opt);
+
+        x.setZero(N,1);
+        solver.solve(rhs, x);
+
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+    }
+
 }
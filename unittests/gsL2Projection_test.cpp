@@ -82,4 +82,37 @@ SUITE(gsL2Projection_test)
         CHECK_CLOSE(error,0.0,1e-10);
     }
 
+    TEST(projector)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+        mp.degreeElevate(2);
+        mp.uniformRefine();
+        gsMultiBasis<> mb(mp);
+
+        // The mass matrices are factorized once
+        gsL2Projector<real_t> proj(mb, mp);
+
+        // The geometry is reproduced
+        gsMatrix<> coefs;
+        proj.project(mp, coefs);
+        CHECK( (coefs - mp.coefs()).norm() < 1e-10 );
+
+        // Several fields on the same basis
+        gsFunctionExpr<> f("x^2*y", "y^3 - x", 2), g("x*y", 2);
+        gsMultiPatch<> pf, pg;
+        proj.project(f, pf);
+        proj.project(g, pg);
+        CHECK_EQUAL(2, pf.targetDim());
+        CHECK_EQUAL(1, pg.targetDim());
+
+        gsMatrix<> u(2, 10);
+        u.setRandom();
+        u.array() = (u.array() + 1) / 2;
+        for (size_t p = 0; p != mp.nPatches(); ++p)
+        {
+            CHECK( (pf.patch(p).eval(u) - f.eval(u)).norm() < 1e-10 );
+            CHECK( (pg.patch(p).eval(u) - g.eval(u)).norm() < 1e-10 );
+        }
+    }
+
 }
@@ -0,0 +1,104 @@
+/** @file gsMultiPatch_test.cpp
+
+    @brief Tests the batched evaluation of gsMultiPatch
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+ **/
+
+#include "gismo_unittest.h"
+
+SUITE(gsMultiPatch_test)
+{
+    TEST(evalBatch)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(3, 2, 1.0);
+        mp.degreeElevate();
+        mp.uniformRefine();
+        for (size_t p = 0; p != mp.nPatches(); ++p)
+            mp.patch(p).coefs().array() += 0.1 * math::sin(real_t(p));
+
+        const index_t n = 1000;
+        gsVector<index_t> pids(n);
+        gsMatrix<> u(2, n);
+        u.setRandom();
+        u.array() = (u.array() + 1) / 2;
+        for (index_t k = 0; k != n; ++k)
+            pids[k] = (7 * k) % mp.nPatches();
+
+        gsMatrix<> ev, pv;
+        for (int deriv = 0; deriv != 3; ++deriv)
+        {
+            // small chunks to have several work items per patch
+            mp.evalBatch_into(pids, u, ev, deriv, 64);
+            CHECK_EQUAL(n, ev.cols());
+            for (index_t k = 0; k != n; ++k)
+            {
+                switch (deriv)
+                {
+                case 0 : mp.patch(pids[k]).eval_into  (u.col(k), pv); break;
+                case 1 : mp.patch(pids[k]).deriv_into (u.col(k), pv); break;
+                default: mp.patch(pids[k]).deriv2_into(u.col(k), pv); break;
+                }
+                CHECK( (ev.col(k) - pv).norm() < 1e-12 );
+            }
+        }
+    }
+
+    TEST(evalGrid)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+        mp.degreeElevate();
+        mp.uniformRefine(2);
+        mp.patch(3).coefs().array() += 0.05;
+        mp.addPatch( *gsNurbsCreator<>::NurbsQuarterAnnulus() ); // rational
+        gsVector<unsigned> npts(2);
+        npts << 5, 4;
+        std::vector<gsMatrix<> > vals, pars;
+        for (int deriv = 0; deriv != 3; ++deriv)
+        {
+            mp.evalGrid_into(npts, vals, deriv, &pars);
+            CHECK_EQUAL(5u, vals.size());
+            for (size_t p = 0; p != mp.nPatches(); ++p)
+            {
+                CHECK_EQUAL(20, vals[p].cols());
+                const gsMatrix<> ev = 0 == deriv ? mp.patch(p).eval(pars[p]) :
+                    1 == deriv ? mp.patch(p).deriv(pars[p]) : mp.patch(p).deriv2(pars[p]);
+                CHECK( (vals[p] - ev).norm() < 1e-12 );
+            }
+        }
+    }
+
+    TEST(tensorGrid)
+    {
+        gsKnotVector<> k0(0, 1, 3, 3), k1(0, 2, 1, 4), k2(-1, 1, 4, 2);
+        gsTensorBSplineBasis<3> basis(k0, k1, k2);
+        gsMatrix<> coefs(basis.size(), 2);
+        coefs.setRandom();
+
+        std::vector<gsMatrix<> > grid(3);
+        grid[0] = gsVector<>::LinSpaced(7, 0, 1).transpose();
+        grid[1] = gsVector<>::LinSpaced(4, 0, 2).transpose();
+        grid[2] = gsVector<>::LinSpaced(6, -1, 1).transpose();
+        gsVector<> a(3), b(3);
+        a << 0, 0, -1; b << 1, 2, 1;
+        gsVector<unsigned> np(3);
+        np << 7, 4, 6;
+        const gsMatrix<> pts = gsPointGrid<>(a, b, np);
+
+        gsMatrix<> gv, ev;
+        basis.evalGrid_into(grid, coefs, gv);
+        basis.eval_into(pts, coefs, ev);
+        CHECK( (gv - ev).norm() < 1e-12 );
+
+        gsTensorBSpline<3> geo(basis, coefs);
+        basis.evalGrid_into(grid, coefs, gv, 1);
+        geo.deriv_into(pts, ev);
+        CHECK( (gv - ev).norm() < 1e-12 );
+    }
+}
@@ -0,0 +1,90 @@
+/** @file gsNewtonIterator_test.cpp
+
+    @brief Tests the linear solver strategies of gsNewtonIterator
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+ **/
+
+#include "gismo_unittest.h"
+#include <gsPde/gsNewtonIterator.h>
+
+SUITE(gsNewtonIterator_test)
+{
+    // Discrete problem K c + c^3 = b, with K and b from the Poisson
+    // problem with homogeneous Dirichlet conditions
+    class CubicAssembler : public gsPoissonAssembler<real_t>
+    {
+    public:
+        CubicAssembler(const gsMultiPatch<> & mp, const gsMultiBasis<> & mb,
+                       const gsBoundaryConditions<> & bc, const gsFunction<> & f)
+        : gsPoissonAssembler<real_t>(mp, mb, bc, f) { }
+
+        // Re-assembly adds to the matrix, hence it is cleared first
+        void assemble()
+        {
+            m_system.setZero();
+            gsPoissonAssembler<real_t>::assemble();
+        }
+
+        void assemble(const gsMultiPatch<> & cur)
+        {
+            assemble();
+            const gsDofMapper & mapper = m_system.colMapper(0);
+            gsVector<> c(mapper.freeSize());
+            for (index_t i = 0; i != cur.patch(0).coefsSize(); ++i)
+                if (mapper.is_free(i, 0))
+                    c[mapper.index(i, 0)] = cur.patch(0).coef(i, 0);
+
+            m_system.rhs() -= m_system.matrix() * c;
+            m_system.rhs().array() -= c.array().cube();
+            for (index_t k = 0; k != c.size(); ++k)
+                m_system.matrix().coeffRef(k, k) += 3 * c[k] * c[k];
+        }
+    };
+
+    TEST(methods)
+    {
+        gsMultiPatch<> mp(*gsNurbsCreator<>::BSplineSquare(1.0));
+        gsMultiBasis<> mb(mp);
+        mb.degreeElevate();
+        mb.uniformRefine(3);
+
+        gsConstantFunction<> zero(0.0, 2);
+        gsFunctionExpr<> f("2000*sin(pi*x)*sin(pi*y)", 2);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator it = mp.bBegin(); it != mp.bEnd(); ++it)
+            bc.addCondition(*it, condition_type::dirichlet, &zero);
+
+        gsMatrix<> ref;
+        index_t nf = 0;
+        for (index_t m = 0; m != 3; ++m)
+        {
+            CubicAssembler assembler(mp, mb, bc, f);
+            gsNewtonIterator<real_t> newton(assembler);
+            newton.options().setInt("Method", m);
+            newton.setTolerance(1e-10);
+            newton.solve();
+            CHECK( newton.converged() );
+
+            if (0 == m)
+            {
+                ref = newton.solution().patch(0).coefs();
+                nf = newton.numFactorizations();
+                CHECK_EQUAL(newton.numIterations() + 1, nf);
+            }
+            else
+            {
+                CHECK( (newton.solution().patch(0).coefs() - ref).norm() < 1e-6 * ref.norm() );
+                CHECK( newton.numFactorizations() < nf );
+            }
+            if (2 == m)
+                CHECK( newton.numKrylovIterations() > 0 );
+        }
+    }
+}
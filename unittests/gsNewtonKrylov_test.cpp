@@ -0,0 +1,136 @@
+/** @file gsNewtonKrylov_test.cpp
+
+    @brief Tests the trust-region Newton-Krylov optimizer and the
+    finite difference Hessians of gsOptProblem
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+ **/
+
+#include "gismo_unittest.h"
+#include <gsOptimizer/gsNewtonKrylov.h>
+
+SUITE(gsNewtonKrylov_test)
+{
+    // Convex chain: sum exp(u_i) - 2 u_i + 5 (u_i - u_{i+1})^2
+    class ConvexChain : public gsOptProblem<real_t>
+    {
+    public:
+        explicit ConvexChain(bool sparse) : m_sparse(sparse) { }
+
+        real_t evalObj(const gsAsConstVector<real_t> & u) const
+        {
+            real_t f = 0;
+            for (index_t i = 0; i != u.size(); ++i)
+            {
+                f += math::exp(u[i]) - 2 * u[i];
+                if (i + 1 != u.size())
+                    f += 5 * math::pow(u[i] - u[i+1], 2);
+            }
+            return f;
+        }
+
+        void gradObj_into(const gsAsConstVector<real_t> & u, gsAsVector<real_t> & g) const
+        {
+            for (index_t i = 0; i != u.size(); ++i)
+                g[i] = math::exp(u[i]) - 2;
+            for (index_t i = 0; i + 1 < u.size(); ++i)
+            {
+                g[i]   += 10 * (u[i] - u[i+1]);
+                g[i+1] -= 10 * (u[i] - u[i+1]);
+            }
+        }
+
+        bool hessObj_into(const gsAsConstVector<real_t> & u, gsSparseMatrix<real_t> & H) const
+        {
+            if (!m_sparse) return false;
+            const index_t n = u.size();
+            gsSparseMatrix<real_t> pattern(n, n);
+            for (index_t i = 0; i != n; ++i)
+            {
+                pattern.insert(i, i) = 1;
+                if (i + 1 != n)
+                {
+                    pattern.insert(i, i+1) = 1;
+                    pattern.insert(i+1, i) = 1;
+                }
+            }
+            this->hessObjFD_into(u, pattern, H);
+            return true;
+        }
+
+    private:
+        bool m_sparse;
+    };
+
+    class Rosenbrock : public gsOptProblem<real_t>
+    {
+    public:
+        real_t evalObj(const gsAsConstVector<real_t> & u) const
+        { return 100 * math::pow(u[1] - u[0] * u[0], 2) + math::pow(1 - u[0], 2); }
+
+        void gradObj_into(const gsAsConstVector<real_t> & u, gsAsVector<real_t> & g) const
+        {
+            const real_t t = u[1] - u[0] * u[0];
+            g[0] = -400 * t * u[0] - 2 * (1 - u[0]);
+            g[1] = 200 * t;
+        }
+    };
+
+    TEST(fdHessian)
+    {
+        ConvexChain problem(true);
+        gsVector<> u;
+        u.setRandom(50);
+        gsSparseMatrix<> H;
+        problem.hessObj_into(gsAsConstVector<>(u.data(), u.size()), H);
+        for (index_t i = 0; i != u.size(); ++i)
+        {
+            CHECK_CLOSE(math::exp(u[i]) + (0 == i || u.size() - 1 == i ? 10 : 20),
+                        H.coeff(i, i), 1e-5);
+            if (i + 1 != u.size())
+                CHECK_CLOSE(-10, H.coeff(i, i+1), 1e-5);
+        }
+
+        // Hessian-vector products agree with the matrix
+        gsVector<> v, Hv;
+        v.setRandom(u.size());
+        problem.hessVecObj_into(gsAsConstVector<>(u.data(), u.size()), v, Hv);
+        CHECK( (Hv - H * v).norm() < 1e-5 * v.norm() );
+    }
+
+    TEST(convex)
+    {
+        const index_t n = 1000;
+        for (int sparse = 0; sparse != 2; ++sparse)
+        {
+            ConvexChain problem(sparse);
+            gsNewtonKrylov<> optimizer(&problem);
+            gsMatrix<> x0;
+            x0.setRandom(n, 1);
+            optimizer.solve(x0);
+            CHECK( optimizer.iterations() < 100 );
+
+            gsVector<> g(n);
+            gsAsVector<> ag(g.data(), n);
+            problem.gradObj_into(gsAsConstVector<>(optimizer.currentDesign().data(), n), ag);
+            CHECK( g.norm() < 1e-6 );
+        }
+    }
+
+    TEST(rosenbrock)
+    {
+        Rosenbrock problem;
+        gsNewtonKrylov<> optimizer(&problem);
+        gsMatrix<> x0(2, 1);
+        x0 << -1.2, 1;
+        optimizer.solve(x0);
+        CHECK_CLOSE(1, optimizer.currentDesign()(0, 0), 1e-6);
+        CHECK_CLOSE(1, optimizer.currentDesign()(1, 0), 1e-6);
+    }
+}
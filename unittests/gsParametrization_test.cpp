@@ -59,6 +59,36 @@ SUITE(gsParametrization_test)
         CHECK_CLOSE(0, xyz(2, 4), eps);
     }
 
+    TEST(iterativeSolver)
+    {
+        // Triangulated curved grid
+        const int m = 30;
+        gsMesh<real_t> mesh;
+        std::vector<gsMesh<real_t>::VertexHandle> v;
+        for (int j = 0; j <= m; ++j)
+            for (int i = 0; i <= m; ++i)
+            {
+                const real_t x = (real_t)i / m, y = (real_t)j / m;
+                v.push_back(mesh.addVertex(x, y, math::sin(3 * x) * y / 3));
+            }
+        for (int j = 0; j < m; ++j)
+            for (int i = 0; i < m; ++i)
+            {
+                const int a = j * (m + 1) + i;
+                mesh.addFace(v[a], v[a + 1], v[a + m + 2]);
+                mesh.addFace(v[a], v[a + m + 2], v[a + m + 1]);
+            }
+
+        gsParametrization<real_t> param(mesh);
+        param.compute();
+        const gsMatrix<real_t> uv = param.createUVmatrix();
+
+        param.options().setString("solver", "BiCGSTABILUT");
+        gsParametrization<real_t> iparam(mesh, param.options());
+        iparam.compute();
+        CHECK( (uv - iparam.createUVmatrix()).norm() < 1e-6 );
+    }
+
     struct inputs
     {
         gsMatrix<real_t> verticesV0, paramsV0, verticesV1, paramsV1;
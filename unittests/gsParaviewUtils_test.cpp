@@ -0,0 +1,207 @@
+/** @file gsParaviewUtils_test.cpp
+
+    @brief Tests for the appended binary output of gsParaviewUtils
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include "gismo_unittest.h"
+
+namespace
+{
+const uint64_t zBlockSize = 32768;
+
+uint64_t readUInt64(const std::string & s, size_t pos)
+{
+    uint64_t v;
+    std::memcpy(&v, s.data() + pos, sizeof(uint64_t));
+    return v;
+}
+
+// Checks the uncompressed block at \a pos of \a s against \a data,
+// returns the size of the block
+uint64_t checkRawBlock(const std::string & s, size_t pos,
+                       const char * data, uint64_t nbytes)
+{
+    CHECK_EQUAL(nbytes, readUInt64(s, pos));
+    CHECK(0 == std::memcmp(s.data() + pos + sizeof(uint64_t), data, nbytes));
+    return sizeof(uint64_t) + nbytes;
+}
+
+// Checks the vtkZLibDataCompressor block at \a pos of \a s against
+// \a data, returns the size of the block
+uint64_t checkZlibBlock(const std::string & s, size_t pos,
+                        const char * data, uint64_t nbytes)
+{
+    const uint64_t nBlocks = readUInt64(s, pos);
+    CHECK_EQUAL((nbytes + zBlockSize - 1) / zBlockSize, nBlocks);
+    CHECK_EQUAL(zBlockSize, readUInt64(s, pos + 8));
+    CHECK_EQUAL(nbytes % zBlockSize, readUInt64(s, pos + 16));
+
+    uint64_t at = pos + (3 + nBlocks) * sizeof(uint64_t);
+    std::vector<char> buf(zBlockSize);
+    for (uint64_t b = 0; b != nBlocks; ++b)
+    {
+        const uint64_t csize = readUInt64(s, pos + (3 + b) * sizeof(uint64_t));
+        const uint64_t len = std::min(zBlockSize, nbytes - b * zBlockSize);
+        internal::zUncompress(s.data() + at, csize, buf.data(), len);
+        CHECK(0 == std::memcmp(buf.data(), data + b * zBlockSize, len));
+        at += csize;
+    }
+    return at - pos;
+}
+
+// Returns the values of the offset="..." attributes in \a xml
+std::vector<uint64_t> readOffsets(const std::string & xml)
+{
+    std::vector<uint64_t> result;
+    const std::string key("offset=\"");
+    for (size_t p = xml.find(key); p != std::string::npos; p = xml.find(key, p + 1))
+        result.push_back(std::stoull(xml.substr(p + key.size())));
+    return result;
+}
+
+void checkBinaryBlock(bool compress)
+{
+    // Sizes: empty, partial block, exact multiple of the block size
+    const uint64_t sizes[] = {0, 100, 2 * zBlockSize, zBlockSize + 8};
+    for (uint64_t nbytes : sizes)
+    {
+        std::string data(nbytes, '\0');
+        for (uint64_t i = 0; i != nbytes; ++i)
+            data[i] = static_cast<char>( (i * 7) % 13 );
+
+        std::ostringstream out(std::ios_base::out | std::ios_base::binary);
+        const uint64_t written = writeVtkBinaryBlock(out, data.data(), nbytes, compress);
+        const std::string s = out.str();
+        CHECK_EQUAL(s.size(), written);
+        CHECK_EQUAL(written, compress ? checkZlibBlock(s, 0, data.data(), nbytes)
+                                      : checkRawBlock (s, 0, data.data(), nbytes));
+    }
+}
+
+void checkAppendedFile(bool compress)
+{
+    gsMultiPatch<> mp;
+    mp.addPatch(gsNurbsCreator<>::BSplineSquare(1.0, 0.0, 0.0));
+    mp.addPatch(gsNurbsCreator<>::BSplineSquare(1.0, 1.0, 0.0));
+    gsFunctionExpr<> f("x*y", 2);
+    gsField<> field(mp, f, false);
+
+    const std::string base = gsFileManager::getTempPath() + "paraview_appended";
+    gsOptionList opt = gsParaviewDataSet::defaultOptions();
+    opt.setInt("numPoints", 100);
+    opt.setSwitch("appended", true);
+    opt.setSwitch("compress", compress);
+    gsParaviewDataSet ds(base, &mp, nullptr, opt);
+    ds.addField(field, "f");
+    ds.save();
+
+    for (size_t k = 0; k != mp.nPatches(); ++k)
+    {
+        const std::string fn = ds.filenames()[k];
+        std::ifstream file(fn.c_str(), std::ios_base::in | std::ios_base::binary);
+        const std::string s( (std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>() );
+        file.close();
+        std::remove(fn.c_str());
+
+        CHECK( (s.find("vtkZLibDataCompressor") != std::string::npos) == compress );
+        CHECK( std::string::npos != s.find("header_type=\"UInt64\"") );
+
+        const std::string tag("<AppendedData encoding=\"raw\">\n_");
+        const size_t head = s.find(tag);
+        CHECK(std::string::npos != head);
+        const size_t start = head + tag.size();
+        const size_t end   = s.rfind("\n</AppendedData>");
+        CHECK(std::string::npos != end);
+
+        // The field comes first, then the points
+        gsMatrix<> values, points;
+        sampleOnGrid(field, k, 100, values);
+        sampleOnGrid(mp, k, 100, points);
+        points.conservativeResizeLike(gsMatrix<>::Zero(3, points.cols()));
+
+        const std::vector<uint64_t> offsets = readOffsets(s.substr(0, head));
+        CHECK_EQUAL(2u, offsets.size());
+        CHECK_EQUAL(0u, offsets[0]);
+
+        const gsMatrix<> * arrays[] = {&values, &points};
+        uint64_t offset = 0;
+        for (size_t i = 0; i != 2; ++i)
+        {
+            CHECK_EQUAL(offset, offsets[i]);
+            const char * data = reinterpret_cast<const char*>(arrays[i]->data());
+            const uint64_t nbytes = arrays[i]->size() * sizeof(real_t);
+            offset += compress ? checkZlibBlock(s, start + offset, data, nbytes)
+                               : checkRawBlock (s, start + offset, data, nbytes);
+        }
+        CHECK_EQUAL(end, start + offset);
+    }
+}
+}
+
+SUITE(gsParaviewUtils_test)
+{
+TEST(writeVtkBinaryBlock_raw)
+{
+    checkBinaryBlock(false);
+}
+
+TEST(writeVtkBinaryBlock_zlib)
+{
+    checkBinaryBlock(true);
+}
+
+TEST(toAppendedDataArray_offsets)
+{
+    gsMatrix<real_t> a(3, 4);
+    a.setRandom();
+    gsMatrix<index_t> b(1, 5);
+    b << 1, 2, 3, 4, 5;
+
+    std::ostringstream raw(std::ios_base::out | std::ios_base::binary);
+    uint64_t offset = 0;
+    std::string xml = toAppendedDataArray(a, raw, offset);
+    CHECK_EQUAL(sizeof(uint64_t) + a.size() * sizeof(real_t), offset);
+    xml += toAppendedDataArray(b, raw, offset);
+    CHECK_EQUAL(raw.str().size(), offset);
+    CHECK( std::string::npos != xml.find("NumberOfComponents=\"3\"") );
+
+    const std::vector<uint64_t> offsets = readOffsets(xml);
+    CHECK_EQUAL(2u, offsets.size());
+    CHECK_EQUAL(0u, offsets[0]);
+    CHECK_EQUAL(sizeof(uint64_t) + a.size() * sizeof(real_t), offsets[1]);
+    const std::string s = raw.str();
+    checkRawBlock(s, offsets[1], reinterpret_cast<const char*>(b.data()),
+                  b.size() * sizeof(index_t));
+
+    // The section copied from the scratch file
+    const std::string rawFn = gsFileManager::getTempPath() + "paraview_appended.raw";
+    {
+        std::ofstream f(rawFn.c_str(), std::ios_base::out | std::ios_base::binary);
+        f.write(s.data(), s.size());
+    }
+    std::ostringstream out(std::ios_base::out | std::ios_base::binary);
+    writeAppendedData(out, rawFn);
+    std::remove(rawFn.c_str());
+    CHECK_EQUAL("<AppendedData encoding=\"raw\">\n_" + s + "\n</AppendedData>\n", out.str());
+}
+
+TEST(appended_file)
+{
+    checkAppendedFile(false);
+}
+
+TEST(appended_file_zlib)
+{
+    checkAppendedFile(true);
+}
+
+}
@@ -0,0 +1,84 @@
+/** @file gsPointLocator_test.cpp
+
+    @brief Tests closest points and point inversion with gsPointLocator
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+ **/
+
+#include "gismo_unittest.h"
+
+SUITE(gsPointLocator_test)
+{
+    gsMultiPatch<> twoPatches()
+    {
+        gsMultiPatch<> mp;
+        mp.addPatch(gsNurbsCreator<>::BSplineFatQuarterAnnulus(1, 2));
+        mp.addPatch(gsNurbsCreator<>::BSplineSquare(1, 1, -1));
+        mp.uniformRefine(3);
+        return mp;
+    }
+
+    TEST(invertPoints)
+    {
+        gsMultiPatch<> mp = twoPatches();
+        gsPointLocator<> loc(mp);
+        CHECK_EQUAL(mp.basis(0).numElements() + mp.basis(1).numElements(),
+                    static_cast<size_t>(loc.numElements()));
+
+        // Points on both patches, and one outside
+        gsMatrix<> uv = gsPointGrid<>(mp.patch(0).support(), 7);
+        gsMatrix<> xy(2, 2 * uv.cols() + 1);
+        xy.leftCols (uv.cols()) = mp.patch(0).eval(uv);
+        xy.middleCols(uv.cols(), uv.cols()) = mp.patch(1).eval(uv);
+        xy.col(2 * uv.cols()) << -5, -5;
+
+        gsVector<index_t> pids;
+        gsMatrix<> preim;
+        loc.invertPoints(xy, pids, preim, 1e-8);
+        for (index_t i = 0; i != xy.cols() - 1; ++i)
+        {
+            CHECK(pids[i] >= 0);
+            CHECK( (mp.patch(pids[i]).eval(preim.col(i)) - xy.col(i)).norm() < 1e-6 );
+        }
+        CHECK_EQUAL(-1, pids[xy.cols() - 1]);
+    }
+
+    TEST(closestPoints)
+    {
+        gsMultiPatch<> mp;
+        mp.addPatch(gsNurbsCreator<>::BSplineQuarterAnnulus());
+        mp.embed(3);
+        mp.uniformRefine(2);
+        gsPointLocator<> loc(mp);
+
+        // Points above the surface
+        gsMatrix<> uv = gsPointGrid<>(mp.patch(0).support(), 5);
+        gsMatrix<> xyz = mp.patch(0).eval(uv);
+        xyz.row(2).setConstant(0.5);
+
+        gsVector<index_t> pids;
+        gsMatrix<> preim;
+        gsVector<> dist;
+        loc.closestPoints(xyz, pids, preim, dist, 1e-8);
+        for (index_t i = 0; i != xyz.cols(); ++i)
+        {
+            CHECK_EQUAL(0, pids[i]);
+            CHECK_CLOSE(0.5, dist[i], 1e-6);
+            CHECK( (preim.col(i) - uv.col(i)).norm() < 1e-6 );
+        }
+
+        // Moving the control points and refitting
+        mp.patch(0).coefs().col(2).array() += 1;
+        loc.refit();
+        CHECK_CLOSE(1, loc.boundingBox()(2,0), 1e-12);
+        loc.closestPoints(xyz, pids, preim, dist, 1e-8);
+        for (index_t i = 0; i != xyz.cols(); ++i)
+            CHECK_CLOSE(0.5, dist[i], 1e-6);
+    }
+}
@@ -87,6 +87,45 @@ void runPreconditionerTest( index_t testcase )
         solver.solve(rhs,sol);
         CHECK ( solver.error() <= solver.tolerance() );
     }
+    else if (testcase==4)
+    {
+        gsOptionList amgOpt = gsAlgebraicMultiGridOp<>::defaultOptions();
+        amgOpt.setInt("CoarseSize", 20);
+        gsAlgebraicMultiGridOp<>::uPtr amg = gsAlgebraicMultiGridOp<>::make(mat, amgOpt);
+        CHECK ( amg->numLevels() > 2 );
+        gsConjugateGradient<> solver(mat, give(amg));
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 25 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
+    else if (testcase==5)
+    {
+        // Two uncoupled components
+        const index_t n = mat.rows();
+        gsSparseEntries<> se;
+        for (index_t k = 0; k != n; ++k)
+            for (gsSparseMatrix<>::InnerIterator it(mat, k); it; ++it)
+            {
+                se.add(it.row(), it.col(), it.value());
+                se.add(n + it.row(), n + it.col(), 2 * it.value());
+            }
+        gsSparseMatrix<> mat2(2*n, 2*n);
+        mat2.setFrom(se);
+        gsMatrix<> rhs2(2*n, 1), sol2;
+        rhs2 << rhs, rhs;
+        sol2.setRandom(2*n, 1);
+
+        gsOptionList amgOpt = gsAlgebraicMultiGridOp<>::defaultOptions();
+        amgOpt.setInt("CoarseSize", 20);
+        amgOpt.setString("Smoother", "Jacobi");
+        gsConjugateGradient<> solver(mat2, gsAlgebraicMultiGridOp<>::make(
+                                         mat2, gsVector<index_t>::Constant(2, n), amgOpt));
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 40 );
+        solver.solve(rhs2,sol2);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
 }
 
 
@@ -109,6 +148,78 @@ SUITE(gsPreconditioner_test)
     {
         runPreconditionerTest(3);
     }
+    TEST(gsAlgebraicMultiGrid_test)
+    {
+        runPreconditionerTest(4);
+    }
+    TEST(gsAlgebraicMultiGridBlocks_test)
+    {
+        runPreconditionerTest(5);
+    }
+
+    TEST(gsMultiPatchSchwarz_test)
+    {
+        // 3 x 3 patches, the patch in the middle does not touch the
+        // Dirichlet boundary
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(3, 3, 1);
+        gsConstantFunction<> one(1,mp.geoDim());
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+            bc.addCondition( *bit, condition_type::dirichlet, &one );
+
+        gsOptionList opt = gsAssembler<>::defaultOptions();
+        gsMultiBasis<> mb(mp);
+        index_t iter[2];
+        for (index_t r = 0; r < 2; ++r)
+        {
+            mb.uniformRefine(2);
+            gsPoissonAssembler<> assembler(
+                mp, mb, bc, one,
+                (dirichlet::strategy) opt.getInt("DirichletStrategy"),
+                (iFace::strategy) opt.getInt("InterfaceStrategy")
+                );
+            assembler.assemble();
+            const gsSparseMatrix<> & mat = assembler.matrix();
+
+            gsMultiPatchPreconditionersCreator<> mpc(mb, bc, opt);
+            CHECK_EQUAL ( mat.rows(), mpc.dofMapper().freeSize() );
+            CHECK_EQUAL ( 9, (index_t)mpc.localTransfers().size() );
+
+            gsMatrix<> rhs = assembler.rhs(), sol;
+            sol.setZero(rhs.rows(), rhs.cols());
+            gsConjugateGradient<> solver(mat, mpc.additiveSchwarzOp(mat));
+            solver.setTolerance( 1.e-8 );
+            solver.setMaxIterations( 100 );
+            solver.solve(rhs,sol);
+            CHECK ( solver.error() <= solver.tolerance() );
+            iter[r] = solver.iterations();
+
+            if (r == 1)
+            {
+                // Two components, blocked
+                const index_t n = mat.rows();
+                gsSparseEntries<> se;
+                for (index_t k = 0; k != n; ++k)
+                    for (gsSparseMatrix<>::InnerIterator it(mat, k); it; ++it)
+                    {
+                        se.add(it.row(), it.col(), it.value());
+                        se.add(n + it.row(), n + it.col(), it.value());
+                    }
+                gsSparseMatrix<> mat2(2*n, 2*n);
+                mat2.setFrom(se);
+                gsMatrix<> rhs2(2*n, 1), sol2;
+                rhs2 << rhs, 2 * rhs;
+                sol2.setZero(2*n, 1);
+                gsConjugateGradient<> solver2(mat2, mpc.additiveSchwarzOp(mat2));
+                solver2.setTolerance( 1.e-8 );
+                solver2.setMaxIterations( 100 );
+                solver2.solve(rhs2,sol2);
+                CHECK ( solver2.error() <= solver2.tolerance() );
+            }
+        }
+        // Only mild growth under refinement
+        CHECK ( iter[1] <= iter[0] + 10 );
+    }
 
     TEST(gsPatchPreconditioner_stiff_test)
     {
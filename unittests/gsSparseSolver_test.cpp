@@ -0,0 +1,143 @@
+/** @file gsSparseSolver_test.cpp
+
+    @brief Tests for the mixed precision and the cached sparse solvers
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include "gismo_unittest.h"
+
+namespace
+{
+// Five point stencil of -Laplace(u) + c * du/dx on an N x N grid
+gsSparseMatrix<real_t> convectionDiffusion(const index_t N, const real_t c)
+{
+    const index_t n = N * N;
+    gsSparseMatrix<real_t> A(n, n);
+    A.reserve(gsVector<index_t>::Constant(n, 5));
+    for (index_t j = 0; j != N; ++j)
+        for (index_t i = 0; i != N; ++i)
+        {
+            const index_t k = j * N + i;
+            A.insert(k, k) = 4;
+            if (i > 0)     A.insert(k, k - 1) = -1 - c;
+            if (i + 1 < N) A.insert(k, k + 1) = -1 + c;
+            if (j > 0)     A.insert(k, k - N) = -1;
+            if (j + 1 < N) A.insert(k, k + N) = -1;
+        }
+    A.makeCompressed();
+    return A;
+}
+}
+
+SUITE(gsSparseSolver_test)
+{
+    TEST(MixedPrecisionLDLT)
+    {
+        const gsSparseMatrix<real_t> A = convectionDiffusion(30, 0);
+        const gsMatrix<real_t> x = gsMatrix<real_t>::Random(A.rows(), 2);
+        const gsMatrix<real_t> b = A * x;
+
+        gsSparseSolver<real_t>::uPtr solver = gsSparseSolver<real_t>::get("MixedSimplicialLDLT");
+        solver->compute(A);
+        const gsMatrix<real_t> y = solver->solve(b);
+        CHECK( solver->succeed() );
+        CHECK( (y - x).norm() / x.norm() < 1000 * std::numeric_limits<real_t>::epsilon() );
+
+        // the same pattern, another matrix
+        const gsSparseMatrix<real_t> B = 2 * A;
+        solver->analyzePattern(B);
+        solver->factorize(B);
+        CHECK( (solver->solve(b) - x / 2).norm() / x.norm() < 1000 * std::numeric_limits<real_t>::epsilon() );
+    }
+
+    TEST(MixedPrecisionLU)
+    {
+        const gsSparseMatrix<real_t> A = convectionDiffusion(30, 0.3);
+        const gsMatrix<real_t> x = gsMatrix<real_t>::Random(A.rows(), 1);
+        const gsMatrix<real_t> b = A * x;
+
+        gsMixedPrecisionSolver<real_t> solver("LU");
+        solver.compute(A);
+        const gsMatrix<real_t> y = solver.solve(b);
+        CHECK( solver.succeed() );
+        CHECK( solver.iterations() > 0 );
+        CHECK( (y - x).norm() / x.norm() < 1000 * std::numeric_limits<real_t>::epsilon() );
+    }
+
+    TEST(MixedPrecisionGMRES)
+    {
+        // The condition number (about 4e7) is beyond the reach of plain
+        // refinement with a float factorization
+        const index_t n = 10000;
+        gsSparseMatrix<real_t> A(n, n);
+        A.reserve(gsVector<index_t>::Constant(n, 3));
+        for (index_t i = 0; i != n; ++i)
+        {
+            if (i > 0)     A.insert(i, i - 1) = -1;
+            A.insert(i, i) = 2;
+            if (i + 1 < n) A.insert(i, i + 1) = -1;
+        }
+        A.makeCompressed();
+        const gsMatrix<real_t> b = gsMatrix<real_t>::Ones(n, 1);
+
+        gsMixedPrecisionSolver<real_t> solver("SimplicialLDLT");
+        solver.setKrylov(30);
+        solver.compute(A);
+        const gsMatrix<real_t> y = solver.solve(b);
+        CHECK( solver.succeed() );
+        CHECK( (b - A * y).norm() / b.norm() < 1e-8 );
+    }
+
+    TEST(CachedSolver)
+    {
+        gsSparseSolverCache<real_t> & cache = gsSparseSolverCache<real_t>::get();
+        cache.clear();
+
+        const gsSparseMatrix<real_t> A = convectionDiffusion(20, 0);
+        const gsMatrix<real_t> x = gsMatrix<real_t>::Random(A.rows(), 1);
+        const gsMatrix<real_t> b = A * x;
+
+        gsSparseSolver<real_t>::uPtr s1 = gsSparseSolver<real_t>::get("CachedSimplicialLDLT");
+        gsSparseSolver<real_t>::uPtr s2 = gsSparseSolver<real_t>::get("CachedSimplicialLDLT");
+        s1->compute(A);
+        s2->compute(A); // shares the factorization of s1
+        CHECK( s2->succeed() );
+        CHECK( (s2->solve(b) - x).norm() / x.norm() < 1e-10 );
+        CHECK_EQUAL( 1u, cache.misses() );
+        CHECK_EQUAL( 1u, cache.hits() );
+        CHECK_EQUAL( 1u, cache.size() );
+
+        // the same pattern, other values: while s1 still uses the
+        // entry, a new one is computed
+        const gsSparseMatrix<real_t> B = 2 * A;
+        s2->compute(B);
+        CHECK_EQUAL( 2u, cache.misses() );
+        CHECK( (s2->solve(b) - x / 2).norm() / x.norm() < 1e-10 );
+        CHECK( (s1->solve(b) - x).norm() / x.norm() < 1e-10 );
+
+        // s1 releases its entry, which is refactorized for 4 * A
+        const gsSparseMatrix<real_t> C = 4 * A;
+        s1->compute(C);
+        CHECK_EQUAL( 1u, cache.patternHits() );
+        CHECK_EQUAL( 2u, cache.size() );
+        CHECK( (s1->solve(b) - x / 4).norm() / x.norm() < 1e-10 );
+
+        // a budget below one entry keeps only the ones in use
+        const gsSparseMatrix<real_t> D = convectionDiffusion(10, 0);
+        s1->compute(D);
+        s2.reset();
+        cache.setMemoryBudget(cache.memory() / 4);
+        CHECK_EQUAL( 1u, cache.size() );
+        CHECK( (s1->solve(D * x.topRows(D.rows())) - x.topRows(D.rows())).norm() < 1e-10 );
+
+        cache.setMemoryBudget(size_t(256) << 20);
+        cache.clear();
+    }
+}
@@ -0,0 +1,105 @@
+/** @file gsTimeIntegrator_test.cpp
+
+    @brief Tests the time integration schemes of gsTimeIntegrator
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+ **/
+
+#include "gismo_unittest.h"
+#include <gsPde/gsTimeIntegrator.h>
+
+SUITE(gsTimeIntegrator_test)
+{
+    // Semi-discrete heat equation M u' + K u = f with lumped mass
+    struct heat1d
+    {
+        heat1d(index_t n) : M(n, n), K(n, n), f(n, 1), u0(n, 1)
+        {
+            const real_t h = 1.0 / (n + 1);
+            gsSparseEntries<> me, ke;
+            for (index_t i = 0; i != n; ++i)
+            {
+                me.add(i, i, h);
+                ke.add(i, i, 2 / h);
+                if (i > 0)     ke.add(i, i - 1, -1 / h);
+                if (i + 1 < n) ke.add(i, i + 1, -1 / h);
+                u0(i, 0) = math::sin(EIGEN_PI * (i + 1) * h);
+            }
+            M.setFrom(me);
+            K.setFrom(ke);
+            M.makeCompressed();
+            K.makeCompressed();
+            f.setConstant(h);
+        }
+
+        // Exact solution of the semi-discrete system at time t
+        gsMatrix<> exact(real_t t) const
+        {
+            // M is diagonal and constant: symmetric form via M^{-1}K
+            const real_t h = M.coeff(0, 0);
+            gsMatrix<> A = K.toDense() / h;
+            gsEigen::SelfAdjointEigenSolver<gsMatrix<>::Base> eig(A);
+            const gsMatrix<> w = A.ldlt().solve(f / h);
+            gsMatrix<> c = eig.eigenvectors().transpose() * (u0 - w);
+            c.array() *= (-t * eig.eigenvalues().array()).exp();
+            return w + eig.eigenvectors() * c;
+        }
+
+        gsSparseMatrix<> M, K;
+        gsMatrix<> f, u0;
+    };
+
+    real_t error(const heat1d & pb, index_t meth, index_t steps, index_t & nf)
+    {
+        gsTimeIntegrator<real_t> ti(pb.M, pb.K, pb.f);
+        ti.options().setInt("Method", meth);
+        ti.setInitialValue(pb.u0);
+        ti.setTimeStep(0.1 / steps);
+        ti.integrate(0.1);
+        CHECK_EQUAL(steps, ti.numSteps());
+        nf = ti.numFactorizations();
+        return (ti.solution() - pb.exact(0.1)).norm();
+    }
+
+    TEST(convergence)
+    {
+        const heat1d pb(40);
+        index_t nf;
+        for (index_t m = 0; m != 3; ++m)
+        {
+            const real_t e1 = error(pb, m, 20, nf);
+            // single factorization, BDF2 starts by implicit Euler
+            CHECK_EQUAL(1 == m ? 2 : 1, nf);
+            const real_t e2 = error(pb, m, 40, nf);
+            CHECK( e1 / e2 > 3.5 ); // second order
+        }
+    }
+
+    TEST(adaptive)
+    {
+        heat1d pb(40);
+        pb.f.setConstant(10.0 / 41); // large stationary part
+        const gsMatrix<> ex = pb.exact(1.0);
+        for (index_t m = 1; m != 3; ++m)
+        {
+            gsTimeIntegrator<real_t> ti(pb.M, pb.K, pb.f);
+            ti.options().setInt("Method", m);
+            ti.options().setSwitch("Adaptive", true);
+            ti.options().setReal("Tolerance", 1e-5);
+            ti.setInitialValue(pb.u0);
+            ti.setTimeStep(1e-3);
+            ti.integrate(1.0);
+            CHECK( math::abs(ti.time() - 1.0) < 1e-12 );
+            // the steps grow as the solution approaches the stationary state
+            CHECK( ti.timeStep() > 1e-2 );
+            CHECK( ti.numFactorizations() < ti.numSteps() );
+            CHECK( (ti.solution() - ex).norm() < 1e-3 * ex.norm() );
+        }
+    }
+}